@@ -40,11 +40,17 @@ void Circuit::calcLoadViol() {
   timingViolationLoad = 0;
   timingViolationLoadCellWise = 0;
 
+  const int numSlots = timingViolationSlots.size();
+  for (int i = 0; i < numSlots; i++) {
+    timingViolationSlots[i].load = 0;
+    timingViolationSlots[i].loadCellWise = 0;
+  }  // end for
+
   const int numArcs = timingNets.size();
   for (int k = timingOffsetToSequentialArcs;
        k < timingOffsetToExtraSequentialArcs; k++) {
     const TimingArc &arc = timingArcs[k];
-    TimingArcState &state = getTimingArcState(k);
+    TimingArcState state = getTimingArcState(k);
     state.loadViolation = computeLoadViolationUsingEffectiveCap(arc, state);
 
     timingViolationLoad += state.loadViolation;
@@ -57,7 +63,7 @@ void Circuit::calcLoadViol() {
 
   const int numNets = timingNets.size();
   for (int n = 0; n < numNets; n++) {
-    TimingNetState &netstate = getTimingNetState(n);
+    TimingNetState netstate = getTimingNetState(n);
     netstate.loadViolation = 0;
 
     const int k0 = timingArcPointers[n];
@@ -82,7 +88,9 @@ void Circuit::calcLoadViol() {
 // -----------------------------------------------------------------------------
 
 void Circuit::calcSlewViol() {
-  timingViolationSlewVector.assign(timingViolationSlewVector.size(), 0);
+  const int numSlots = timingViolationSlots.size();
+  for (int i = 0; i < numSlots; i++)
+    timingViolationSlots[i].slew = 0;
   timingViolationSlew = 0;
 
   const int numArcs = timingArcs.size();
@@ -93,7 +101,6 @@ void Circuit::calcSlewViol() {
     timingViolationSlew += computeSlewViolation(arcstate.islew[FALL], 1);
   }  // end for
 
-  timingViolationSlewVector[0] = timingViolationSlew;
   slewViol = timingViolationSlew;
 }  // end method
 
@@ -131,7 +138,6 @@ void Circuit::updateCellLoad(Vcell *cell) {
   const int l1 = timingTreeNodePointers[cell->sinkNetIndex + 1];
   for (int l = l0; l < l1; l++) {
     const TreeNodePointer &p = timingTreeNodes[l];
-    const RCTree::Node &node = tree.getNode(p.node);
 
     const TimingArc &arc = timingArcs[p.arc];
 
@@ -144,7 +150,7 @@ void Circuit::updateCellLoad(Vcell *cell) {
     }  // end else
   }    // end for
 
-  TimingNetState &netstate = getTimingNetState(n);
+  TimingNetState netstate = getTimingNetState(n);
   netstate.load = cell->wireLoad + pinLoad;
 
   cell->actualLoad = cell->wireLoad + pinLoad;
@@ -154,28 +160,35 @@ void Circuit::updateCellLoad(Vcell *cell) {
 // -----------------------------------------------------------------------------
 
 void Circuit::updateCellTiming(Vcell *cell) {
-  cell->cellTiming();
+  cell->cellTiming(netlist);
 }  // end method
 
 // -----------------------------------------------------------------------------
 
 void Circuit::updateCellType(Vcell *cell, int typeIndex) {
+  updateCellType(cell, typeIndex, loadViol, totalLeakage, totalArea);
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::updateCellType(Vcell *cell, const int typeIndex,
+                             double &loadViolation, double &leakage,
+                             double &area) {
   assert(!cell->dontTouch);
 
-  loadViol -= computeLoadViolationUsingDownstreamCap(cell);
-  totalLeakage -= cell->actualInstType->leakagePower;
-  totalArea -= cell->actualInstType->area;
+  loadViolation -= computeLoadViolationUsingDownstreamCap(cell);
+  leakage -= cell->actualInstType->leakagePower;
+  area -= cell->actualInstType->area;
 
   cell->actualInstTypeIndex = typeIndex;
   cell->actualInstType =
       &orgCells.oCells[cell->footprintIndex].cells[cell->actualInstTypeIndex];
-  cell->instType = cell->actualInstType->name;
 
-  updateLoads(cell);
+  updateLoads(cell, loadViolation);
 
-  loadViol += computeLoadViolationUsingDownstreamCap(cell);
-  totalLeakage += cell->actualInstType->leakagePower;
-  totalArea += cell->actualInstType->area;
+  loadViolation += computeLoadViolationUsingDownstreamCap(cell);
+  leakage += cell->actualInstType->leakagePower;
+  area += cell->actualInstType->area;
 }  // end method
 
 // -----------------------------------------------------------------------------
@@ -222,12 +235,50 @@ continue;
 
 bool Circuit::updateCellTypeLagrangeRelaxation(Vcell *cell,
                                                const double alpha) {
+  const int originalTypeIndex = cell->actualInstTypeIndex;
+
+  vector<int> &candidates = sizingThreadScratch[0].candidates;
+  candidates.clear();
+
+  const int numCandidateCells =
+      orgCells.oCells[cell->footprintIndex].cells.size();
+  for (int i = 0; i < numCandidateCells; i++)
+    if (i != originalTypeIndex) candidates.push_back(i);
+
+  const bool changed =
+      updateCellTypeLagrangeRelaxation(cell, candidates, alpha, 0, 0);
+
+  updateTiming_Violations();
+  updateSizing_Totals();
+
+  return changed;
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+bool Circuit::updateCellTypeLagrangeRelaxation(Vcell *cell,
+                                               const vector<int> &candidates,
+                                               const double alpha,
+                                               const int threadId,
+                                               const int slot) {
   const int n = cell->sinkNetIndex;
 
+  if (candidates.empty()) return false;
+
+  SizingTotalsSlot &totals = sizingTotalsSlots[slot];
+
+  // Candidates are timed into the overlay, so timingStateCurrent is only
+  // written when the best candidate is committed. Overlay violations are
+  // changes with respect to the current state.
+  TimingOverlay &overlay = timingOverlays[threadId];
+  openTimingOverlay(overlay, n);
+
+  const TimingViolationSlot &violation = overlay.violationCurrent;
+
   const double slackSlack = getSlackSlack(getWorstSlack());
 
-  const double originalLoadViolation = timingViolationLoad;
-  const double originalSlewViolation = timingViolationSlew;
+  const double originalLoadViolation = 0;
+  const double originalSlewViolation = 0;
   const int originalTypeIndex = cell->actualInstTypeIndex;
   const double originalSizingEffectOnLambdaDelay =
       computeSizingEffectOnLambdaDelay(n);
@@ -240,46 +291,269 @@ bool Circuit::updateCellTypeLagrangeRelaxation(Vcell *cell,
   int bestCell = originalTypeIndex;
   double bestCost = originalSizingEffectOnLambdaDelay + alpha * originalLeakage;
 
-  const int numCandidateCells =
-      orgCells.oCells[cell->footprintIndex].cells.size();
-  for (int i = 0; i < numCandidateCells; i++) {
-    if (i == originalTypeIndex) continue;
+  const int numCandidates = candidates.size();
+  for (int c = 0; c < numCandidates; c++) {
+    const int i = candidates[c];
 
-    updateCellType(cell, i);
+    updateCellType(cell, i, totals.loadViolation, totals.leakage,
+                   totals.area);
 
-    updateTimingLocally(n);
+    updateTimingLocally(n, overlay);
 
     // Do not accept slew violations.
-    /*if (timingViolationSlew > originalSlewViolation)
+    /*if (violation.slew > originalSlewViolation)
             continue;*/
     // Do not accept load violations.
-    if (timingViolationLoad > originalLoadViolation) continue;
+    if (violation.load > originalLoadViolation) continue;
 
     const double sizingEffectOnLocalNegativeSlack =
-        computeSizingEffectOnLocalNegativeSlack(n);
+        computeSizingEffectOnLocalNegativeSlack(n, &overlay);
     if ((sizingEffectOnLocalNegativeSlack <
          originalSizingEffectOnLocalNegativeSlack * slackSlack))
       continue;
 
     const double costLeakage = cell->getLeakagePower();
     const double costSizingEffectOnLambdaDelay =
-        computeSizingEffectOnLambdaDelay(n);
+        computeSizingEffectOnLambdaDelay(n, &overlay);
     const double cost = costSizingEffectOnLambdaDelay + alpha * costLeakage;
 
     if (cost < bestCost) {
       bestCell = i;
       bestCost = cost;
+      storeTimingOverlay(overlay);
     }  // end if
   }    // end for
 
-  updateCellType(cell, bestCell);
-  updateTimingLocally(n);
+  // Cell types and loads are not part of the overlay, so they are always set
+  // back to the best candidate.
+  updateCellType(cell, bestCell, totals.loadViolation, totals.leakage,
+                 totals.area);
+  if (bestCell != originalTypeIndex) commitTimingOverlay(overlay, slot);
 
   return (originalTypeIndex != bestCell);
 }  // end method
 
 // -----------------------------------------------------------------------------
 
+bool Circuit::updateCellTypeLagrangeRelaxationPruned(Vcell *cell,
+                                                     const double alpha,
+                                                     const int threadId,
+                                                     const int slot) {
+  const int originalTypeIndex = cell->actualInstTypeIndex;
+
+  SizingThreadScratch &scratch = sizingThreadScratch[threadId];
+
+  vector<int> &candidates = scratch.candidates;
+  candidates.clear();
+
+  if (!sizingPruneCandidates) {
+    const int numCandidateCells =
+        orgCells.oCells[cell->footprintIndex].cells.size();
+    for (int i = 0; i < numCandidateCells; i++)
+      if (i != originalTypeIndex) candidates.push_back(i);
+    return updateCellTypeLagrangeRelaxation(cell, candidates, alpha, threadId,
+                                            slot);
+  }  // end if
+
+  estimateCellTypeCandidatesLagrangeRelaxation(cell, alpha, scratch);
+  const vector<double> &costs = scratch.candidateCosts;
+
+  // Keep only candidates expected to improve the cost, best first.
+
+  const int numCandidateCells = costs.size();
+  for (int i = 0; i < numCandidateCells; i++)
+    if (i != originalTypeIndex && costs[i] < costs[originalTypeIndex])
+      candidates.push_back(i);
+
+  const int numCandidates = candidates.size();
+  const int numExactCandidates =
+      min(numCandidates, SIZING_NUM_EXACT_CANDIDATES);
+
+  for (int i = 0; i < numExactCandidates; i++) {
+    int best = i;
+    for (int k = i + 1; k < numCandidates; k++)
+      if (costs[candidates[k]] < costs[candidates[best]]) best = k;
+    swap(candidates[i], candidates[best]);
+  }  // end for
+  candidates.resize(numExactCandidates);
+
+  return updateCellTypeLagrangeRelaxation(cell, candidates, alpha, threadId,
+                                          slot);
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::estimateCellTypeCandidatesLagrangeRelaxation(
+    Vcell *cell, const double alpha, SizingThreadScratch &scratch) {
+  const int n = cell->sinkNetIndex;
+
+  const vector<LibParserCellInfo> &options =
+      orgCells.oCells[cell->footprintIndex].cells;
+  const LibParserCellInfo *current = cell->actualInstType;
+
+  const int numCandidates = options.size();
+
+  const ArcStateArrays &arcs = timingStateCurrent.arcs;
+  const NetStateArrays &nets = timingStateCurrent.nets;
+
+  // Cost deltas are accumulated candidate-major, i.e. the inner loops sweep
+  // all candidates for the same arc.
+  vector<double> &costs = scratch.candidateCosts;
+  costs.assign(numCandidates, computeSizingEffectOnLambdaDelay(n));
+  for (int c = 0; c < numCandidates; c++)
+    costs[c] += alpha * options[c].leakagePower;
+
+  // Slew change at the input pins of the cell, per arc and candidate.
+  const int k0 = timingArcPointers[n];
+  const int k1 = timingArcPointers[n + 1];
+  vector<EdgeArray<double> > &deltaInputSlew = scratch.deltaInputSlew;
+  vector<double> &deltaLoad = scratch.deltaLoad;
+  vector<EdgeArray<double> > &deltaSlew = scratch.deltaSlew;
+  deltaInputSlew.assign((k1 - k0) * numCandidates, EdgeArray<double>(0, 0));
+  deltaLoad.resize(numCandidates);
+  deltaSlew.resize(numCandidates);
+
+  for (int k = k0; k < k1; k++) {
+    const int d = timingArcs[k].driver;
+
+    // Skip driver nets already handled by a previous arc.
+    bool visited = false;
+    for (int j = k0; j < k && !visited; j++)
+      visited = timingArcs[j].driver == d;
+
+    if (!visited) {
+      // Load change seen by the driver net.
+      for (int c = 0; c < numCandidates; c++) deltaLoad[c] = 0;
+      for (int j = k; j < k1; j++) {
+        if (timingArcs[j].driver != d) continue;
+
+        // Do not count the same pin twice.
+        const int pin = timingArcs[j].pin;
+        bool counted = false;
+        for (int i = k; i < j && !counted; i++)
+          counted = timingArcs[i].driver == d && timingArcs[i].pin == pin;
+        if (counted) continue;
+
+        for (int c = 0; c < numCandidates; c++)
+          deltaLoad[c] +=
+              options[c].pins[pin].capacitance - current->pins[pin].capacitance;
+      }  // end for
+
+      const double load = nets.load[d];
+      const EdgeArray<int> &worstSlewArc = nets.backtrackSlew[d];
+
+      // Driver arcs of the driver net see a new effective capacitance.
+      for (int c = 0; c < numCandidates; c++) deltaSlew[c].set(0, 0);
+
+      const int j0 = timingArcPointers[d];
+      const int j1 = timingArcPointers[d + 1];
+      for (int j = j0; j < j1; j++) {
+        const TimingArc &arc = timingArcs[j];
+        const LibParserTimingInfo &timingInfo =
+            arc.cell->actualInstType->timingArcs[arc.lut];
+
+        const EdgeArray<double> &ceff = arcs.ceff[j];
+        const EdgeArray<double> &islew = arcs.islew[j];
+        const EdgeArray<double> shielding =
+            load > 0 ? ceff / load : EdgeArray<double>(1, 1);
+
+        for (int c = 0; c < numCandidates; c++) {
+          const EdgeArray<double> newCeff = ceff + shielding * deltaLoad[c];
+
+          EdgeArray<double> delay, oslew;
+          lookup(timingInfo, newCeff[RISE], newCeff[FALL], islew[RISE],
+                 islew[FALL], delay[RISE], delay[FALL], oslew[RISE],
+                 oslew[FALL]);
+
+          costs[c] += (arcs.lambda[j] * (delay - arcs.delay[j])).aggregate();
+
+          for (int edge = 0; edge < 2; edge++)
+            if (worstSlewArc[(EdgeType)edge] == j)
+              deltaSlew[c][(EdgeType)edge] =
+                  oslew[(EdgeType)edge] - arcs.oslew[j][(EdgeType)edge];
+        }  // end for
+      }    // end for
+
+      // The slew change reaches all sink arcs of the driver net.
+      const int q0 = timingSinkArcPointers[d];
+      const int q1 = timingSinkArcPointers[d + 1];
+      for (int q = q0; q < q1; q++) {
+        const int a = timingSinkArcs[q];
+        const TimingArc &arc = timingArcs[a];
+
+        if (arc.sink == n) {
+          for (int c = 0; c < numCandidates; c++)
+            deltaInputSlew[(a - k0) * numCandidates + c] = deltaSlew[c];
+        } else if (arc.sink != -1) {
+          // Side arc.
+          const LibParserTimingInfo &timingInfo =
+              arc.cell->actualInstType->timingArcs[arc.lut];
+          const EdgeArray<double> &ceff = arcs.ceff[a];
+
+          for (int c = 0; c < numCandidates; c++) {
+            const EdgeArray<double> islew = arcs.islew[a] + deltaSlew[c];
+            const EdgeArray<double> delay(
+                lookup(timingInfo.riseDelay, ceff[RISE], islew[FALL]),
+                lookup(timingInfo.fallDelay, ceff[FALL], islew[RISE]));
+
+            costs[c] += (arcs.lambda[a] * (delay - arcs.delay[a])).aggregate();
+          }  // end for
+        }    // end else-if
+      }      // end for
+    }        // end if
+  }          // end for
+
+  // Arcs of the cell itself use the candidate tables.
+  const EdgeArray<int> &worstSlewArc = nets.backtrackSlew[n];
+  vector<EdgeArray<double> > &deltaOutputSlew = scratch.deltaOutputSlew;
+  deltaOutputSlew.assign(numCandidates, EdgeArray<double>(0, 0));
+
+  for (int k = k0; k < k1; k++) {
+    const int lut = timingArcs[k].lut;
+    const EdgeArray<double> &ceff = arcs.ceff[k];
+
+    for (int c = 0; c < numCandidates; c++) {
+      const EdgeArray<double> islew =
+          arcs.islew[k] + deltaInputSlew[(k - k0) * numCandidates + c];
+
+      EdgeArray<double> delay, oslew;
+      lookup(options[c].timingArcs[lut], ceff[RISE], ceff[FALL], islew[RISE],
+             islew[FALL], delay[RISE], delay[FALL], oslew[RISE], oslew[FALL]);
+
+      costs[c] += (arcs.lambda[k] * (delay - arcs.delay[k])).aggregate();
+
+      for (int edge = 0; edge < 2; edge++)
+        if (worstSlewArc[(EdgeType)edge] == k)
+          deltaOutputSlew[c][(EdgeType)edge] =
+              oslew[(EdgeType)edge] - arcs.oslew[k][(EdgeType)edge];
+    }  // end for
+  }    // end for
+
+  // Sink arcs of the cell see the new output slew.
+  const int q0 = timingSinkArcPointers[n];
+  const int q1 = timingSinkArcPointers[n + 1];
+  for (int q = q0; q < q1; q++) {
+    const int a = timingSinkArcs[q];
+    const TimingArc &arc = timingArcs[a];
+    if (arc.sink == -1) continue;
+
+    const LibParserTimingInfo &timingInfo =
+        arc.cell->actualInstType->timingArcs[arc.lut];
+    const EdgeArray<double> &ceff = arcs.ceff[a];
+
+    for (int c = 0; c < numCandidates; c++) {
+      const EdgeArray<double> islew = arcs.islew[a] + deltaOutputSlew[c];
+      const EdgeArray<double> delay(
+          lookup(timingInfo.riseDelay, ceff[RISE], islew[FALL]),
+          lookup(timingInfo.fallDelay, ceff[FALL], islew[RISE]));
+
+      costs[c] += (arcs.lambda[a] * (delay - arcs.delay[a])).aggregate();
+    }  // end for
+  }    // end for
+}  // end method
+
+// -----------------------------------------------------------------------------
+
 bool Circuit::updateCellTypeLagrangeRelaxationLinearApproximation(
     Vcell *cell, const double alpha) {
   const int n = cell->sinkNetIndex;
@@ -943,18 +1217,21 @@ void Circuit::calcLoads() {
 }
 
 void Circuit::updateLoads(Vcell *changedCell) {
+  updateLoads(changedCell, loadViol);
+}
+
+void Circuit::updateLoads(Vcell *changedCell, double &loadViolation) {
   // calc cells output loads for a changed cell (wire + downstream + port
   // capacitance)
 
   Vcell *tmpCell;
-  string outputNet, inputPin;
 
   for (int a = 0; a < changedCell->previousCells.size(); ++a) {
     tmpCell = changedCell->previousCells[a];
 
-    loadViol -= computeLoadViolationUsingDownstreamCap(tmpCell);
+    loadViolation -= computeLoadViolationUsingDownstreamCap(tmpCell);
     updateCellLoad(tmpCell);
-    loadViol += computeLoadViolationUsingDownstreamCap(tmpCell);
+    loadViolation += computeLoadViolationUsingDownstreamCap(tmpCell);
   }
 }
 
@@ -1192,7 +1469,7 @@ void Circuit::simulatedAnnealing(const long double temp, bool critical) {
   // index: " << newIndex << endl);
 
   /*   Vcell * teste = *cellIterator;
-   cout << teste->instType << endl;
+   cout << teste->getTypeName() << endl;
    char nada;cin >> nada;
    ++cellIterator;
    */
@@ -1221,11 +1498,11 @@ void Circuit::simulatedAnnealing(const long double temp, bool critical) {
   // loadViol << "\t" << totalLeakage << "\t" << timingViol << " (" << minViol
   // << ")" << "\t" << slewViol << "\t" << worstSlack << endl);//"\t" <<
   // sdcInfos.clk_period*0.1*temp << endl; debug("tiago2", " cell: " <<
-  // chosenCell->instName << " changed from: " << chosenCell->instType);
+  // chosenCell->instName << " changed from: " << chosenCell->getTypeName());
 
   updateCellType(chosenCell, newIndex);
 
-  // if ( critical )debug("tiago2", " to: " << chosenCell->instType << endl);
+  // if ( critical )debug("tiago2", " to: " << chosenCell->getTypeName() << endl);
 
   updateTiming(chosenCell);
 
@@ -1410,7 +1687,7 @@ void Circuit::simulatedAnnealingTestedWithUFSC(const long double temp,
   // index: " << newIndex << endl);
 
   /*   Vcell * teste = *cellIterator;
-   cout << teste->instType << endl;
+   cout << teste->getTypeName() << endl;
    char nada;cin >> nada;
    ++cellIterator;
    */
@@ -1441,11 +1718,11 @@ void Circuit::simulatedAnnealingTestedWithUFSC(const long double temp,
   // " (" << this->minViol << ")" << "\t" << this->slewViol << "\t" <<
   // this->worstSlack << endl);//"\t" << sdcInfos.clk_period*0.1*temp << endl;
   // debug("tiago2", " cell: " << chosenCell->instName << " changed from: " <<
-  // chosenCell->instType);
+  // chosenCell->getTypeName());
 
   updateCellType(chosenCell, newIndex);
 
-  // if ( critical )debug("tiago2", " to: " << chosenCell->instType << endl);
+  // if ( critical )debug("tiago2", " to: " << chosenCell->getTypeName() << endl);
 
   updateTiming(chosenCell);
 
@@ -1642,9 +1919,13 @@ void Circuit::initialSolution(bool random) {
   for (i = 0; i < icells.size(); ++i) {
     tmpCell = icells[i];
 
+    // Cell type as read from the netlist.
+    const string instType =
+        netlist.cellTypeNames.getString(netlist.cellTypes[i]);
+
     for (j = 0; j < orgCells.oCells.size(); ++j)
       if (orgCells.oCells[j].footprint.compare(
-              0, orgCells.oCells[j].footprint.size(), tmpCell->instType, 0,
+              0, orgCells.oCells[j].footprint.size(), instType, 0,
               orgCells.oCells[j].footprint.size()) == 0) {
         if (random)
           aux =
@@ -1662,7 +1943,6 @@ void Circuit::initialSolution(bool random) {
     // tmpCell->clkPeriod = sdcInfos.clk_period;
     tmpCell->actualInstTypeIndex = aux;
     tmpCell->footprintIndex = j;
-    tmpCell->instType = tmp1Cell->name;
     tmpCell->actualInstType = tmp1Cell;
     tmpCell->dontTouch =
         ((tmp1Cell->isSequential) || (tmp1Cell->dontTouch)) ? true : false;
@@ -1673,7 +1953,7 @@ void Circuit::initialSolution(bool random) {
       ++notSizeable;
     }
     // updateCellType(tmpCell, 0);
-    // cout << " Cell name: " << tmpCell->instType << endl;
+    // cout << " Cell name: " << tmpCell->getTypeName() << endl;
     // cout << " Cell footprint: " << orgCells[j].footprint << "(" <<
     // tmpCell->dontTouch << ")" << endl;
   }
@@ -1687,24 +1967,20 @@ void Circuit::initialSolution(bool random) {
     ++countCells;
   }
 
-  map<string, Net>::iterator itn;
-  Net tmpNet;
-  set<Vcell *>::iterator itc;
   Vcell *aCell;
 
+  const int outputPin = netlist.pinNames.find("o");
   while (!qCircuit.empty()) {
     tmpCell = qCircuit.front();
     qCircuit.pop();
 
     // int endpointCounter = 0;
-    for (int a = tmpCell->pinNetPairs.size() - 1; a >= 0; --a)
-      if (tmpCell->pinNetPairs[a].first == "o") {
+    for (int a = tmpCell->numPins - 1; a >= 0; --a)
+      if (tmpCell->getPinNameId(netlist, a) == outputPin) {
         assert(tmpCell->nextCells.size() == 0);
-        tmpNet.netName = tmpCell->pinNetPairs[a].second;
-        itn = nets.find(tmpNet.netName);
-        tmpNet = itn->second;
-        for (itc = tmpNet.cells->begin(); itc != tmpNet.cells->end(); ++itc) {
-          aCell = *itc;
+        const int n = tmpCell->getPinNetId(netlist, a);
+        for (int k = netCellPointers[n]; k < netCellPointers[n + 1]; ++k) {
+          aCell = netCells[k];
           if ((aCell->instName != tmpCell->instName)) {
             tmpCell->nextCells.push_back(aCell);
             /*if ((aCell->dontTouch) || (aCell->portLoad != 0.0))
@@ -1721,7 +1997,7 @@ void Circuit::initialSolution(bool random) {
 if (endpointCounter > 1)
 cout << " multi endpoint fanout! " << endl;
 */
-        tmpCell->nextNum = tmpNet.numPins - 1;  // -1 discount the output pin
+        tmpCell->nextNum = netNumPins[n] - 1;  // -1 discount the output pin
 
         break;
       }
@@ -1856,7 +2132,10 @@ cout << " multi endpoint fanout! " << endl;
 #ifdef PARALLEL
   setupMultithreading();
 #else
-  timingViolationSlewVector.resize(1, 0);
+  timingViolationSlots.resize(1);
+  timingOverlays.resize(1);
+  sizingThreadScratch.resize(1);
+  sizingTotalsSlots.resize(1);
 #endif
 
   primeTimeConnectionEstablished = false;
@@ -1889,12 +2168,12 @@ cout << " multi endpoint fanout! " << endl;
 
     if (outputCounter == 0) {
       cerr << "[BUG] @ Circuit::initialSolution() - "
-           << "Cell " << cell->instType << " has no output pin.\n";
+           << "Cell " << cell->getTypeName() << " has no output pin.\n";
     }  // end if
 
     if (outputCounter > 1) {
       cerr << "[BUG] @ Circuit::initialSolution() - "
-           << "Cell " << cell->instType
+           << "Cell " << cell->getTypeName()
            << " has multiple output pins. [NOT SUPPORTED].\n";
     }  // end if
   }    // end for
@@ -1905,7 +2184,7 @@ cout << " multi endpoint fanout! " << endl;
     if (cell->actualInstType->isSequential &&
         (!cell->previousCells.size() > 1)) {
       cerr << "[BUG] @ Circuit::initialSolution() - "
-           << "Sequential cell " << cell->instType
+           << "Sequential cell " << cell->getTypeName()
            << " has multiple previous cells.\n";
     }  // end if
   }    // end for
@@ -1923,7 +2202,7 @@ vector<pair<string, string> > Circuit::copySizes() {
 
   for (int i = 0; i < icells.size(); ++i) {
     tmpCell = icells[i];
-    tmp.push_back(make_pair(tmpCell->instName, tmpCell->instType));
+    tmp.push_back(make_pair(tmpCell->instName, tmpCell->getTypeName()));
   }
 
   return tmp;
@@ -1943,7 +2222,7 @@ void Circuit::saveSizes() {
     for (int i = 0; i < icells.size(); ++i) {
       tmpCell = icells[i];
       fprintf(pfile, "%s %s\n", tmpCell->instName.c_str(),
-              tmpCell->instType.c_str());
+              tmpCell->getTypeName().c_str());
     }
     fclose(pfile);
     cout << " Saving sizes...done" << endl;
@@ -1966,7 +2245,7 @@ void Circuit::saveSolution(const string &name) {
 
   for (int i = offsetSequential; i < depthSortedCells.size(); i++) {
     Vcell *cell = depthSortedCells[i];
-    file << cell->instName << " " << cell->instType << "\n";
+    file << cell->instName << " " << cell->getTypeName() << "\n";
   }  // end for
   cout << "Done!\n";
 }  // end method
@@ -2222,11 +2501,12 @@ void Circuit::sortCells() {
   OrdCells new_fcell;
   orgCells.oCells.clear();
   cout << "Associating cells..." << endl;
+  // Library cells are moved, not copied, to their footprint group.
   for (int i = 0; i < lib_cells.size(); ++i) {
     found = false;
     for (int j = 0; j < orgCells.oCells.size(); ++j)
       if (lib_cells[i].footprint == orgCells.oCells[j].footprint) {
-        orgCells.oCells[j].cells.push_back(lib_cells[i]);
+        orgCells.oCells[j].cells.push_back(std::move(lib_cells[i]));
         found = true;
         break;
       }
@@ -2234,16 +2514,21 @@ void Circuit::sortCells() {
     if (!found) {
       new_fcell.footprint = lib_cells[i].footprint;
       new_fcell.cells.clear();
-      new_fcell.cells.push_back(lib_cells[i]);
-      orgCells.oCells.push_back(new_fcell);
+      new_fcell.cells.push_back(std::move(lib_cells[i]));
+      orgCells.oCells.push_back(std::move(new_fcell));
     }
   }
+  lib_cells.clear();
+
   for (int i = 0; i < orgCells.oCells.size(); ++i) {
     make_heap(orgCells.oCells[i].cells.begin(), orgCells.oCells[i].cells.end(),
               comp_cellLeakage());
     sort_heap(orgCells.oCells[i].cells.begin(), orgCells.oCells[i].cells.end(),
               comp_cellLeakage());
   }
+
+  // Cells no longer move from here on.
+  orgCells.buildLUTArena();
   cout << " Number of different cell footprints: " << orgCells.oCells.size()
        << endl;
   /*
@@ -2275,7 +2560,7 @@ void Circuit::readLib() {
     if (valid) {
       ++readCnt;
       // cout << cell << endl ;
-      lib_cells.push_back(cell);
+      lib_cells.push_back(std::move(cell));
       // cout << lib_cells.back() << endl ;
     }
 
@@ -2289,116 +2574,147 @@ void Circuit::readVerilog() {
   // read circuit verilog
   string filename = rootDir + "/" + benchName + "/" + benchName + ".v";
 
-  VerilogParser vp(filename);
+  vector<int> netCellIndexes;
+  const bool loaded =
+      snapshotReader.isOpen() && loadNetlistSnapshot(netCellIndexes);
+
+  if (loaded) {
+    cout << " Netlist loaded from snapshot '" << snapshotFile << "'." << endl;
+  } else if (verilogLegacyParser) {
+    readVerilogLegacy(filename);
+  } else {
+    VerilogFastParser vp(filename);
+    if (!vp.is_open()) {
+      cout << "[ERROR] Unable to map the verilog file '" << filename << "'.\n";
+      exit(1);
+    }  // end if
+    if (!vp.read_netlist(netlist)) {
+      cout << "[ERROR] Unable to read the verilog file '" << filename << "'.\n";
+      exit(1);
+    }  // end if
+  }  // end else
+
+  const int numPrimaryInputs = netlist.primaryInputs.size();
+  for (int i = 0; i < numPrimaryInputs; ++i)
+    inputs.push_back(netlist.netNames.getString(netlist.primaryInputs[i]));
 
-  string moduleName;
-  bool valid = vp.read_module(moduleName);
-  // cout << "Module " << moduleName << endl << endl ;
-  assert(valid);
-  Vcell *tmpCell;
   Wire tmp_wire;
+  tmp_wire.cap = 0.0;
+  const int numWires = netlist.wires.size();
+  for (int i = 0; i < numWires; ++i) {
+    tmp_wire.wire_name = netlist.netNames.getString(netlist.wires[i]);
+    wires.insert(tmp_wire);
+  }  // end for
+
+  // Instance ids are cell indexes (see findCell()).
+  const int numCells = netlist.getNumCells();
+  assert(netlist.instNames.size() == numCells);
+  icells.reserve(numCells);
+  cellPool.reserve(numCells);
+  for (int i = 0; i < numCells; ++i) {
+    const int begin = netlist.cellPinPointers[i];
+    const int end = netlist.cellPinPointers[i + 1];
+
+    Vcell *tmpCell = cellPool.create();
+    tmpCell->instName = netlist.instNames.getString(netlist.cellInsts[i]);
+    tmpCell->pinPointer = begin;
+    tmpCell->numPins = end - begin;
+    tmpCell->inputSlews.assign(end - begin, make_pair(0.0, 0.0));
+    tmpCell->delays.assign(end - begin, make_pair(0.0, 0.0));
+
+    tmpCell->vectorIndex = icells.size();
+    icells.push_back(tmpCell);
+  }  // end for
+
+  // Cells connected to each net. A cell connected to a net by several pins is
+  // listed once.
+  if (loaded) {
+    const int numNetCells = netCellIndexes.size();
+    netCells.resize(numNetCells);
+    for (int k = 0; k < numNetCells; ++k)
+      netCells[k] = icells[netCellIndexes[k]];
+  } else {
+    const int numNets = netlist.netNames.size();
+    vector<int> lastCell(numNets, -1);
+    netNumPins.assign(numNets, 0);
+    netCellPointers.assign(numNets + 1, 0);
+    for (int i = 0; i < numCells; ++i)
+      for (int k = netlist.cellPinPointers[i];
+           k < netlist.cellPinPointers[i + 1]; ++k) {
+        const int n = netlist.cellPinNets[k];
+        netNumPins[n]++;
+        if (lastCell[n] != i) {
+          lastCell[n] = i;
+          netCellPointers[n + 1]++;
+        }  // end if
+      }    // end for
+
+    for (int n = 0; n < numNets; ++n)
+      netCellPointers[n + 1] += netCellPointers[n];
+
+    vector<int> position(netCellPointers.begin(), netCellPointers.end() - 1);
+    lastCell.assign(numNets, -1);
+    netCells.resize(netCellPointers[numNets]);
+    for (int i = 0; i < numCells; ++i)
+      for (int k = netlist.cellPinPointers[i];
+           k < netlist.cellPinPointers[i + 1]; ++k) {
+        const int n = netlist.cellPinNets[k];
+        if (lastCell[n] != i) {
+          lastCell[n] = i;
+          netCells[position[n]++] = icells[i];
+        }  // end if
+      }    // end for
+  }  // end else
+
+  if (!snapshotWriter.empty()) saveNetlistSnapshot();
+
+  cout << " Cell instances read: " << icells.size() << endl;
+}
+
+void Circuit::readVerilogLegacy(const string &filename) {
+  VerilogParser vp(filename);
 
-  // cout << "Module " << moduleName << endl << endl ;
+  netlist.clear();
+  bool valid = vp.read_module(netlist.moduleName);
+  assert(valid);
 
   string primaryInput;
   do {
     valid = vp.read_primary_input(primaryInput);
-
-    if (valid) {
-      // cout << "Primary input: " << primaryInput << endl ;
-      inputs.push_back(primaryInput);
-    }
+    if (valid)
+      netlist.primaryInputs.push_back(netlist.netNames.insert(primaryInput));
   } while (valid);
 
-  // cout << endl ;
-
   string primaryOutput;
   do {
     valid = vp.read_primary_output(primaryOutput);
-
-    if (valid) {
-      // cout << "Primary output: " << primaryOutput << endl ;
-      // thisCircuit.outputs.push_back(primaryOutput);
-    }
-
+    if (valid)
+      netlist.primaryOutputs.push_back(netlist.netNames.insert(primaryOutput));
   } while (valid);
 
-  // cout << endl ;
-
   string net;
   do {
     valid = vp.read_wire(net);
-
-    if (valid) {
-      // cout << "Net: " << net << endl ;
-      tmp_wire.wire_name = net;
-      tmp_wire.cap = 0.0;
-      wires.insert(tmp_wire);
-    }
+    if (valid) netlist.wires.push_back(netlist.netNames.insert(net));
   } while (valid);
 
-  // cout << endl ;
-  // cout << "Cell insts: " << std::endl ;
-  map<string, Net>::iterator it;
-  // char nada;
-  AddrCell celladdr;
-
   string cellType, cellInst;
   vector<std::pair<string, string> > pinNetPairs;
-  set<string> nets;
   do {
     valid = vp.read_cell_inst(cellType, cellInst, pinNetPairs);
 
     if (valid) {
-      // cout << cellType << " " << cellInst << " " <<endl;
-      tmpCell = new Vcell;
-      tmpCell->instName = cellInst;
-      tmpCell->instType = cellType;
-      tmpCell->pinNetPairs.clear();
-      nets.clear();
-
+      netlist.cellTypes.push_back(netlist.cellTypeNames.insert(cellType));
+      netlist.cellInsts.push_back(netlist.instNames.insert(cellInst));
       for (int i = 0; i < pinNetPairs.size(); ++i) {
-        // cout << "(" << pinNetPairs[i].first << " " << pinNetPairs[i].second
-        // << ") " << endl;
-        tmpCell->pinNetPairs.push_back(pinNetPairs[i]);
-        tmpCell->inputSlews.push_back(make_pair(0.0, 0.0));
-        tmpCell->delays.push_back(make_pair(0.0, 0.0));
-        // tmpCell->arrivalTimes.push_back(make_pair(0.0,0.0));
-
-        Net tmpNet;
-        tmpNet.cells = new set<Vcell *>;
-        tmpNet.cells->clear();
-        tmpNet.netName = pinNetPairs[i].second;
-        it = this->nets.find(tmpNet.netName);
-        if (it != this->nets.end()) {
-          tmpNet.cells = it->second.cells;
-          tmpNet.cells->insert(tmpCell);
-          it->second.numPins++;
-          //	nets.erase(it);
-        } else {
-          tmpNet.cells->insert(tmpCell);
-          tmpNet.numPins = 1;
-          this->nets.insert(make_pair(tmpNet.netName, tmpNet));
-        }
-        // it = nets.begin();
-        // tmpNet = *it;
-        // cout<<thisCircuit.nets.size()<<" "<<tmpNet.netName<<endl;
-        // cin >> nada;
-      }
-      tmpCell->vectorIndex = icells.size();
-      icells.push_back(tmpCell);
-
-      /* needed if using PT
-       celladdr.vectorIndex = icells.size() - 1;
-       celladdr.instName = tmpCell->instName;
-       icells_addr.insert(celladdr);
-       /* */
-      // cout << " Cell: " << celladdr.instName << " is at index: " <<
-      // celladdr.vectorIndex << endl; cout << endl ;
-    }
-
+        netlist.cellPins.push_back(
+            netlist.pinNames.insert(pinNetPairs[i].first));
+        netlist.cellPinNets.push_back(
+            netlist.netNames.insert(pinNetPairs[i].second));
+      }  // end for
+      netlist.cellPinPointers.push_back(netlist.cellPins.size());
+    }  // end if
   } while (valid);
-  cout << " Cell instances read: " << icells.size() << endl;
 }
 
 void Circuit::readSDC() {
@@ -2427,7 +2743,6 @@ void Circuit::readSDC() {
 
   // create root
   graphRoot.instName = "root";
-  graphRoot.instType = "root";
 
   do {
     string portName;
@@ -2466,14 +2781,21 @@ void Circuit::readSDC() {
       inp_driver.fall = inputTransitionFall;
       sdcInfos.input_drivers.push_back(inp_driver);
 
-      tmpCell = new Vcell;
+      tmpCell = cellPool.create();
       tmpCell->instName = "inputDriver";
-      tmpCell->instType = driverSize;
 
       tmpCell->actualInstType = orgCells.findCellInst(driverSize);
-      tmpCell->pinNetPairs.push_back(
-          make_pair(tmpCell->actualInstType->pins[1].name, portName));
-      tmpCell->pinNetPairs.push_back(make_pair(driverPin, portName));
+
+      // The driver input and output pins are both connected to the port.
+      const int portNet = netlist.netNames.find(portName);
+      assert(portNet != -1);
+      tmpCell->pinPointer = netlist.cellPins.size();
+      tmpCell->numPins = 2;
+      netlist.cellPins.push_back(
+          netlist.pinNames.insert(tmpCell->actualInstType->pins[1].name));
+      netlist.cellPins.push_back(netlist.pinNames.insert(driverPin));
+      netlist.cellPinNets.push_back(portNet);
+      netlist.cellPinNets.push_back(portNet);
 
       tmpCell->inputSlews.push_back(
           make_pair(inputTransitionRise, inputTransitionFall));
@@ -2513,6 +2835,7 @@ void Circuit::readSDC() {
 
   set<Vcell *>::iterator it;
 
+  const int outputPin = netlist.pinNames.find("o");
   do {
     string portName;
     double load;
@@ -2526,13 +2849,13 @@ void Circuit::readSDC() {
       sdcInfos.output_loads.push_back(out_load);
 
       // save load in cell structure
-      for (int i = 0; i < icells.size(); ++i) {
+      const int portNet = netlist.netNames.find(portName);
+      const int numCells = icells.size();
+      for (int i = 0; i < numCells; ++i) {
         tmpCell = icells[i];
-        for (int k = tmpCell->pinNetPairs.size() - 1; k >= 0; --k)
-          if ((tmpCell->pinNetPairs[k].first == "o") &&
-              (tmpCell->pinNetPairs[k].second == portName)) {
-            // cout << tmpCell->instName << " " << tmpCell->pinNetPairs[k].first
-            // << " " << tmpCell->pinNetPairs[k].second << endl;
+        for (int k = tmpCell->numPins - 1; k >= 0; --k)
+          if (tmpCell->getPinNameId(netlist, k) == outputPin &&
+              tmpCell->getPinNetId(netlist, k) == portNet) {
             tmpCell->portLoad = load;
             outputs.push_back(make_pair(portName, tmpCell));
             //	cout << thisCircuit.icells[j]->outputLoad << endl;
@@ -2549,184 +2872,979 @@ void Circuit::readSDC() {
 
   // Increment nextNum of outputs nets.
   for (int i = 0; i < outputs.size(); i++) {
-    map<string, Net>::iterator it = nets.find(outputs[i].first);
-    assert(it != nets.end());
-    it->second.numPins++;
+    const int n = netlist.netNames.find(outputs[i].first);
+    assert(n != -1);
+    netNumPins[n]++;
   }  // end for
 
   // printTree(&graphRoot);
 }
 
-void Circuit::readSPEF() {
-  // read .spef file
-  string filename = rootDir + "/" + benchName + "/" + benchName + ".spef";
+void Circuit::buildTreeDescriptor(const SpefNet &spefNet,
+                                  RCTreeDescriptor &dscp,
+                                  vector<int> &terminals, int &driver) {
+  const int numCapacitors = spefNet.capacitances.size();
+  for (int i = 0; i < numCapacitors; ++i) {
+    const SpefCapacitance &cap = spefNet.capacitances[i];
+    dscp.addCapacitor(cap.nodeName, cap.capacitance * 1e-15);
+  }  // end for
 
-  ///////NEW /////////////////////////////////////////////////////////////////
-  SpefParser sp(filename);
+  const int numResistors = spefNet.resistances.size();
+  for (int i = 0; i < numResistors; ++i) {
+    const SpefResistance &res = spefNet.resistances[i];
+    dscp.addResistor(res.fromNodeName, res.toNodeName, res.resistance * 1e3);
+  }  // end for
 
-  SpefNet spefNet;
-  bool valid = sp.read_net_data(spefNet);
+  terminals.clear();
+  driver = -1;
+  const int numConnections = spefNet.connections.size();
+  for (int i = 0; i < numConnections; ++i) {
+    const SpefConnection &conn = spefNet.connections[i];
+    const int nodeIndex = dscp.findNode(conn.nodeName);
+    if (nodeIndex == -1) continue;
 
-  Wire twire, twire2;
-  set<Wire>::iterator itw;
-  cout << " Number of wire nets: " << wires.size() << endl;
+    terminals.push_back(nodeIndex);
 
-  timingTreeDescriptors.clear();
-  timingTreeDescriptors.reserve(nets.size());
+    // Driver: input port or cell output pin.
+    if ((conn.nodeType == 'P' && conn.direction == 'I') ||
+        (conn.nodeType == 'I' && conn.direction == 'O'))
+      driver = nodeIndex;
+  }  // end for
+}  // end method
 
-  int countWires = 0;
-  int readCnt = 0;
-  while (valid) {
-    timingTreeDescriptors.resize(timingTreeDescriptors.size() + 1);
+// -----------------------------------------------------------------------------
 
-    RCTreeDescriptor &dscp = timingTreeDescriptors.back();
+void Circuit::buildTreeDescriptor(const SpefFlatNet &spefNet,
+                                  RCTreeDescriptor &dscp,
+                                  vector<int> &terminals, int &driver) {
+  const int numNodes = spefNet.nodeNames.size();
+  const int numCapacitors = spefNet.capacitances.size();
+  const int numResistors = spefNet.resistances.size();
 
-    double totalCap = 0;
+  dscp.reserve(numNodes, numResistors, numCapacitors);
 
-    for (int i = 0; i < spefNet.capacitances.size(); ++i) {
-      const SpefCapacitance &cap = spefNet.capacitances[i];
-      dscp.addCapacitor(cap.nodeName, cap.capacitance * 1e-15);
+  for (int i = 0; i < numNodes; ++i) dscp.addNode(spefNet.nodeNames[i]);
 
-      totalCap += cap.capacitance;
-    }  // end for
+  for (int i = 0; i < numCapacitors; ++i)
+    dscp.addCapacitor(spefNet.capacitanceNodes[i],
+                      spefNet.capacitances[i] * 1e-15);
 
-    for (int i = 0; i < spefNet.resistances.size(); ++i) {
-      const SpefResistance &res = spefNet.resistances[i];
-      dscp.addResistor(res.fromNodeName, res.toNodeName, res.resistance * 1e3);
-    }  // end for
+  for (int i = 0; i < numResistors; ++i)
+    dscp.addResistor(spefNet.resistanceNodes0[i], spefNet.resistanceNodes1[i],
+                     spefNet.resistances[i] * 1e3);
 
-    if (!nearlyEqual(spefNet.netLumpedCap, totalCap, 1e-3))
-      cout << "[WARNING] Total Cap != Lumped Cap (Net: " << spefNet.netName
-           << ") ==> " << totalCap << " != " << spefNet.netLumpedCap << "\n";
+  terminals.clear();
+  driver = -1;
+  const int numConnections = spefNet.connectionNodes.size();
+  for (int i = 0; i < numConnections; ++i) {
+    const int nodeIndex = spefNet.connectionNodes[i];
+    if (nodeIndex == -1) continue;
 
-    // [TODO] Hard-coded default cap.
-    dscp.applyDefaultCap(1e-15);
+    terminals.push_back(nodeIndex);
 
-    // assert( nearlyEqual( tree.getLumpedCap(),  spefNet.netLumpedCap, 1e-3 )
-    // );
+    // Driver: input port or cell output pin.
+    const char type = spefNet.connectionTypes[i];
+    const char direction = spefNet.connectionDirections[i];
+    if ((type == 'P' && direction == 'I') || (type == 'I' && direction == 'O'))
+      driver = nodeIndex;
+  }  // end for
+}  // end method
 
-    ++readCnt;
+// -----------------------------------------------------------------------------
 
-    /*
-    // print out the contents of the spefNet just read
-    cout << "Net: " << spefNet.netName << endl ;
-    cout << "Net lumped cap: " << spefNet.netLumpedCap << endl ;
+void Circuit::finishTreeDescriptor(
+    RCTreeDescriptor &dscp, const vector<int> &terminals, const int driver,
+    RCTreeDescriptor::ReductionStats &stats) const {
+  // [TODO] Hard-coded default cap.
+  dscp.applyDefaultCap(1e-15);
 
-    cout << "Connections: " << endl ;
-    for (int i=0; i < spefNet.connections.size(); ++i) {
-            cout << spefNet.connections[i] << endl ;
-    }
+  if (timingRCTreeReductionTolerance > 0) {
+    const int numTerminals = terminals.size();
+    for (int i = 0; i < numTerminals; ++i)
+      dscp.setNodeTerminal(terminals[i]);
 
-    cout << "Capacitances: " << endl ;
-    for (int i=0; i < spefNet.capacitances.size(); ++i) {
-            cout << spefNet.capacitances[i] << endl ;
-    }
+    dscp.reduce(driver != -1 ? dscp.getNode(driver).propName : "",
+                timingRCTreeReductionTolerance, stats);
+  }  // end if
+}  // end method
 
-    cout << "Resistances: " << endl ;
-    for (int i=0; i < spefNet.resistances.size(); ++i) {
-            cout << spefNet.resistances[i] << endl ;
-    }
-    */
+// -----------------------------------------------------------------------------
 
-    twire.wire_name = spefNet.netName;
+void Circuit::addSPEFWire(const string &netName, const double netLumpedCap,
+                          const double totalCap, int &countWires) {
+  if (!nearlyEqual(netLumpedCap, totalCap, 1e-3))
+    cout << "[WARNING] Total Cap != Lumped Cap (Net: " << netName << ") ==> "
+         << totalCap << " != " << netLumpedCap << "\n";
 
-    itw = wires.find(twire);
-    twire2 = *itw;
-    if (spefNet.netName == twire2.wire_name) {
-      twire.cap = spefNet.netLumpedCap;
-      wires.erase(itw);
-      wires.insert(twire);
-      ++countWires;
-    }
+  Wire twire;
+  twire.wire_name = netName;
 
-    valid = sp.read_net_data(spefNet);
-  }
+  set<Wire>::iterator itw = wires.find(twire);
+  if (itw != wires.end()) {
+    twire.cap = netLumpedCap;
+    wires.erase(itw);
+    wires.insert(twire);
+    ++countWires;
+  }  // end if
+}  // end method
 
-  cout << "Read " << readCnt << " nets in the spef file." << endl;
-  cout << " Wire capacitances read: " << countWires << " (" << readCnt << ")"
-       << endl;
-  // copy loads to cells
-  set<Vcell *>::iterator it;
-  Vcell *tmpCell;
+// -----------------------------------------------------------------------------
 
-  for (int i = 0; i < icells.size(); ++i) {
-    tmpCell = icells[i];
-    for (int k = 0; k < tmpCell->pinNetPairs.size(); ++k)
-      if (tmpCell->pinNetPairs[k].first == "o") {
-        twire.wire_name = tmpCell->pinNetPairs[k].second;
-        twire.cap = 0.0;
-        itw = wires.find(twire);
-        twire2 = *itw;
-        tmpCell->wireLoad = twire2.cap;
-        // cout << tmpCell->wireLoad << endl;
-        break;
-      }
-  }
-  for (int i = 0; i < graphRoot.nextCells.size(); ++i) {
-    tmpCell = graphRoot.nextCells[i];
-    for (int k = 0; k < tmpCell->pinNetPairs.size(); ++k)
-      if (tmpCell->pinNetPairs[k].first == "o") {
-        twire.wire_name = tmpCell->pinNetPairs[k].second;
-        twire.cap = 0.0;
-        itw = wires.find(twire);
-        twire2 = *itw;
-        tmpCell->wireLoad = twire2.cap;
-        // cout << tmpCell->wireLoad << endl;
-        break;
-      }
-  }
-  ///////NEW
-  /// END/////////////////////////////////////////////////////////////////
-  /*
-      SpefParser sp(filename);
+// Net sections are independent. The file is scanned for them in parallel,
+// one byte range per thread, and then each thread parses its nets straight
+// into timingTreeDescriptors.
+void Circuit::readSPEFSections(const string &filename,
+                               vector<SpefNetInfo> &infos) {
+  SpefFastParser file(filename);
+  if (!file.is_open()) {
+    cout << "[ERROR] Unable to map the spef file '" << filename << "'.\n";
+    return;
+  }  // end if
 
-      string net;
-      double cap;
-      bool valid = sp.read_net_cap(net, cap);
-      int countWires = 0;
-      Wire twire, twire2;
-      set<Wire>::iterator itw;
-      int i = 0;
+#ifdef PARALLEL
+  ThreadPool pool;
+  pool.resize(max(1, (int)std::thread::hardware_concurrency()));
+  const int numThreads = pool.getNumThreads();
+#else
+  const int numThreads = 1;
+#endif
 
-      cout << " Number of wire nets: " << wires.size() << endl;
-      while (valid) {
-              //cout << "Lumped cap of net " << net << " is " << cap << endl ;
-              ++i;
-              twire.wire_name = net;
+  // Find the net sections.
+  const char *data = file.data_begin();
+  const long long size = file.data_end() - data;
 
-              itw = wires.find(twire);
-              twire2 = *itw;
-              //for (int i = 0; i < thisCircuit.wires.size(); ++i)
-              //	if (net == thisCircuit.wires[i].wire_name)
-              if (net == twire2.wire_name) {
-                      //thisCircuit.wires[i].cap = cap;
-                      twire.cap = cap;
-                      wires.erase(itw);
-                      wires.insert(twire);
-                      //it->cap = cap;
-                      ++countWires;
-              }
-              valid = sp.read_net_cap(net, cap);
-      }
-      cout << " Wire capacitances read: " << countWires << " (" << i << ")" <<
-     endl;
-      //copy loads to cells
-      set<Vcell*>::iterator it;
-      Vcell* tmpCell;
+  vector<vector<const char *> > rangeSections(numThreads);
+  vector<int> ranges(numThreads + 1);
+  for (int i = 0; i <= numThreads; i++) ranges[i] = i;
 
-      for (int i = 0; i < icells.size(); ++i) {
-              tmpCell = icells[i];
-              for (int k = 0; k < tmpCell->pinNetPairs.size(); ++k)
-                      if (tmpCell->pinNetPairs[k].first == "o") {
-                              twire.wire_name = tmpCell->pinNetPairs[k].second;
-                              twire.cap = 0.0;
-                              itw = wires.find(twire);
-                              twire2 = *itw;
-                              tmpCell->wireLoad = twire2.cap;
-                              //cout << tmpCell->wireLoad << endl;
-                              break;
-                      }
-      }
+  const auto scan = [&](const int /*threadId*/, const int r0, const int r1) {
+    for (int r = r0; r < r1; r++)
+      file.find_net_sections(data + (size * r) / numThreads,
+                             data + (size * (r + 1)) / numThreads,
+                             rangeSections[r]);
+  };
+
+#ifdef PARALLEL
+  pool.parallelFor(ranges, scan);
+#else
+  scan(0, 0, numThreads);
+#endif
+
+  vector<const char *> sections;
+  for (int r = 0; r < numThreads; r++)
+    sections.insert(sections.end(), rangeSections[r].begin(),
+                    rangeSections[r].end());
+
+  const int numNets = sections.size();
+
+  // Parse.
+  timingTreeDescriptors.clear();
+  timingTreeDescriptors.resize(numNets);
+  infos.resize(numNets);
+
+  vector<SpefFlatNet> threadNets(numThreads);
+  vector<vector<int> > threadTerminals(numThreads);
+  vector<RCTreeDescriptor::ReductionStats> threadStats(numThreads);
+
+  const auto parse = [&](const int threadId, const int n0, const int n1) {
+    SpefFastParser sp(data, file.data_end());
+    SpefFlatNet &spefNet = threadNets[threadId];
+    vector<int> &terminals = threadTerminals[threadId];
+    int driver;
+
+    for (int n = n0; n < n1; n++) {
+      sp.seek(sections[n]);
+      sp.read_net_data(spefNet);
+
+      RCTreeDescriptor &dscp = timingTreeDescriptors[n];
+      buildTreeDescriptor(spefNet, dscp, terminals, driver);
+
+      SpefNetInfo &info = infos[n];
+      info.name = spefNet.netName;
+      info.lumpedCap = spefNet.netLumpedCap;
+      info.totalCap = dscp.getTotalTreeCapacitance() * 1e15;  // fF
+
+      finishTreeDescriptor(dscp, terminals, driver, threadStats[threadId]);
+    }  // end for
+  };
+
+#ifdef PARALLEL
+  // Small chunks so that threads can balance nets of very different sizes.
+  const int numChunks = min(numNets, 16 * numThreads);
+  vector<int> chunks(numChunks + 1);
+  for (int i = 0; i <= numChunks; i++)
+    chunks[i] = (int)(((long long)i * numNets) / numChunks);
+  pool.parallelFor(chunks, parse);
+#else
+  parse(0, 0, numNets);
+#endif
+
+  for (int i = 0; i < numThreads; i++)
+    timingRCTreeReductionStats.add(threadStats[i]);
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+// Design snapshot. The payload starts with a DesignSnapshotHeader followed by
+// one section per stage of the flow, in the order they run:
+//   netlist      readVerilog()           flat netlist and net to cell table
+//   RC trees     readSPEF()              RC tree descriptors and net caps
+//   timing graph buildTimingStructure()  timing nets, arcs and their CSRs
+// Library and SDC are always parsed, since cells, input drivers and the
+// initial solution are built from them.
+struct DesignSnapshotHeader {
+  long long fileSizes[4];  // library, verilog, SDC and SPEF
+  unsigned long long fileChecksums[4];
+  double reductionTolerance;
+};
+
+// Layout of the RC tree section. Node, resistor and capacitor arrays are
+// concatenated over all nets and node indexes are local to the net.
+//   int64   numNets, numNodes, numResistors, numCapacitors
+//   int64   numNetNameChars, numNodeNameChars
+//   double  net lumped caps, total caps, total tree caps     [numNets]
+//   int64   net node, resistor and capacitor pointers        [numNets + 1]
+//   int64   net name pointers                                [numNets + 1]
+//   double  node caps                                        [numNodes]
+//   int64   node name pointers                               [numNodes + 1]
+//   int32   resistor nodes (pairs)                           [2 * numResistors]
+//   double  resistances                                      [numResistors]
+//   int32   capacitor nodes                                  [numCapacitors]
+//   double  capacitances                                     [numCapacitors]
+//   char    net names, node names
+struct RCTreeSnapshotHeader {
+  long long numNets;
+  long long numNodes;
+  long long numResistors;
+  long long numCapacitors;
+  long long numNetNameChars;
+  long long numNodeNameChars;
+};
+
+static const char *const DESIGN_SNAPSHOT_MAGIC = "USZDSGN";
+static const int DESIGN_SNAPSHOT_VERSION = 1;
+
+// -----------------------------------------------------------------------------
+
+// Opens the snapshot for loading if it matches the input files, otherwise
+// starts a new one to be saved once the timing graph is built.
+void Circuit::openSnapshot() {
+  snapshotReader.close();
+  snapshotWriter.clear();
+
+  if (snapshotFile.empty()) return;
+
+  const string bench = rootDir + "/" + benchName + "/" + benchName;
+  const string files[4] = {rootDir + "/lib/contest.lib", bench + ".v",
+                           bench + ".sdc", bench + ".spef"};
+
+  DesignSnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  for (int i = 0; i < 4; i++) {
+    if (!Snapshot::getFileChecksum(files[i], header.fileSizes[i],
+                                   header.fileChecksums[i]))
+      return;
+  }  // end for
+  header.reductionTolerance = timingRCTreeReductionTolerance;
+
+  if (snapshotReader.open(snapshotFile, DESIGN_SNAPSHOT_MAGIC,
+                          DESIGN_SNAPSHOT_VERSION)) {
+    DesignSnapshotHeader stored;
+    if (snapshotReader.read(stored) &&
+        memcmp(&stored, &header, sizeof(header)) == 0) {
+      cout << "Loading design from snapshot '" << snapshotFile << "'." << endl
+           << endl;
+      return;
+    }  // end if
+
+    snapshotReader.close();
+    cout << "Snapshot '" << snapshotFile << "' is out of date." << endl
+         << endl;
+  }  // end if
+
+  snapshotWriter.write(header);
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::saveSnapshot() {
+  if (snapshotWriter.save(snapshotFile, DESIGN_SNAPSHOT_MAGIC,
+                          DESIGN_SNAPSHOT_VERSION))
+    cout << " Design saved to snapshot '" << snapshotFile << "'." << endl;
+  else
+    cout << "[WARNING] Unable to write the snapshot '" << snapshotFile
+         << "'.\n";
+
+  snapshotWriter.clear();
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+// Net cells are stored as cell indexes.
+void Circuit::saveNetlistSnapshot() {
+  SnapshotWriter &writer = snapshotWriter;
+
+  writer.writeString(netlist.moduleName);
+  netlist.netNames.save(writer);
+  netlist.pinNames.save(writer);
+  netlist.cellTypeNames.save(writer);
+  netlist.instNames.save(writer);
+  writer.writeVector(netlist.primaryInputs);
+  writer.writeVector(netlist.primaryOutputs);
+  writer.writeVector(netlist.wires);
+  writer.writeVector(netlist.cellTypes);
+  writer.writeVector(netlist.cellInsts);
+  writer.writeVector(netlist.cellPinPointers);
+  writer.writeVector(netlist.cellPins);
+  writer.writeVector(netlist.cellPinNets);
+
+  const int numNetCells = netCells.size();
+  vector<int> netCellIndexes(numNetCells);
+  for (int k = 0; k < numNetCells; k++)
+    netCellIndexes[k] = netCells[k]->vectorIndex;
+
+  writer.writeVector(netCellPointers);
+  writer.writeVector(netCellIndexes);
+  writer.writeVector(netNumPins);
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+// Net cells are returned as cell indexes, since cells are created afterwards.
+bool Circuit::loadNetlistSnapshot(vector<int> &netCellIndexes) {
+  SnapshotReader &reader = snapshotReader;
+
+  VerilogFlatNetlist loaded;
+  vector<int> pointers;
+  vector<int> cells;
+  vector<int> numPins;
+
+  bool valid = reader.readString(loaded.moduleName) &&
+               loaded.netNames.load(reader) && loaded.pinNames.load(reader) &&
+               loaded.cellTypeNames.load(reader) &&
+               loaded.instNames.load(reader) &&
+               reader.readVector(loaded.primaryInputs) &&
+               reader.readVector(loaded.primaryOutputs) &&
+               reader.readVector(loaded.wires) &&
+               reader.readVector(loaded.cellTypes) &&
+               reader.readVector(loaded.cellInsts) &&
+               reader.readVector(loaded.cellPinPointers) &&
+               reader.readVector(loaded.cellPins) &&
+               reader.readVector(loaded.cellPinNets) &&
+               reader.readVector(pointers) && reader.readVector(cells) &&
+               reader.readVector(numPins);
+
+  // Pointers must split the arrays they index and ids must be in range.
+  const auto isInRange = [](const vector<int> &v, const int lower,
+                            const int upper) {
+    const int n = v.size();
+    for (int i = 0; i < n; i++)
+      if (v[i] < lower || v[i] > upper) return false;
+    return true;
+  };
+  const auto isPartition = [](const vector<int> &pointers, const int n,
+                              const int size) {
+    if ((int)pointers.size() != n + 1 || pointers[0] != 0 ||
+        pointers[n] != size)
+      return false;
+    for (int i = 0; i < n; i++)
+      if (pointers[i] > pointers[i + 1]) return false;
+    return true;
+  };
+
+  const int numCells = loaded.getNumCells();
+  const int numNets = loaded.netNames.size();
+  const int numCellPins = loaded.cellPins.size();
+  const int numNetCells = cells.size();
+  valid = valid && (int)loaded.cellInsts.size() == numCells &&
+          loaded.instNames.size() == numCells &&
+          (int)loaded.cellPinNets.size() == numCellPins &&
+          (int)numPins.size() == numNets &&
+          isPartition(loaded.cellPinPointers, numCells, numCellPins) &&
+          isPartition(pointers, numNets, numNetCells) &&
+          isInRange(loaded.cellTypes, 0, loaded.cellTypeNames.size() - 1) &&
+          isInRange(loaded.cellInsts, 0, loaded.instNames.size() - 1) &&
+          isInRange(loaded.cellPins, 0, loaded.pinNames.size() - 1) &&
+          isInRange(loaded.cellPinNets, 0, numNets - 1) &&
+          isInRange(loaded.primaryInputs, 0, numNets - 1) &&
+          isInRange(loaded.primaryOutputs, 0, numNets - 1) &&
+          isInRange(loaded.wires, 0, numNets - 1) &&
+          isInRange(cells, 0, numCells - 1) &&
+          isInRange(numPins, 0, numCellPins);
+
+  if (!valid) {
+    cout << "[WARNING] Snapshot '" << snapshotFile << "' is malformed.\n";
+    snapshotReader.close();
+    return false;
+  }  // end if
+
+  swap(netlist, loaded);
+  netCellPointers.swap(pointers);
+  netNumPins.swap(numPins);
+  netCellIndexes.swap(cells);
+  return true;
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::saveRCTreeSnapshot(const vector<SpefNetInfo> &infos) {
+  const int numNets = timingTreeDescriptors.size();
+
+  RCTreeSnapshotHeader header;
+  header.numNets = numNets;
+
+  vector<double> lumpedCaps(numNets);
+  vector<double> totalCaps(numNets);
+  vector<double> totalTreeCaps(numNets);
+  vector<long long> nodePointers(1, 0);
+  vector<long long> resistorPointers(1, 0);
+  vector<long long> capacitorPointers(1, 0);
+  vector<long long> netNamePointers(1, 0);
+  vector<double> nodeCaps;
+  vector<long long> nodeNamePointers(1, 0);
+  vector<int> resistorNodes;
+  vector<double> resistances;
+  vector<int> capacitorNodes;
+  vector<double> capacitances;
+  string netNames;
+  string nodeNames;
+
+  for (int i = 0; i < numNets; i++) {
+    const RCTreeDescriptor &dscp = timingTreeDescriptors[i];
+
+    lumpedCaps[i] = infos[i].lumpedCap;
+    totalCaps[i] = infos[i].totalCap;
+    totalTreeCaps[i] = dscp.getTotalTreeCapacitance();
+
+    netNames += infos[i].name;
+    netNamePointers.push_back(netNames.size());
+
+    for (int k = 0; k < dscp.getNumNodes(); k++) {
+      const RCTreeDescriptor::Node &node = dscp.getNode(k);
+      nodeCaps.push_back(node.totalCap);
+      nodeNames += node.propName;
+      nodeNamePointers.push_back(nodeNames.size());
+    }  // end for
+
+    for (int k = 0; k < dscp.getNumResistors(); k++) {
+      const RCTreeDescriptor::Resistor &r = dscp.getResistor(k);
+      resistorNodes.push_back(r.propNode0);
+      resistorNodes.push_back(r.propNode1);
+      resistances.push_back(r.propValue);
+    }  // end for
+
+    for (int k = 0; k < dscp.getNumCapacitors(); k++) {
+      const RCTreeDescriptor::Capacitor &c = dscp.getCapacitor(k);
+      capacitorNodes.push_back(c.propNode);
+      capacitances.push_back(c.propValue);
+    }  // end for
+
+    nodePointers.push_back(nodeCaps.size());
+    resistorPointers.push_back(resistances.size());
+    capacitorPointers.push_back(capacitances.size());
+  }  // end for
+
+  header.numNodes = nodeCaps.size();
+  header.numResistors = resistances.size();
+  header.numCapacitors = capacitances.size();
+  header.numNetNameChars = netNames.size();
+  header.numNodeNameChars = nodeNames.size();
+
+  SnapshotWriter &writer = snapshotWriter;
+  writer.write(header);
+  writer.writeArray(lumpedCaps.data(), numNets);
+  writer.writeArray(totalCaps.data(), numNets);
+  writer.writeArray(totalTreeCaps.data(), numNets);
+  writer.writeArray(nodePointers.data(), numNets + 1);
+  writer.writeArray(resistorPointers.data(), numNets + 1);
+  writer.writeArray(capacitorPointers.data(), numNets + 1);
+  writer.writeArray(netNamePointers.data(), numNets + 1);
+  writer.writeArray(nodeCaps.data(), header.numNodes);
+  writer.writeArray(nodeNamePointers.data(), header.numNodes + 1);
+  writer.writeArray(resistorNodes.data(), 2 * header.numResistors);
+  writer.writeArray(resistances.data(), header.numResistors);
+  writer.writeArray(capacitorNodes.data(), header.numCapacitors);
+  writer.writeArray(capacitances.data(), header.numCapacitors);
+  writer.writeArray(netNames.data(), header.numNetNameChars);
+  writer.writeArray(nodeNames.data(), header.numNodeNameChars);
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+bool Circuit::loadRCTreeSnapshot(vector<SpefNetInfo> &infos) {
+  SnapshotReader &reader = snapshotReader;
+
+  RCTreeSnapshotHeader header = RCTreeSnapshotHeader();
+  bool valid = reader.read(header) && header.numNets >= 0 &&
+               header.numNodes >= 0 && header.numResistors >= 0 &&
+               header.numCapacitors >= 0 && header.numNetNameChars >= 0 &&
+               header.numNodeNameChars >= 0;
+  if (!valid) header = RCTreeSnapshotHeader();
+
+  const long long numNets = header.numNets;
+  const double *lumpedCaps = reader.readArray<double>(numNets);
+  const double *totalCaps = reader.readArray<double>(numNets);
+  const double *totalTreeCaps = reader.readArray<double>(numNets);
+  const long long *nodePointers = reader.readArray<long long>(numNets + 1);
+  const long long *resistorPointers = reader.readArray<long long>(numNets + 1);
+  const long long *capacitorPointers =
+      reader.readArray<long long>(numNets + 1);
+  const long long *netNamePointers = reader.readArray<long long>(numNets + 1);
+  const double *nodeCaps = reader.readArray<double>(header.numNodes);
+  const long long *nodeNamePointers =
+      reader.readArray<long long>(header.numNodes + 1);
+  const int *resistorNodes = reader.readArray<int>(2 * header.numResistors);
+  const double *resistances = reader.readArray<double>(header.numResistors);
+  const int *capacitorNodes = reader.readArray<int>(header.numCapacitors);
+  const double *capacitances = reader.readArray<double>(header.numCapacitors);
+  const char *netNames = reader.readArray<char>(header.numNetNameChars);
+  const char *nodeNames = reader.readArray<char>(header.numNodeNameChars);
+
+  valid = valid && lumpedCaps && totalCaps && totalTreeCaps && nodePointers &&
+          resistorPointers && capacitorPointers && netNamePointers &&
+          nodeCaps && nodeNamePointers && resistorNodes && resistances &&
+          capacitorNodes && capacitances && netNames && nodeNames;
+
+  // Pointers must split the arrays they index and node indexes must be local
+  // to their net.
+  const auto isPartition = [](const long long *pointers, const long long n,
+                              const long long size) {
+    if (pointers[0] != 0 || pointers[n] != size) return false;
+    for (long long i = 0; i < n; i++)
+      if (pointers[i] > pointers[i + 1]) return false;
+    return true;
+  };
+
+  valid = valid && isPartition(nodePointers, numNets, header.numNodes) &&
+          isPartition(resistorPointers, numNets, header.numResistors) &&
+          isPartition(capacitorPointers, numNets, header.numCapacitors) &&
+          isPartition(netNamePointers, numNets, header.numNetNameChars) &&
+          isPartition(nodeNamePointers, header.numNodes,
+                      header.numNodeNameChars);
+  for (long long i = 0; valid && i < numNets; i++) {
+    const long long numNetNodes = nodePointers[i + 1] - nodePointers[i];
+    for (long long k = 2 * resistorPointers[i];
+         valid && k < 2 * resistorPointers[i + 1]; k++)
+      valid = resistorNodes[k] >= 0 && resistorNodes[k] < numNetNodes;
+    for (long long k = capacitorPointers[i];
+         valid && k < capacitorPointers[i + 1]; k++)
+      valid = capacitorNodes[k] >= 0 && capacitorNodes[k] < numNetNodes;
+  }  // end for
+
+  if (!valid) {
+    cout << "[WARNING] Snapshot '" << snapshotFile << "' is malformed.\n";
+    snapshotReader.close();
+    return false;
+  }  // end if
+
+  timingTreeDescriptors.clear();
+  timingTreeDescriptors.resize(numNets);
+  infos.resize(numNets);
+
+  for (int i = 0; i < numNets; i++) {
+    RCTreeDescriptor &dscp = timingTreeDescriptors[i];
+
+    SpefNetInfo &info = infos[i];
+    info.name.assign(netNames + netNamePointers[i],
+                     netNamePointers[i + 1] - netNamePointers[i]);
+    info.lumpedCap = lumpedCaps[i];
+    info.totalCap = totalCaps[i];
+
+    const long long n0 = nodePointers[i];
+    const long long n1 = nodePointers[i + 1];
+    const long long r0 = resistorPointers[i];
+    const long long r1 = resistorPointers[i + 1];
+    const long long c0 = capacitorPointers[i];
+    const long long c1 = capacitorPointers[i + 1];
+
+    dscp.reserve(n1 - n0, r1 - r0, c1 - c0);
+
+    for (long long k = n0; k < n1; k++)
+      dscp.addNode(string(nodeNames + nodeNamePointers[k],
+                          nodeNamePointers[k + 1] - nodeNamePointers[k]));
+
+    for (long long k = r0; k < r1; k++)
+      dscp.addResistor(resistorNodes[2 * k], resistorNodes[2 * k + 1],
+                       resistances[k]);
+
+    for (long long k = c0; k < c1; k++)
+      dscp.addCapacitor(capacitorNodes[k], capacitances[k]);
+
+    for (long long k = n0; k < n1; k++) dscp.setNodeCap(k - n0, nodeCaps[k]);
+    dscp.setTotalTreeCapacitance(totalTreeCaps[i]);
+  }  // end for
+
+  return true;
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+// Cells are stored as indexes: -1 for none, i < icells.size() for icells[i]
+// and icells.size() + i for the input driver graphRoot.nextCells[i].
+void Circuit::saveTimingGraphSnapshot() {
+  const int numCells = icells.size();
+  const int numNets = timingNets.size();
+  const int numArcs = timingArcs.size();
+
+  const int numInputDrivers = graphRoot.nextCells.size();
+  map<const Vcell *, int> inputDrivers;
+  for (int i = 0; i < numInputDrivers; i++)
+    inputDrivers[graphRoot.nextCells[i]] = numCells + i;
+
+  const auto cellIndex = [&](const Vcell *cell) {
+    if (!cell) return -1;
+    if (cell->instName == "inputDriver") return inputDrivers[cell];
+    return cell->vectorIndex;
+  };
+
+  vector<int> netDrivers(numNets);
+  vector<int> netFanouts(numNets);
+  vector<int> netDepths(numNets);
+  for (int i = 0; i < numNets; i++) {
+    const TimingNet &net = timingNets[i];
+    netDrivers[i] = cellIndex(net.driver);
+    netFanouts[i] = net.fanout;
+    netDepths[i] = net.depth;
+  }  // end for
+
+  vector<int> arcCells(numArcs);
+  vector<int> arcLuts(numArcs);
+  vector<int> arcPins(numArcs);
+  vector<int> arcDrivers(numArcs);
+  vector<int> arcSinks(numArcs);
+  for (int i = 0; i < numArcs; i++) {
+    const TimingArc &arc = timingArcs[i];
+    arcCells[i] = cellIndex(arc.cell);
+    arcLuts[i] = arc.lut;
+    arcPins[i] = arc.pin;
+    arcDrivers[i] = arc.driver;
+    arcSinks[i] = arc.sink;
+  }  // end for
+
+  const int offsets[6] = {timingNumDummyNets,
+                          timingOffsetToSequentialArcs,
+                          timingOffsetToCombinationArcs,
+                          timingOffsetToExtraSequentialArcs,
+                          timingOffsetToExtraPrimaryOutputArcs,
+                          timingOffsetToLevelOneNets};
+
+  SnapshotWriter &writer = snapshotWriter;
+  writer.writeArray(offsets, 6);
+  writer.writeVector(netDrivers);
+  writer.writeVector(netFanouts);
+  writer.writeVector(netDepths);
+  writer.writeVector(arcCells);
+  writer.writeVector(arcLuts);
+  writer.writeVector(arcPins);
+  writer.writeVector(arcDrivers);
+  writer.writeVector(arcSinks);
+  writer.writeVector(timingArcPointers);
+  writer.writeVector(timingSinkNets);
+  writer.writeVector(timingSinkNetPointers);
+  writer.writeVector(timingSinkArcs);
+  writer.writeVector(timingSinkArcPointers);
+  writer.writeVector(timingDriverNets);
+  writer.writeVector(timingDriverNetPointers);
+  writer.writeVector(timingNetIndexes);
+  writer.writeVector(timingTailNets);
+  writer.writeVector(timingTailNetMultiplicities);
+  writer.writeVector(timingOffsetToNetLevel);
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+bool Circuit::loadTimingGraphSnapshot() {
+  SnapshotReader &reader = snapshotReader;
+
+  const int *offsets = reader.readArray<int>(6);
+  vector<int> netDrivers;
+  vector<int> netFanouts;
+  vector<int> netDepths;
+  vector<int> arcCells;
+  vector<int> arcLuts;
+  vector<int> arcPins;
+  vector<int> arcDrivers;
+  vector<int> arcSinks;
+  vector<int> arcPointers;
+  vector<int> sinkNets;
+  vector<int> sinkNetPointers;
+  vector<int> sinkArcs;
+  vector<int> sinkArcPointers;
+  vector<int> driverNets;
+  vector<int> driverNetPointers;
+  vector<int> netIndexes;
+  vector<int> tailNets;
+  vector<int> tailNetMultiplicities;
+  vector<int> offsetToNetLevel;
+
+  bool valid =
+      offsets && reader.readVector(netDrivers) &&
+      reader.readVector(netFanouts) && reader.readVector(netDepths) &&
+      reader.readVector(arcCells) && reader.readVector(arcLuts) &&
+      reader.readVector(arcPins) && reader.readVector(arcDrivers) &&
+      reader.readVector(arcSinks) && reader.readVector(arcPointers) &&
+      reader.readVector(sinkNets) && reader.readVector(sinkNetPointers) &&
+      reader.readVector(sinkArcs) && reader.readVector(sinkArcPointers) &&
+      reader.readVector(driverNets) && reader.readVector(driverNetPointers) &&
+      reader.readVector(netIndexes) && reader.readVector(tailNets) &&
+      reader.readVector(tailNetMultiplicities) &&
+      reader.readVector(offsetToNetLevel);
+
+  const int numCells = icells.size();
+  const int numInputDrivers = graphRoot.nextCells.size();
+  const int numNets = netDrivers.size();
+  const int numArcs = arcCells.size();
+
+  // The graph also depends on the cell types and depths set by the initial
+  // solution, so check the cell references against them.
+  valid = valid && offsets[0] == numInputDrivers + 1 &&
+          (int)netFanouts.size() == numNets &&
+          (int)netDepths.size() == numNets && (int)arcLuts.size() == numArcs &&
+          (int)arcPins.size() == numArcs && (int)arcDrivers.size() == numArcs &&
+          (int)arcSinks.size() == numArcs &&
+          (int)netIndexes.size() == netlist.netNames.size() &&
+          (int)offsetToNetLevel.size() == maxLogicalDepth + 2;
+  for (int i = 0; valid && i < numNets; i++)
+    valid = netDrivers[i] >= -1 && netDrivers[i] < numCells + numInputDrivers;
+  for (int i = 0; valid && i < numArcs; i++) {
+    valid = arcCells[i] >= -1 && arcCells[i] < numCells + numInputDrivers &&
+            arcDrivers[i] >= 0 && arcDrivers[i] < numNets &&
+            arcSinks[i] >= -1 && arcSinks[i] < numNets;
+    if (valid && arcCells[i] == -1) {
+      valid = arcLuts[i] == -1 && arcPins[i] == -1;
+    } else if (valid) {
+      const Vcell *cell = arcCells[i] < numCells
+                              ? icells[arcCells[i]]
+                              : graphRoot.nextCells[arcCells[i] - numCells];
+      const int numLuts = cell->actualInstType->timingArcs.size();
+      const int numPins = cell->actualInstType->pins.size();
+      valid = arcLuts[i] >= -1 && arcLuts[i] < numLuts && arcPins[i] >= -1 &&
+              arcPins[i] < numPins;
+    }  // end else-if
+  }    // end for
+
+  // Pointers must be non-decreasing and stay within the arrays they index,
+  // and indexes must refer to existing nets and arcs.
+  const auto isInRange = [](const vector<int> &v, const int lower,
+                            const int upper) {
+    const int n = v.size();
+    for (int i = 0; i < n; i++)
+      if (v[i] < lower || v[i] > upper) return false;
+    return true;
+  };
+  const auto isPointers = [&](const vector<int> &pointers, const int size) {
+    const int n = pointers.size();
+    if (n != numNets + 1 || !isInRange(pointers, 0, size)) return false;
+    for (int i = 0; i + 1 < n; i++)
+      if (pointers[i] > pointers[i + 1]) return false;
+    return true;
+  };
+
+  valid = valid && isPointers(arcPointers, numArcs) &&
+          isPointers(sinkNetPointers, sinkNets.size()) &&
+          isPointers(sinkArcPointers, sinkArcs.size()) &&
+          isPointers(driverNetPointers, driverNets.size()) &&
+          isInRange(sinkNets, 0, numNets - 1) &&
+          isInRange(sinkArcs, 0, numArcs - 1) &&
+          isInRange(driverNets, 0, numNets - 1) &&
+          isInRange(netIndexes, -1, numNets - 1) &&
+          isInRange(tailNets, 0, numNets - 1) &&
+          tailNetMultiplicities.size() == tailNets.size() &&
+          isInRange(offsetToNetLevel, 0, numNets);
+  for (int i = 1; valid && i < 6; i++) valid = offsets[i] >= 0;
+  valid = valid && offsets[1] <= offsets[2] && offsets[2] <= offsets[3] &&
+          offsets[3] <= offsets[4] && offsets[4] <= numArcs &&
+          offsets[5] <= numNets;
+
+  if (!valid) {
+    cout << "[WARNING] Snapshot '" << snapshotFile << "' is malformed.\n";
+    snapshotReader.close();
+    return false;
+  }  // end if
+
+  const auto cell = [&](const int index) -> Vcell * {
+    if (index == -1) return NULL;
+    if (index < numCells) return icells[index];
+    return graphRoot.nextCells[index - numCells];
+  };
+
+  timingNets.assign(numNets, TimingNet());
+  for (int i = 0; i < numNets; i++) {
+    TimingNet &net = timingNets[i];
+    net.driver = cell(netDrivers[i]);
+    net.fanout = netFanouts[i];
+    net.depth = netDepths[i];
+  }  // end for
+
+  timingArcs.assign(numArcs, TimingArc());
+  for (int i = 0; i < numArcs; i++) {
+    TimingArc &arc = timingArcs[i];
+    arc.cell = cell(arcCells[i]);
+    arc.lut = arcLuts[i];
+    arc.pin = arcPins[i];
+    arc.driver = arcDrivers[i];
+    arc.sink = arcSinks[i];
+  }  // end for
+
+  timingNumDummyNets = offsets[0];
+  timingOffsetToSequentialArcs = offsets[1];
+  timingOffsetToCombinationArcs = offsets[2];
+  timingOffsetToExtraSequentialArcs = offsets[3];
+  timingOffsetToExtraPrimaryOutputArcs = offsets[4];
+  timingOffsetToLevelOneNets = offsets[5];
+
+  timingArcPointers.swap(arcPointers);
+  timingSinkNets.swap(sinkNets);
+  timingSinkNetPointers.swap(sinkNetPointers);
+  timingSinkArcs.swap(sinkArcs);
+  timingSinkArcPointers.swap(sinkArcPointers);
+  timingDriverNets.swap(driverNets);
+  timingDriverNetPointers.swap(driverNetPointers);
+  timingNetIndexes.swap(netIndexes);
+  timingTailNets.swap(tailNets);
+  timingTailNetMultiplicities.swap(tailNetMultiplicities);
+  timingOffsetToNetLevel.swap(offsetToNetLevel);
+  return true;
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::readSPEF() {
+  // read .spef file
+  string filename = rootDir + "/" + benchName + "/" + benchName + ".spef";
+
+  cout << " Number of wire nets: " << wires.size() << endl;
+
+  if (spefCheckParsers) checkSPEFParsers(cout);
+
+  timingTreeDescriptors.clear();
+  timingRCTreeReductionStats = RCTreeDescriptor::ReductionStats();
+
+  vector<SpefNetInfo> infos;
+
+  const bool loaded = snapshotReader.isOpen() && loadRCTreeSnapshot(infos);
+
+  if (loaded) {
+    cout << " RC trees loaded from snapshot '" << snapshotFile << "'." << endl;
+  } else if (spefLegacyParser) {
+    SpefParser sp(filename);
+
+    SpefNet spefNet;
+    vector<int> terminals;
+    int driver;
+
+    timingTreeDescriptors.reserve(netlist.netNames.size());
+    while (sp.read_net_data(spefNet)) {
+      timingTreeDescriptors.resize(timingTreeDescriptors.size() + 1);
+
+      RCTreeDescriptor &dscp = timingTreeDescriptors.back();
+      buildTreeDescriptor(spefNet, dscp, terminals, driver);
+
+      SpefNetInfo info;
+      info.name = spefNet.netName;
+      info.lumpedCap = spefNet.netLumpedCap;
+      info.totalCap = dscp.getTotalTreeCapacitance() * 1e15;  // fF
+      infos.push_back(info);
+
+      finishTreeDescriptor(dscp, terminals, driver,
+                           timingRCTreeReductionStats);
+    }  // end while
+  } else {
+    readSPEFSections(filename, infos);
+  }  // end else
+
+  if (!snapshotWriter.empty()) saveRCTreeSnapshot(infos);
+
+  int countWires = 0;
+  const int readCnt = infos.size();
+  for (int i = 0; i < readCnt; i++)
+    addSPEFWire(infos[i].name, infos[i].lumpedCap, infos[i].totalCap,
+                countWires);
+
+  cout << "Read " << readCnt << " nets in the spef file." << endl;
+  cout << " Wire capacitances read: " << countWires << " (" << readCnt << ")"
+       << endl;
+
+  if (timingRCTreeReductionTolerance > 0 && !loaded) {
+    const RCTreeDescriptor::ReductionStats &stats = timingRCTreeReductionStats;
+    cout << " RC tree reduction (tolerance " << timingRCTreeReductionTolerance
+         << "): " << stats.numNodesBefore << " -> " << stats.numNodesAfter
+         << " nodes, " << stats.numReducedTrees << " of " << stats.numTrees
+         << " trees reduced, max delay error " << stats.maxDelayError
+         << ", max cap error " << stats.maxCapError << endl;
+  }  // end if
+
+  // copy loads to cells
+  vector<double> netWireCaps(netlist.netNames.size(), 0.0);
+  for (set<Wire>::const_iterator it = wires.begin(); it != wires.end(); ++it) {
+    const int n = netlist.netNames.find(it->wire_name);
+    if (n != -1) netWireCaps[n] = it->cap;
+  }  // end for
+
+  const int outputPin = netlist.pinNames.find("o");
+  const int numCells = icells.size();
+  const int numInputDrivers = graphRoot.nextCells.size();
+  for (int i = 0; i < numCells + numInputDrivers; ++i) {
+    Vcell *tmpCell =
+        i < numCells ? icells[i] : graphRoot.nextCells[i - numCells];
+    for (int k = 0; k < tmpCell->numPins; ++k)
+      if (tmpCell->getPinNameId(netlist, k) == outputPin) {
+        tmpCell->wireLoad = netWireCaps[tmpCell->getPinNetId(netlist, k)];
+        break;
+      }  // end if
+  }      // end for
+  ///////NEW
+  /// END/////////////////////////////////////////////////////////////////
+  /*
+      SpefParser sp(filename);
+
+      string net;
+      double cap;
+      bool valid = sp.read_net_cap(net, cap);
+      int countWires = 0;
+      Wire twire, twire2;
+      set<Wire>::iterator itw;
+      int i = 0;
+
+      cout << " Number of wire nets: " << wires.size() << endl;
+      while (valid) {
+              //cout << "Lumped cap of net " << net << " is " << cap << endl ;
+              ++i;
+              twire.wire_name = net;
+
+              itw = wires.find(twire);
+              twire2 = *itw;
+              //for (int i = 0; i < thisCircuit.wires.size(); ++i)
+              //	if (net == thisCircuit.wires[i].wire_name)
+              if (net == twire2.wire_name) {
+                      //thisCircuit.wires[i].cap = cap;
+                      twire.cap = cap;
+                      wires.erase(itw);
+                      wires.insert(twire);
+                      //it->cap = cap;
+                      ++countWires;
+              }
+              valid = sp.read_net_cap(net, cap);
+      }
+      cout << " Wire capacitances read: " << countWires << " (" << i << ")" <<
+     endl;
+      //copy loads to cells
+      set<Vcell*>::iterator it;
+      Vcell* tmpCell;
+
+      for (int i = 0; i < icells.size(); ++i) {
+              tmpCell = icells[i];
+              for (int k = 0; k < tmpCell->pinNetPairs.size(); ++k)
+                      if (tmpCell->pinNetPairs[k].first == "o") {
+                              twire.wire_name = tmpCell->pinNetPairs[k].second;
+                              twire.cap = 0.0;
+                              itw = wires.find(twire);
+                              twire2 = *itw;
+                              tmpCell->wireLoad = twire2.cap;
+                              //cout << tmpCell->wireLoad << endl;
+                              break;
+                      }
+      }
       for (int i = 0; i < graphRoot.nextCells.size(); ++i) {
               tmpCell = graphRoot.nextCells[i];
               for (int k = 0; k < tmpCell->pinNetPairs.size(); ++k)
@@ -2759,11 +3877,10 @@ void Circuit::printTree(Vcell *root) {
     fifo.pop();
     if (tmp->actualInstType != NULL)
       cout << " Cell name: " << tmp->instName
-           << " Cell instance: " << tmp->instType << " ("
+           << " Cell instance: " << tmp->getTypeName() << " ("
            << tmp->actualInstType->name << ")" << endl;
     else
-      cout << " Cell name: " << tmp->instName
-           << " Cell instance: " << tmp->instType << endl;
+      cout << " Cell name: " << tmp->instName << endl;
     for (int i = 0; i < tmp->nextCells.size(); ++i)
       fifo.push(tmp->nextCells[i]);
   }
@@ -2773,6 +3890,8 @@ void Circuit::printTree(Vcell *root) {
 void Circuit::readInputFiles() {
   // read all input files
 
+  openSnapshot();
+
   cout << "Reading library..." << endl;
   readLib();
   cout << "Reading library...done" << endl << endl;
@@ -2871,6 +3990,195 @@ void Circuit::printLibraryReport(ostream &out) {
 
 // -----------------------------------------------------------------------------
 
+void Circuit::printRCTreeReport(ostream &out) {
+  long long numSimulations = 0;
+  long long numIterations = 0;
+  long long numClosedForms = 0;
+  int numTrees = 0;
+  int maxNumNodes = 0;
+  long long totalNumNodes = 0;
+
+  const int numNets = timingTrees.size();
+  for (int i = 0; i < numNets; i++) {
+    const RCTree &tree = timingTrees[i];
+    numSimulations += tree.getNumSimulations();
+    numIterations += tree.getNumIterations();
+    numClosedForms += tree.getNumClosedForms();
+    if (tree.getNumNodes() > 0) {
+      numTrees++;
+      totalNumNodes += tree.getNumNodes();
+      maxNumNodes = max(maxNumNodes, tree.getNumNodes());
+    }  // end if
+  }    // end for
+
+  out << "RC Trees\n";
+  out << "\tTrees: " << numTrees << "\n";
+  out << "\tNodes: " << totalNumNodes << " (max " << maxNumNodes << ")\n";
+  out << "\tWarm start: " << (timingRCTreeWarmStart ? "on" : "off") << "\n";
+  out << "\tPi-model closed form: "
+      << (timingRCTreePiModel ? "on" : "off") << " (max shielding "
+      << timingRCTreeMaxShielding << ")\n";
+  out << "\tSPEF reduction: "
+      << (timingRCTreeReductionTolerance > 0 ? "on" : "off")
+      << " (tolerance " << timingRCTreeReductionTolerance << ", "
+      << timingRCTreeReductionStats.numNodesBefore << " -> "
+      << timingRCTreeReductionStats.numNodesAfter << " nodes)\n";
+  out << "\tSimulations: " << numSimulations << " (closed form "
+      << numClosedForms << ")\n";
+  out << "\tCeff iterations: " << numIterations << "\n";
+  out << "\tCeff iterations per simulation: "
+      << (numSimulations > 0 ? numIterations / double(numSimulations) : 0)
+      << "\n";
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+bool Circuit::checkSPEFParsers(ostream &out) {
+  const string filename =
+      rootDir + "/" + benchName + "/" + benchName + ".spef";
+
+  SpefParser legacyParser(filename);
+  SpefFastParser fastParser(filename);
+  if (!fastParser.is_open()) {
+    out << "[ERROR] Unable to map the spef file '" << filename << "'.\n";
+    return false;
+  }  // end if
+
+  SpefNet legacyNet;
+  SpefFlatNet fastNet;
+
+  vector<int> legacyTerminals;
+  vector<int> fastTerminals;
+  int legacyDriver;
+  int fastDriver;
+
+  int numNets = 0;
+  int numMismatches = 0;
+  while (true) {
+    const bool legacyValid = legacyParser.read_net_data(legacyNet);
+    const bool fastValid = fastParser.read_net_data(fastNet);
+    if (legacyValid != fastValid) {
+      out << "[MISMATCH] Parsers read a different number of nets.\n";
+      numMismatches++;
+      break;
+    }  // end if
+    if (!legacyValid) break;
+
+    RCTreeDescriptor legacy;
+    RCTreeDescriptor fast;
+    buildTreeDescriptor(legacyNet, legacy, legacyTerminals, legacyDriver);
+    buildTreeDescriptor(fastNet, fast, fastTerminals, fastDriver);
+
+    bool equal = legacyNet.netName == fastNet.netName &&
+                 legacyNet.netLumpedCap == fastNet.netLumpedCap &&
+                 legacyTerminals == fastTerminals &&
+                 legacyDriver == fastDriver &&
+                 legacy.getNumNodes() == fast.getNumNodes() &&
+                 legacy.getNumResistors() == fast.getNumResistors() &&
+                 legacy.getNumCapacitors() == fast.getNumCapacitors() &&
+                 legacy.getTotalTreeCapacitance() ==
+                     fast.getTotalTreeCapacitance();
+
+    for (int k = 0; equal && k < legacy.getNumNodes(); k++) {
+      const RCTreeDescriptor::Node &n0 = legacy.getNode(k);
+      const RCTreeDescriptor::Node &n1 = fast.getNode(k);
+      equal = n0.propName == n1.propName && n0.totalCap == n1.totalCap &&
+              n0.propResistors == n1.propResistors &&
+              fast.findNode(n0.propName) == k;
+    }  // end for
+
+    for (int k = 0; equal && k < legacy.getNumResistors(); k++) {
+      const RCTreeDescriptor::Resistor &r0 = legacy.getResistor(k);
+      const RCTreeDescriptor::Resistor &r1 = fast.getResistor(k);
+      equal = r0.propNode0 == r1.propNode0 && r0.propNode1 == r1.propNode1 &&
+              r0.propValue == r1.propValue;
+    }  // end for
+
+    for (int k = 0; equal && k < legacy.getNumCapacitors(); k++) {
+      const RCTreeDescriptor::Capacitor &c0 = legacy.getCapacitor(k);
+      const RCTreeDescriptor::Capacitor &c1 = fast.getCapacitor(k);
+      equal = c0.propNode == c1.propNode && c0.propValue == c1.propValue;
+    }  // end for
+
+    if (!equal) {
+      out << "[MISMATCH] Net " << legacyNet.netName << " (" << fastNet.netName
+          << ")\n";
+      numMismatches++;
+    }  // end if
+    numNets++;
+  }  // end while
+
+  out << "SPEF parsers: " << numNets << " nets compared, " << numMismatches
+      << " mismatches\n";
+  return numMismatches == 0;
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::reportRCTreeSharingError(ostream &out) {
+  const double tolerance = timingRCTreeSharingTolerance;
+  const int numNets = timingNets.size();
+
+  long long numSimulations[2] = {0, 0};
+
+  // Exact mode.
+  for (int i = 0; i < numNets; i++) timingTrees[i].resetCounters();
+  timingRCTreeSharingTolerance = 0;
+  updateTiming();
+
+  const NetStateArrays exact = timingStateCurrent.nets;
+  const EdgeArray<double> exactWorstArrivalTime = timingWorstArrivalTime;
+  for (int i = 0; i < numNets; i++) {
+    numSimulations[0] += timingTrees[i].getNumSimulations();
+    timingTrees[i].resetCounters();
+  }  // end for
+
+  // Shared mode.
+  timingRCTreeSharingTolerance = tolerance;
+  updateTiming();
+
+  for (int i = 0; i < numNets; i++)
+    numSimulations[1] += timingTrees[i].getNumSimulations();
+
+  const NetStateArrays &nets = timingStateCurrent.nets;
+
+  double maxArrivalTimeError = 0;
+  double sumArrivalTimeError = 0;
+  double maxSlewError = 0;
+  int maxArrivalTimeErrorNet = -1;
+  for (int i = timingNumDummyNets; i < numNets; i++) {
+    for (int edge = 0; edge < 2; edge++) {
+      const double arrivalTimeError =
+          fabs(nets.arrivalTime[i][edge] - exact.arrivalTime[i][edge]);
+      const double slewError = fabs(nets.slew[i][edge] - exact.slew[i][edge]);
+
+      sumArrivalTimeError += arrivalTimeError;
+      maxSlewError = max(maxSlewError, slewError);
+      if (arrivalTimeError > maxArrivalTimeError) {
+        maxArrivalTimeError = arrivalTimeError;
+        maxArrivalTimeErrorNet = i;
+      }  // end if
+    }    // end for
+  }      // end for
+
+  const int numCombinationalNets = max(1, numNets - timingNumDummyNets);
+
+  out << "RC Tree Sharing (tolerance " << tolerance << ")\n";
+  out << "\tSimulations: " << numSimulations[1] << " (exact "
+      << numSimulations[0] << ")\n";
+  out << "\tMax arrival time error: " << maxArrivalTimeError;
+  if (maxArrivalTimeErrorNet != -1)
+    out << " @ " << timingNetName[maxArrivalTimeErrorNet];
+  out << "\n";
+  out << "\tAvg arrival time error: "
+      << sumArrivalTimeError / (2 * numCombinationalNets) << "\n";
+  out << "\tMax slew error: " << maxSlewError << "\n";
+  out << "\tWorst arrival time: " << timingWorstArrivalTime << " (exact "
+      << exactWorstArrivalTime << ")\n";
+}  // end method
+
+// -----------------------------------------------------------------------------
+
 void Circuit::StepperPrint::operator()(Vcell *cell) {
   cerr << cell->vectorIndex << "\t" << cell->actualInstType->name << "\n";
   cerr << "\tSequential: " << cell->actualInstType->isSequential << "\n";
@@ -2908,17 +4216,9 @@ void Circuit::StepperPathLogicalEffort::operator()(int arcIndex) {
   pathLogicalEffort *= le;
 
   // Compute branching effort.
-  double con;
   const LibParserCellInfo &cellInfo = *cell->actualInstType;
   const LibParserTimingInfo &timingInfo = cellInfo.timingArcs[arc.lut];
-  for (int i = 0; cellInfo.pins.size(); i++) {
-    const LibParserPinInfo &pinInfo = cellInfo.pins[i];
-
-    if (pinInfo.name == timingInfo.fromPin) {
-      con = pinInfo.capacitance;
-      break;
-    }  // end if
-  }    // end for
+  const double con = cellInfo.pins[timingInfo.fromPinIndex].capacitance;
   cell->branchingEffort = (super->getTimingNetState(arc.driver).load) / con;
   pathBranchingEffort *= (super->getTimingNetState(arc.driver).load) / con;
   pathFanoutEffort *=
@@ -2981,7 +4281,7 @@ void Circuit::StepperAssignSizeLogicalEffort::operator()(int arcIndex) {
   // Change to the best cell candidate.
   super->updateCellType(cell, bestCell);
 
-  // cerr << "Cell: " << cell->instName << " ("  <<cell->instType << ")\t" <<
+  // cerr << "Cell: " << cell->instName << " ("  <<cell->getTypeName() << ")\t" <<
   // Cin << "\t" << bestCell << "\n";
 }  // end method
 
@@ -3157,16 +4457,18 @@ void Circuit::sizingLogicalEffort() {
 
     const string outputNet = timingNetName[stepper.currentCell->sinkNetIndex];
 
-    const vector<pair<string, string> > &p = stepper.previousCell->pinNetPairs;
-    const vector<LibParserPinInfo> &pins =
-        stepper.previousCell->actualInstType->pins;
+    const Vcell *p = stepper.previousCell;
+    const int outputNetId = netlist.netNames.find(outputNet);
+    const vector<LibParserPinInfo> &pins = p->actualInstType->pins;
 
     //*
     Cin = 0;
-    for (int i = 0; i < p.size(); i++) {
-      if (p[i].second == outputNet) {
-        for (int k = 0; k < p.size(); k++) {
-          if (p[i].first == pins[k].name) {
+    for (int i = 0; i < p->numPins; i++) {
+      if (p->getPinNetId(netlist, i) == outputNetId) {
+        const string pinName =
+            netlist.pinNames.getString(p->getPinNameId(netlist, i));
+        for (int k = 0; k < p->numPins; k++) {
+          if (pinName == pins[k].name) {
             Cin = pins[k].capacitance;
             break;
           }  // end if
@@ -3361,21 +4663,18 @@ void Circuit::stepperSlewTarget(Vcell *cell) {
   //	cell->inputSlews[j].second : timingInfo.riseDelay.transitionIndices[0];
 
   int i, k;
-  // cout << "O slew da célula " << cell->instType << " é " <<
+  // cout << "O slew da célula " << cell->getTypeName() << " é " <<
   // cell->outputRiseSlew << " fall " << cell->outputFallSlew << endl;
 
   for (i = 0; i < cell->actualInstType->timingArcs.size(); ++i) {
-    for (k = 0; k < cell->pinNetPairs.size(); ++k) {
-      if (cell->actualInstType->timingArcs[i].fromPin ==
-          cell->pinNetPairs[k].first)
-        break;
-    }
-    assert(k != cell->pinNetPairs.size());
+    k = cell->findPin(netlist, cell->actualInstType->timingArcs[i].fromPin);
+    assert(k != -1);
 
     if (cell->actualInstType->timingArcs[i].toPin != "o") continue;
 
     cout << "celula " << cell->instName << " entrada "
-         << cell->pinNetPairs[k].first << " input slew do pino " << k << " é "
+         << netlist.pinNames.getString(cell->getPinNameId(netlist, k))
+         << " input slew do pino " << k << " é "
          << cell->inputSlews[k].second << endl;
 
     // net.slew[RISE] = cell->inputSlews[0].first;
@@ -3741,7 +5040,7 @@ void Circuit::changeCellsFlach2() {
   }    // end for
 
   // cout << "******** cell: " << chosenCell->instName << " changed from: " <<
-  // chosenCell->instType;
+  // chosenCell->getTypeName();
 
   // Change to the best cell candidate.
   updateCellType(chosenCell, bestCell);
@@ -3750,7 +5049,7 @@ void Circuit::changeCellsFlach2() {
   for (int k = 0; k < numPreviousCells; k++)
     updateCellLoad(chosenCell->previousCells[k]);
 
-  // cout << " to: " << chosenCell->instType << endl;
+  // cout << " to: " << chosenCell->getTypeName() << endl;
 
 }  // end method
 
@@ -3816,10 +5115,9 @@ void Circuit::changeCellsGraci() {
 
   for (int i = 0; i < graphRoot.nextCells.size(); ++i) {
     graphRoot.nextCells[i]->changed = false;
-    cout << "Nome do graphroot " << graphRoot.instName << " e tipo "
-         << graphRoot.instType << endl;
+    cout << "Nome do graphroot " << graphRoot.instName << endl;
     cout << "Proxima celula do graphroot " << graphRoot.nextCells[i]->instName
-         << " e tipo " << graphRoot.nextCells[i]->instType << endl;
+         << " e tipo " << graphRoot.nextCells[i]->getTypeName() << endl;
   }
 
   cout << "O slack Ã© " << initialWorstSlack << endl;
@@ -4200,7 +5498,7 @@ void Circuit::walkBackwardDepth(WalkerCallback callback) {
 void Circuit::stepperVaiVem1(Vcell *cell) {
   // Print gate name
   // debug( "graci", endl << endl << "Celula: " << cell->instName << " do tipo "
-  // << cell->instType << endl << endl );
+  // << cell->getTypeName() << endl << endl );
 
   if (cell->actualInstType->isSequential) {
     // cout << "Cell sequencial \n \n";
@@ -4269,7 +5567,7 @@ void Circuit::stepperVaiVem1(Vcell *cell) {
   if (bestCell != -1) {
     updateCellType(cell, bestCell);
     // cout << "Best Cell " << bestCell << endl;
-    // debug( "graci", "Celula " << cell->instName << " tipo " << cell->instType
+    // debug( "graci", "Celula " << cell->instName << " tipo " << cell->getTypeName()
     // << "\n\n" ); calcTiming(); coneTiming2(cell);
     updateTiming(cell);
     // calcTimingViol();
@@ -4363,7 +5661,7 @@ void Circuit::stepperVaiVem2(Vcell *cell) {
       cell->changed = true;
       // cout << "Best Cell " << bestCell << endl;
       // debug( "graci", "Celula " << cell->instName << " tipo " <<
-      // cell->instType << "\n\n" ); calcTiming();
+      // cell->getTypeName() << "\n\n" ); calcTiming();
       updateTiming(cell);
       // cell->changed = true;
       // calcTimingViol();
@@ -4684,25 +5982,16 @@ void Circuit::stepperSetCellSlewTarget(Vcell *cell) {
     for (k = 0; k < cellInst->timingArcs.size(); ++k) {
       if (cellInst->timingArcs[k].toPin != "o") continue;
 
-      for (int l = 0; l < numPreviousCells; l++) {
+      const int m = cell->findPin(netlist, cellInst->timingArcs[k].fromPin);
+      for (int l = 0; l < numPreviousCells && m != -1; l++) {
         Vcell *driver = cell->previousCells[l];
 
-        for (int m = 0; m < cell->pinNetPairs.size(); ++m) {
-          if (((driver->returnNetConnectedToPin("o")) ==
-               cell->pinNetPairs[m].second) &&
-              cellInst->timingArcs[k].fromPin == cell->pinNetPairs[m].first) {
-            // cout << "Net " << driver->returnNetConnectedToPin("o") << "
-            // conectada no pino de saíde da celula " << driver->instName << "
-            // conectada na celula " << cell->instName << " pino " <<
-            // cell->pinNetPairs[m].first << " net " <<
-            // cell->pinNetPairs[m].second << " timing arco da intância " <<
-            // cellInst->timingArcs[k].fromPin << endl;
-            yInputRiseSlew = max(driver->slewRiseEstimative, yInputRiseSlew);
-            yInputFallSlew = max(driver->slewFallEstimative, yInputFallSlew);
-
-          }  // end if
-        }    // end for
-      }      // end for
+        if (driver->findNetConnectedToPin(netlist, "o") ==
+            cell->getPinNetId(netlist, m)) {
+          yInputRiseSlew = max(driver->slewRiseEstimative, yInputRiseSlew);
+          yInputFallSlew = max(driver->slewFallEstimative, yInputFallSlew);
+        }  // end if
+      }    // end for
 
       //            for (j = 0; j < cell->pinNetPairs.size(); ++j) {
       //                if (cellInst->timingArcs[k].fromPin ==
@@ -5124,9 +6413,9 @@ void Circuit::computeCellDepths() {
           if (!cell1->actualInstType->isSequential) {
             cerr << "[BUG] @ computeCellDepths(): max depth cell " << i
                  << " not connected to a sequential element.\n";
-            cerr << "\tDriver: " << cell0->instName << "\t" << cell0->instType
+            cerr << "\tDriver: " << cell0->instName << "\t" << cell0->getTypeName()
                  << "\n";
-            cerr << "\tSink..: " << cell1->instName << "\t" << cell1->instType
+            cerr << "\tSink..: " << cell1->instName << "\t" << cell1->getTypeName()
                  << "\n";
           }  // end if
         }    // end for
@@ -5148,9 +6437,9 @@ void Circuit::computeCellDepths() {
           cell1->logicalDepth <= cell0->logicalDepth) {
         cerr << "[BUG] @ computeCellDepths(): cell " << i
              << " driving a cell with smaller depth.\n";
-        cerr << "\tDriver: " << cell0->instName << "\t" << cell0->instType
+        cerr << "\tDriver: " << cell0->instName << "\t" << cell0->getTypeName()
              << "\n";
-        cerr << "\tSink..: " << cell1->instName << "\t" << cell1->instType
+        cerr << "\tSink..: " << cell1->instName << "\t" << cell1->getTypeName()
              << "\n";
       }  // end if
     }    // end for
@@ -5231,7 +6520,7 @@ void Circuit::computeCellReverseDepths() {
       if (!cell0->actualInstType->isSequential &&
           cell0->instName != "inputDriver") {
         cerr << "[BUG] @ computeCellReverseDepths(): max depth cell "
-             << cell0->instName << " (" << cell0->instType
+             << cell0->instName << " (" << cell0->getTypeName()
              << ") should by a sequential cell or a input driver.\n";
       }  // end if
     }    // end if
@@ -5249,9 +6538,9 @@ void Circuit::computeCellReverseDepths() {
         cerr << "[BUG] @ computeCellReverseDepths(): cell " << i
              << " driving a cell with smaller reverse logical depth.\n";
         cerr << "\tDriver: " << cell1->reverseLogicalDepth << "\t"
-             << cell1->instName << "\t" << cell1->instType << "\n";
+             << cell1->instName << "\t" << cell1->getTypeName() << "\n";
         cerr << "\tSink..: " << cell0->reverseLogicalDepth << "\t"
-             << cell0->instName << "\t" << cell0->instType << "\n";
+             << cell0->instName << "\t" << cell0->getTypeName() << "\n";
       }  // end if
     }    // end for
   }      // end for
@@ -5263,77 +6552,102 @@ void Circuit::computeCellReverseDepths() {
 
 void Circuit::computePseudoIndependentSets() {
   const int numNets = timingNets.size();
-  const int numCandidateNets = numNets - timingOffsetToLevelOneNets;
 
+  timingPseudIndependentSets.clear();
+  timingPseudIndependentSetPointers.clear();
   timingPseudIndependentSets.reserve(numNets);
-  timingPseudIndependentSetPointers.reserve(numNets + 1);
-
-  vector<int> touch(numNets, -1);
-  vector<bool> convered(numNets, false);
-
   timingPseudIndependentSetPointers.push_back(0);
   timingNumPseudoIndependentSets = 0;
 
-  vector<int> netIndexes(numCandidateNets);
-  for (int i = 0; i < numCandidateNets; i++)
-    netIndexes[i] = timingOffsetToLevelOneNets + i;
-
-  // random_shuffle(netIndexes.begin(), netIndexes.end()); // [TODO] it seems to
-  // be too slow, find alternative sort methods
-
-  while (true) {
-    // cerr << "Set " << timingNumPseudoIndependentSets << "\n";
-
-    bool newset = false;
+  // Candidate nets are the outputs of sizable cells in topological order, so
+  // each set sizes cells roughly in the same order as the serial solver.
+  vector<int> candidates;
+  candidates.reserve(numNets);
+  const int numSortedCells = depthSortedCells.size();
+  for (int k = offsetCombinational; k < numSortedCells; k++) {
+    const Vcell *cell = depthSortedCells[k];
+    if (cell->dontTouch || cell->sinkNetIndex == -1) continue;
+    candidates.push_back(cell->sinkNetIndex);
+  }  // end for
 
-    // Put uncovered nets first.
-    int skipCounter = 0;
+  // Footprint of a net: its local nets, which are written when the driver
+  // cell is resized, plus their driver and sink nets, whose timing is read
+  // back. Two nets whose footprints do not intersect can be processed
+  // concurrently. Footprints are computed once, in CSR form, in the order of
+  // the candidate nets.
+  //
+  // The sinks of a high fanout net are replaced by a single shared resource
+  // (numNets + the net index), which is also claimed by every net driven by
+  // it. This keeps footprints small while still ordering a net that writes
+  // one of those sinks after any net that reads them.
+  const int maxFanout = 16;
+  const auto isHighFanout = [&](const int n) {
+    return timingSinkNetPointers[n + 1] - timingSinkNetPointers[n] > maxFanout;
+  };
+
+  const int numCandidates = candidates.size();
+  vector<int> footprintPointers(numCandidates + 1, 0);
+  vector<int> footprints;
+  for (int i = 0; i < numCandidates; i++) {
+    const int n = candidates[i];
+    const int k0 = timingLocalNetPointers[n];
+    const int k1 = timingLocalNetPointers[n + 1];
+    for (int k = k0; k < k1; k++) {
+      const int local = timingLocalNets[k];
+      footprints.push_back(local);
+
+      const int d0 = timingDriverNetPointers[local];
+      const int d1 = timingDriverNetPointers[local + 1];
+      for (int d = d0; d < d1; d++) {
+        const int driver = timingDriverNets[d];
+        footprints.push_back(driver);
+        if (isHighFanout(driver)) footprints.push_back(numNets + driver);
+      }  // end for
 
-    for (int i = 0; i < numCandidateNets; i++) {
-      const int n = netIndexes[i];
-      if (!convered[n]) {
-        // Put it in the first places.
-        swap(netIndexes[skipCounter++], netIndexes[i]);
-      }  // end if
+      if (isHighFanout(local)) {
+        footprints.push_back(numNets + local);
+      } else {
+        const int s0 = timingSinkNetPointers[local];
+        const int s1 = timingSinkNetPointers[local + 1];
+        for (int s = s0; s < s1; s++) footprints.push_back(timingSinkNets[s]);
+      }  // end else
     }    // end for
+    footprintPointers[i + 1] = footprints.size();
+  }  // end for
 
-    if (skipCounter == 0) break;
+  // Candidates not assigned to a set yet.
+  vector<int> pending(numCandidates);
+  for (int i = 0; i < numCandidates; i++) pending[i] = i;
 
-    // Create pseudo-independent set.
-    for (int i = 0; i < numCandidateNets; i++) {
-      const int n = netIndexes[i];
+  vector<int> touch(2 * numNets, -1);
 
-      if (touch[n] == timingNumPseudoIndependentSets) continue;
+  while (!pending.empty()) {
+    const int set = timingNumPseudoIndependentSets;
 
-      convered[n] = true;
+    int numPending = 0;
+    const int numCurrent = pending.size();
+    for (int i = 0; i < numCurrent; i++) {
+      const int candidate = pending[i];
+      const int k0 = footprintPointers[candidate];
+      const int k1 = footprintPointers[candidate + 1];
 
-      // Process previous and current level timing arcs.
-      const int k0 = timingArcPointers[n];
-      const int k1 = timingArcPointers[n + 1];
-      for (int k = k0; k < k1; k++) {
-        const TimingArc &arc = timingArcs[k];
-
-        touch[arc.driver] = timingNumPseudoIndependentSets;
+      bool independent = true;
+      for (int k = k0; k < k1 && independent; k++)
+        independent = touch[footprints[k]] != set;
 
-        // Sink nets of driver nets.
-        const int n0 = timingSinkNetPointers[arc.driver];
-        const int n1 = timingSinkNetPointers[arc.driver + 1];
-        for (int k = n0; k < n1; k++) {
-          touch[timingSinkNets[k]] = timingNumPseudoIndependentSets;
-        }  // end for
-      }    // end for
+      if (!independent) {
+        pending[numPending++] = candidate;
+        continue;
+      }  // end if
 
-      // Sink nets of this net.
-      const int n0 = timingSinkNetPointers[n];
-      const int n1 = timingSinkNetPointers[n + 1];
-      for (int k = n0; k < n1; k++) {
-        touch[timingSinkNets[k]] = timingNumPseudoIndependentSets;
-      }  // end for
+      for (int k = k0; k < k1; k++) touch[footprints[k]] = set;
 
       // Add this net to the current set.
-      timingPseudIndependentSets.push_back(n);
+      timingPseudIndependentSets.push_back(candidates[candidate]);
     }  // end for
 
+    pending.resize(numPending);
+
     timingPseudIndependentSetPointers.push_back(
         timingPseudIndependentSets.size());
     timingNumPseudoIndependentSets++;
@@ -6951,6 +8265,40 @@ void Circuit::sizingLagrangeRelaxationSensitivities(const bool resetLambdas) {
 
 // -----------------------------------------------------------------------------
 
+#ifdef PARALLEL
+
+int Circuit::sizingLagrangeRelaxationParallel(const double alpha) {
+  vector<int> changes(threadNumThreads, 0);
+
+  const ThreadPool::Task task = [this, alpha, &changes](const int threadId,
+                                                        const int k0,
+                                                        const int k1) {
+    for (int k = k0; k < k1; k++) {
+      Vcell *cell = timingNets[timingPseudIndependentSets[k]].driver;
+      if (updateCellTypeLagrangeRelaxationPruned(cell, alpha, threadId, 1 + k))
+        changes[threadId]++;
+    }  // end for
+  };
+
+  for (int set = 0; set < timingNumPseudoIndependentSets; set++) {
+    threadPool.parallelFor(threadSetPointers[set], task);
+
+    // Commit the changes of this set before sizing the next one.
+    const int k0 = timingPseudIndependentSetPointers[set];
+    const int k1 = timingPseudIndependentSetPointers[set + 1];
+    updateTiming_Violations(k0, k1);
+    updateSizing_Totals(k0, k1);
+  }  // end for
+
+  int numChanges = 0;
+  for (int i = 0; i < threadNumThreads; i++) numChanges += changes[i];
+  return numChanges;
+}  // end method
+
+#endif
+
+// -----------------------------------------------------------------------------
+
 void Circuit::sizingLagrangeRelaxationSensitivitiesDefault(
     const bool resetLambdas, const int iterations) {
   const int numArcs = timingArcs.size();
@@ -7005,15 +8353,19 @@ void Circuit::sizingLagrangeRelaxationSensitivitiesDefault(
     changes = 0;
 
     // Solve LSR.
+#ifdef PARALLEL
+    changes += sizingLagrangeRelaxationParallel();
+#else
     for (int k = offsetCombinational; k < numCells; k++) {
       // for (int k = numCells - 1; k >= offsetCombinational; k--) {
       Vcell *cell = depthSortedCells[k];
-      changes +=
-          (updateCellTypeLagrangeRelaxation(cell /*, gamma /*, alpha*/) == 1)
-              ? 1
-              : 0;
+      changes += (updateCellTypeLagrangeRelaxationPruned(cell) == 1) ? 1 : 0;
     }  // end for
 
+    updateTiming_Violations();
+    updateSizing_Totals();
+#endif
+
     // Update timings.
     updateTiming();
     updateRequiredTime();
@@ -7591,7 +8943,7 @@ void Circuit::sizingProportionalDelay() {
     if (it->first > 0 || counter > 100) break;
 
     // cerr << counter << "\t" << it->first << "\t" <<  cell->nextNum << "\t" <<
-    // cell->instName << "\t" << cell->instType << "\n";
+    // cell->instName << "\t" << cell->getTypeName() << "\n";
 
     updateCellType(cell, min(29, cell->actualInstTypeIndex + 1));
 
@@ -7682,7 +9034,7 @@ void Circuit::timingRecovery() {
         upsize(cell);
 
       updateTiming(cell);
-      updateRequiredTime();
+      updateRequiredTimeFromSeeds();
 
       if (timingTotalNegativeSlack <= 0) break;
     } else {
@@ -7772,7 +9124,7 @@ void Circuit::timingRecovery(const int limit) {
         upsize(cell);
 
       updateTiming(cell);
-      updateRequiredTime();
+      updateRequiredTimeFromSeeds();
 
       if ((timingTotalNegativeSlack <= 0) || (digest.getElapsedTime() > limit))
         break;
@@ -7818,6 +9170,7 @@ void Circuit::timingRecoveryPathCounter() {
 
         if (nearlyZero(timingTotalNegativeSlack)) break;
 
+        updateRequiredTimeFromSeeds();
         updateCriticalPathCounter();
         i = 0;
       } else {
@@ -7864,6 +9217,7 @@ void Circuit::timingRecoveryPathCounterTestingChanges() {
 
         if (nearlyZero(timingTotalNegativeSlack)) break;
 
+        updateRequiredTimeFromSeeds();
         updateCriticalPathCounter();
         i = 0;
       } else {
@@ -7928,6 +9282,7 @@ void Circuit::timingRecoveryPathCounter(const int limit,
             (digest.getElapsedTime() > limit))
           break;
 
+        updateRequiredTimeFromSeeds();
         updateCriticalPathCounter();
         i = 0;
         continue;
@@ -7943,6 +9298,7 @@ void Circuit::timingRecoveryPathCounter(const int limit,
               (digest.getElapsedTime() > limit))
             break;
 
+          updateRequiredTimeFromSeeds();
           updateCriticalPathCounter();
           i = 0;
           continue;
@@ -7966,6 +9322,7 @@ void Circuit::timingRecoveryPathCounter(const int limit,
               (digest.getElapsedTime() > limit))
             break;
 
+          updateRequiredTimeFromSeeds();
           updateCriticalPathCounter();
           i = 0;
           continue;
@@ -7987,6 +9344,7 @@ void Circuit::timingRecoveryPathCounter(const int limit,
               (digest.getElapsedTime() > limit))
             break;
 
+          updateRequiredTimeFromSeeds();
           updateCriticalPathCounter();
           i = 0;
           continue;
@@ -8028,7 +9386,6 @@ void Circuit::powerRecovery() {
         bool changed = false;
 
         const int originalTypeIndex = cell->actualInstTypeIndex;
-        const string originalTypeName = cell->instType;
         const double originalLeakagePower = cell->getLeakagePower();
 
         double currentTNS = timingTotalNegativeSlack;
@@ -8050,10 +9407,10 @@ void Circuit::powerRecovery() {
             //"->"
             //<< cell->actualInstTypeIndex
             //							<< setw(20) <<
-            // originalTypeName
+            // orgCells.oCells[cell->footprintIndex].cells[originalTypeIndex].name
             //<<
             //"->"
-            //<< cell->instType
+            //<< cell->getTypeName()
             //							<< setw(12) <<
             //(timingTotalNegativeSlack
             //- currentTNS)
@@ -8084,7 +9441,6 @@ void Circuit::powerRecovery() {
         bool changed = false;
 
         const int originalTypeIndex = cell->actualInstTypeIndex;
-        const string originalTypeName = cell->instType;
         const double originalLeakagePower = cell->getLeakagePower();
 
         double currentTNS = timingTotalNegativeSlack;
@@ -8106,10 +9462,10 @@ void Circuit::powerRecovery() {
             //"->"
             //<< cell->actualInstTypeIndex
             //							<< setw(20) <<
-            // originalTypeName
+            // orgCells.oCells[cell->footprintIndex].cells[originalTypeIndex].name
             //<<
             //"->"
-            //<< cell->instType
+            //<< cell->getTypeName()
             //							<< setw(12) <<
             //(timingTotalNegativeSlack
             //- currentTNS)
@@ -8170,7 +9526,6 @@ void Circuit::powerRecovery(const double limit) {
         bool changed = false;
 
         const int originalTypeIndex = cell->actualInstTypeIndex;
-        const string originalTypeName = cell->instType;
         const double originalLeakagePower = cell->getLeakagePower();
 
         double currentTNS = timingTotalNegativeSlack;
@@ -8194,10 +9549,10 @@ void Circuit::powerRecovery(const double limit) {
             //"->"
             //<< cell->actualInstTypeIndex
             //							<< setw(20) <<
-            // originalTypeName
+            // orgCells.oCells[cell->footprintIndex].cells[originalTypeIndex].name
             //<<
             //"->"
-            //<< cell->instType
+            //<< cell->getTypeName()
             //							<< setw(12) <<
             //(timingTotalNegativeSlack
             //- currentTNS)
@@ -8228,7 +9583,6 @@ void Circuit::powerRecovery(const double limit) {
         bool changed = false;
 
         const int originalTypeIndex = cell->actualInstTypeIndex;
-        const string originalTypeName = cell->instType;
         const double originalLeakagePower = cell->getLeakagePower();
 
         double currentTNS = timingTotalNegativeSlack;
@@ -8252,10 +9606,10 @@ void Circuit::powerRecovery(const double limit) {
             //"->"
             //<< cell->actualInstTypeIndex
             //							<< setw(20) <<
-            // originalTypeName
+            // orgCells.oCells[cell->footprintIndex].cells[originalTypeIndex].name
             //<<
             //"->"
-            //<< cell->instType
+            //<< cell->getTypeName()
             //							<< setw(12) <<
             //(timingTotalNegativeSlack
             //- currentTNS)
@@ -8481,10 +9835,9 @@ void Circuit::saveCeff() {
     const int numNets = timingNets.size();
     for (int i = 0; i < numNets; ++i) {
       RCTree &tree = timingTrees[i];
-      const RCTree::Node &root = tree.getRoot();
       if (timingNets[i].driver != NULL)
         fprintf(pfile, "%s %f %f\n", timingNets[i].driver->instName.c_str(),
-                timingTrees[i].getLumpedCap(), root.propDownstreamCap);
+                timingTrees[i].getLumpedCap(), tree.getDownstreamCap(0));
     }
     fclose(pfile);
     cout << " Saving ceff...done" << endl;
@@ -8540,7 +9893,98 @@ void Circuit::storeState() {
 
 // -----------------------------------------------------------------------------
 
-void Circuit::buildTimingStructure() {
+// Builds the timing graph, or loads it from the design snapshot, and then
+// sets up the timing state.
+void Circuit::buildTimingStructure() {
+  if (snapshotReader.isOpen() && loadTimingGraphSnapshot())
+    cout << " Timing graph loaded from snapshot '" << snapshotFile << "'."
+         << endl;
+  else
+    buildTimingGraph();
+  snapshotReader.close();
+
+  if (!snapshotWriter.empty()) {
+    saveTimingGraphSnapshot();
+    saveSnapshot();
+  }  // end if
+
+  initializeTimingGraphState();
+
+#ifndef NDEBUG
+  // Check if all timingNets have been correctly initialized.
+  for (int i = timingNumDummyNets; i < timingNets.size(); i++) {
+    const TimingNet &net = timingNets[i];
+
+    if (!net.driver)
+      cerr << "[BUG] @ Circuit::buildTimingStructure() - Net " << i
+           << " has no driver.\n";
+
+    if (net.depth == -1)
+      cerr << "[BUG] @ Circuit::buildTimingStructure() - Net " << i
+           << " has invalid depth.\n";
+  }  // end for
+
+  // Check if tail nets match with nets driven by tail cells.
+  for (int i = 0; i < pathTails.size(); i++) {
+    const int n = pathTails[i]->sinkNetIndex;
+
+    bool found = false;
+    for (int k = 0; k < timingTailNets.size(); k++) {
+      if (n == timingTailNets[k]) {
+        found = true;
+        break;
+      }  // end if
+    }    // end for
+
+    if (!found)
+      cerr << "[BUG] @ Circuit::buildTimingStructure() - Net " << n
+           << " should be in tail net list.\n";
+  }  // end for
+
+  // Check if tail nets are driving by a tail cell.
+  for (int i = 0; i < timingTailNets.size(); i++) {
+    const Vcell *driver = timingNets[timingTailNets[i]].driver;
+
+    // cerr << "\tNet " << i << "\t" << driver->instName << " (" <<
+    // driver->getTypeName() << ")\n";
+
+    bool found = false;
+    for (int k = 0; k < pathTails.size(); k++) {
+      if (driver == pathTails[k]) {
+        found = true;
+        break;
+      }  // end if
+    }    // end for
+
+    if (!found)
+      cerr << "[BUG] @ Circuit::buildTimingStructure() - Cell "
+           << driver->instName << " (" << driver->getTypeName()
+           << ") should be in tail net list.\n";
+  }  // end for
+
+  // Check if fanout matches the nextNum property in Vcell.
+  for (int i = timingNumDummyNets; i < timingNets.size(); i++) {
+    const TimingNet &net = timingNets[i];
+
+    if (net.fanout != net.driver->nextNum) {
+      cerr << "[BUG] @ Circuit::buildTimingStructure() - Divergent fanout "
+              "numbers for net "
+           << timingNetName[i] << " and its driver.\n"
+           << "\tNet Fanout.........: " << net.fanout << "\t"
+           << timingNetName[i] << "\n"
+           << "\tNet's Driver Fanout: " << net.driver->nextNum << "("
+           << net.driver->nextCells.size() << ") "
+           << "\t" << net.driver->instName << " (" << net.driver->getTypeName()
+           << ")"
+           << "\n";
+    }  // end if
+  }    // end for
+#endif
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::buildTimingGraph() {
   int counterArcs_InputDrivers = 0;
   int counterArcs_Sequentials = 0;
   int counterArcs_Combinationals = 0;
@@ -8591,61 +10035,25 @@ void Circuit::buildTimingStructure() {
   // Offsets
   timingNumDummyNets = dummyNets;
 
+  // Nets connected to at least one cell pin.
+  int numNets = 0;
+  for (int n = 0; n < netlist.netNames.size(); n++)
+    if (netCellPointers[n + 1] > netCellPointers[n]) numNets++;
+
   // Resize vectors appropriately.
-  timingNets.resize(dummyNets + (nets.size() - 1));  // -1 discount clock net
-  timingNetLambdaDelaySensitivity.resize(timingNets.size());
+  timingNets.resize(dummyNets + (numNets - 1));  // -1 discount clock net
 
   timingArcs.resize(counterArcs);
-  timingArcLambdaDelaySensitivity.resize(timingArcs.size());
 
   timingArcPointers.resize(timingNets.size() + 1);
   timingArcPointers.back() = timingOffsetToExtraSequentialArcs;
 
-  timingNetName.resize(timingNets.size());
-  timingMaxLoad.resize(timingNets.size());
-
-  timingArcDriverPinName.resize(timingArcs.size());
-  timingArcSinkPinName.resize(timingArcs.size());
-
-  timingStateCurrent.arcs.resize(timingArcs.size());
-  timingStateCurrent.nets.resize(timingNets.size());
-
-  // Setup timing of dummy nets of input drivers.
-  assert(dummyNets - 1 == graphRoot.nextCells.size());
-
-  for (int i = 0; i < dummyNets - 1; i++) {
-    TimingNetState &netstate = getTimingNetState(i);
-
-    const Vcell *cell = graphRoot.nextCells[i];
-    const LibParserTimingInfo &timingInfo = cell->actualInstType->timingArcs[0];
-
-    netstate.slew[RISE] = cell->inputSlews[0].first;
-    netstate.slew[FALL] = cell->inputSlews[0].second;
-
-    netstate.arrivalTime[RISE] = sdcInfos.inputDelays[i].delay;
-    netstate.arrivalTime[FALL] = sdcInfos.inputDelays[i].delay;
-
-    netstate.arrivalTime[RISE] -=
-        lookup(timingInfo.riseDelay, 0, netstate.slew[RISE]);
-    netstate.arrivalTime[FALL] -=
-        lookup(timingInfo.fallDelay, 0, netstate.slew[FALL]);
-  }  // end for
-
-  // Setup timing of the dummy net of sequantial cells.
-  {
-    TimingNetState &netstate = getTimingNetState(dummyNets - 1);
-    netstate.slew =
-        EdgeArray<double>(0, 0);  // [ISPD CONTEST] Output slew of flip-flops
-                                  // does not depends on input slew.
-    netstate.arrivalTime = EdgeArray<double>(0, 0);
-  }  // end block
-
   // Now we sweep cells sorted by their logical depth (and kind). First
   // we got input drivers, next sequential cells (flip-flops) and then
   // combinational cells.
 
-  // Map used to map netnames to netindex in timing structure.
-  map<string, int> netMap;
+  // Timing net index of each netlist net.
+  timingNetIndexes.assign(netlist.netNames.size(), -1);
 
   int indexNet = timingNumDummyNets;
   int indexArc = 0;
@@ -8660,35 +10068,26 @@ void Circuit::buildTimingStructure() {
     for (int i = 0; i < pins.size(); i++) {
       const LibParserPinInfo &pininfo = pins[i];
       if (!pininfo.isInput) {
-        string sinkNet = cell->returnNetConnectedToPin(pininfo.name);
-        assert(sinkNet != "");
+        const int sinkNet = cell->findNetConnectedToPin(netlist, pininfo.name);
+        assert(sinkNet != -1);
 
-        netMap[sinkNet] = indexNet;
-        timingNetName[indexNet] = sinkNet;
+        timingNetIndexes[sinkNet] = indexNet;
         timingArcPointers[indexNet] = indexArc;
 
         TimingNet &net = timingNets[indexNet];
         net.depth = cell->logicalDepth;
         net.driver = cell;
 
-        TimingNetState &netstate = getTimingNetState(indexNet);
-        netstate.load = cell->actualLoad;
-
-        timingMaxLoad[indexNet] = pininfo.maxCapacitance;
-
         const vector<LibParserTimingInfo> &arcs =
             cell->actualInstType->timingArcs;
         for (int k = 0; k < arcs.size(); k++) {
-          if (pininfo.name == arcs[k].toPin) {
+          if (arcs[k].toPinIndex == i) {
             TimingArc &arc = timingArcs[indexArc];
             arc.cell = cell;
             arc.lut = k;
             arc.pin = cell->returnPinIndex(arcs[k].fromPin);
             arc.sink = indexNet;
 
-            timingArcDriverPinName[indexArc] = arcs[k].fromPin;
-            timingArcSinkPinName[indexArc] = arcs[k].toPin;
-
             if (cell->logicalDepth == 0) {
               if (counterDummyNets >= dummyNets - 1) {
                 arc.driver = dummyNets - 1;  // clock dummy net index
@@ -8700,8 +10099,7 @@ void Circuit::buildTimingStructure() {
 
               counterDummyNets++;
             } else {
-              arc.driver =
-                  netMap[cell->returnNetConnectedToPin(arcs[k].fromPin)];
+              arc.driver = findTimingNet(cell, arcs[k].fromPin);
               assert(!cell->actualInstType->isSequential);
               assert(cell->instName != "inputDriver");
             }  // end else
@@ -8713,10 +10111,6 @@ void Circuit::buildTimingStructure() {
           }  // end if
         }    // end for
 
-        // [WARNING][TODO] The following statement is assuming a cell has only
-        // one output.
-        cell->sinkNetIndex = indexNet;
-
         indexNet++;
       }  // end if
     }    // end for
@@ -8735,23 +10129,16 @@ void Circuit::buildTimingStructure() {
     for (int i = 0; i < pins.size(); i++) {
       const LibParserPinInfo &pininfo = pins[i];
       if (pininfo.isInput && !pininfo.isClock) {
-        map<string, int>::iterator it =
-            netMap.find(cell->returnNetConnectedToPin(pininfo.name));
-        assert(it != netMap.end());
+        const int driver = findTimingNet(cell, pininfo.name);
+        assert(driver != -1);
 
         TimingArc &arc = timingArcs[indexArc];
-        arc.driver = it->second;
+        arc.driver = driver;
         arc.sink = -1;
         arc.lut = -1;
         arc.pin = i;
         arc.cell = cell;
 
-        TimingArcState &arcstate = getTimingArcState(indexArc);
-        arcstate.delay.set(0, 0);
-        arcstate.rcdelay.set(0, 0);
-
-        timingArcDriverPinName[indexArc] = pininfo.name;
-
         indexArc++;
         counter++;
       }  // end if
@@ -8768,10 +10155,8 @@ void Circuit::buildTimingStructure() {
     const string netName = p.first;
     Vcell *netDriver = p.second;
 
-    map<string, int>::iterator it = netMap.find(netName);
-    assert(it != netMap.end());
-
-    const int netIndex = it->second;
+    const int netIndex = findTimingNet(netName);
+    assert(netIndex != -1);
 
     TimingArc &arc = timingArcs[indexArc++];
     arc.driver = netIndex;
@@ -8862,21 +10247,6 @@ void Circuit::buildTimingStructure() {
 
   timingDriverNetPointers.back() = timingDriverNets.size();
 
-  // Setup input slew and arrival time for arcs belonging to dummy nets.
-  for (int i = 0; i < dummyNets; i++) {
-    const TimingNetState &netstate = getTimingNetState(i);
-
-    const int k0 = timingSinkArcPointers[i];
-    const int k1 = timingSinkArcPointers[i + 1];
-    for (int k = k0; k < k1; k++) {
-      // Update arc timings.
-      TimingArcState &arcstate = getTimingArcState(timingSinkArcs[k]);
-
-      arcstate.arrivalTime = netstate.arrivalTime;
-      arcstate.islew = netstate.slew;
-    }  // end for
-  }    // end for
-
   // Find out tail nets -- the ones driving a sequential element or a primary
   // output.
   multiset<string> tailNets;
@@ -8889,7 +10259,7 @@ void Circuit::buildTimingStructure() {
       for (int i = 0; i < pins.size(); i++) {
         const LibParserPinInfo &pininfo = pins[i];
         if (pininfo.isInput && !pininfo.isClock) {
-          string netname = cell->returnNetConnectedToPin(pininfo.name);
+          string netname = cell->returnNetConnectedToPin(netlist, pininfo.name);
           tailNets.insert(netname);
         }  // end if
       }    // end for
@@ -8907,30 +10277,18 @@ void Circuit::buildTimingStructure() {
     const string netname = *it;
 
     if (previousNetname != netname) {
-      map<string, int>::iterator itm = netMap.find(netname);
-      assert(itm != netMap.end());
+      const int netIndex = findTimingNet(netname);
+      assert(netIndex != -1);
 
       previousNetname = netname;
 
-      timingTailNets.push_back(itm->second);
+      timingTailNets.push_back(netIndex);
       timingTailNetMultiplicities.push_back(1);
     } else {
       timingTailNetMultiplicities.back()++;
     }  // end else
   }    // end for
 
-  // Setup initial lambda values;
-  for (int i = 0; i < timingArcs.size(); i++) {
-    getTimingArcState(i).lambda.set(1, 1);
-  }
-
-  // Setup safe input slew and ceff values.
-  for (int i = timingOffsetToCombinationArcs; i < timingArcs.size(); i++) {
-    TimingArcState &state = getTimingArcState(i);
-    state.islew.set(0, 0);
-    state.ceff.set(0, 0);
-  }  // end for
-
   // Find offset to level nets.
   timingOffsetToNetLevel.resize((maxLogicalDepth + 1) + 1,
                                 -1);  // +1 to store a dummy offset
@@ -8946,96 +10304,148 @@ void Circuit::buildTimingStructure() {
 
 #ifndef NDEBUG
   if (indexNet != timingNets.size()) {
-    cerr << "[BUG] @ Circuit::buildTimingStructure() - "
+    cerr << "[BUG] @ Circuit::buildTimingGraph() - "
          << "Divergent number of nets. Expected " << (timingNets.size())
          << " got " << indexNet << ".\n";
   }  // end if
 
   if (indexArc != timingArcs.size()) {
-    cerr << "[BUG] @ Circuit::buildTimingStructure() - "
+    cerr << "[BUG] @ Circuit::buildTimingGraph() - "
          << "Divergent number of arcs. Expected " << timingArcs.size()
          << " got " << indexArc << ".\n";
   }  // end if
+#endif
+}  // end method
 
-  // Check if all timingNets have been correctly initialized.
-  for (int i = timingNumDummyNets; i < timingNets.size(); i++) {
-    const TimingNet &net = timingNets[i];
+// -----------------------------------------------------------------------------
 
-    if (!net.driver)
-      cerr << "[BUG] @ Circuit::buildTimingStructure() - Net " << i
-           << " has no driver.\n";
+// Sets up the timing state, net and pin names and max loads, which are not
+// part of the snapshot.
+void Circuit::initializeTimingGraphState() {
+  const int dummyNets = timingNumDummyNets;
 
-    if (net.depth == -1)
-      cerr << "[BUG] @ Circuit::buildTimingStructure() - Net " << i
-           << " has invalid depth.\n";
-  }  // end for
+  timingNetLambdaDelaySensitivity.resize(timingNets.size());
+  timingArcLambdaDelaySensitivity.resize(timingArcs.size());
 
-  // Check if tail nets match with nets driven by tail cells.
-  for (int i = 0; i < pathTails.size(); i++) {
-    const int n = pathTails[i]->sinkNetIndex;
+  timingNetName.assign(timingNets.size(), "");
+  timingMaxLoad.assign(timingNets.size(), 0);
 
-    bool found = false;
-    for (int k = 0; k < timingTailNets.size(); k++) {
-      if (n == timingTailNets[k]) {
-        found = true;
-        break;
-      }  // end if
-    }    // end for
+  timingArcDriverPinName.assign(timingArcs.size(), "");
+  timingArcSinkPinName.assign(timingArcs.size(), "");
 
-    if (!found)
-      cerr << "[BUG] @ Circuit::buildTimingStructure() - Net " << n
-           << " should be in tail net list.\n";
+  timingStateCurrent.arcs.resize(timingArcs.size());
+  timingStateCurrent.nets.resize(timingNets.size());
+
+  // Setup timing of dummy nets of input drivers.
+  assert(dummyNets - 1 == graphRoot.nextCells.size());
+
+  for (int i = 0; i < dummyNets - 1; i++) {
+    TimingNetState netstate = getTimingNetState(i);
+
+    const Vcell *cell = graphRoot.nextCells[i];
+    const LibParserTimingInfo &timingInfo = cell->actualInstType->timingArcs[0];
+
+    netstate.slew[RISE] = cell->inputSlews[0].first;
+    netstate.slew[FALL] = cell->inputSlews[0].second;
+
+    netstate.arrivalTime[RISE] = sdcInfos.inputDelays[i].delay;
+    netstate.arrivalTime[FALL] = sdcInfos.inputDelays[i].delay;
+
+    netstate.arrivalTime[RISE] -=
+        lookup(timingInfo.riseDelay, 0, netstate.slew[RISE]);
+    netstate.arrivalTime[FALL] -=
+        lookup(timingInfo.fallDelay, 0, netstate.slew[FALL]);
   }  // end for
 
-  // Check if tail nets are driving by a tail cell.
-  for (int i = 0; i < timingTailNets.size(); i++) {
-    const Vcell *driver = timingNets[timingTailNets[i]].driver;
+  // Setup timing of the dummy net of sequantial cells.
+  {
+    TimingNetState netstate = getTimingNetState(dummyNets - 1);
+    netstate.slew =
+        EdgeArray<double>(0, 0);  // [ISPD CONTEST] Output slew of flip-flops
+                                  // does not depends on input slew.
+    netstate.arrivalTime = EdgeArray<double>(0, 0);
+  }  // end block
 
-    // cerr << "\tNet " << i << "\t" << driver->instName << " (" <<
-    // driver->instType << ")\n";
+  for (int n = 0; n < netlist.netNames.size(); n++)
+    if (timingNetIndexes[n] != -1)
+      timingNetName[timingNetIndexes[n]] = netlist.netNames.getString(n);
 
-    bool found = false;
-    for (int k = 0; k < pathTails.size(); k++) {
-      if (driver == pathTails[k]) {
-        found = true;
+  const int numNets = timingNets.size();
+  for (int i = dummyNets; i < numNets; i++) {
+    Vcell *cell = timingNets[i].driver;
+
+    // [WARNING][TODO] The following statement is assuming a cell has only
+    // one output.
+    cell->sinkNetIndex = i;
+
+    TimingNetState netstate = getTimingNetState(i);
+    netstate.load = cell->actualLoad;
+
+    const vector<LibParserPinInfo> &pins = cell->actualInstType->pins;
+    const int numPins = pins.size();
+    for (int k = 0; k < numPins; k++) {
+      if (!pins[k].isInput) {
+        timingMaxLoad[i] = pins[k].maxCapacitance;
         break;
       }  // end if
     }    // end for
+  }      // end for
 
-    if (!found)
-      cerr << "[BUG] @ Circuit::buildTimingStructure() - Cell "
-           << driver->instName << " (" << driver->instType
-           << ") should be in tail net list.\n";
+  for (int i = 0; i < timingOffsetToExtraSequentialArcs; i++) {
+    const TimingArc &arc = timingArcs[i];
+    const LibParserTimingInfo &info =
+        arc.cell->actualInstType->timingArcs[arc.lut];
+    timingArcDriverPinName[i] = info.fromPin;
+    timingArcSinkPinName[i] = info.toPin;
   }  // end for
 
-  // Check if fanout matches the nextNum property in Vcell.
-  for (int i = timingNumDummyNets; i < timingNets.size(); i++) {
-    const TimingNet &net = timingNets[i];
+  for (int i = timingOffsetToExtraSequentialArcs;
+       i < timingOffsetToExtraPrimaryOutputArcs; i++) {
+    const TimingArc &arc = timingArcs[i];
 
-    if (net.fanout != net.driver->nextNum) {
-      cerr << "[BUG] @ Circuit::buildTimingStructure() - Divergent fanout "
-              "numbers for net "
-           << timingNetName[i] << " and its driver.\n"
-           << "\tNet Fanout.........: " << net.fanout << "\t"
-           << timingNetName[i] << "\n"
-           << "\tNet's Driver Fanout: " << net.driver->nextNum << "("
-           << net.driver->nextCells.size() << ") "
-           << "\t" << net.driver->instName << " (" << net.driver->instType
-           << ")"
-           << "\n";
-    }  // end if
+    TimingArcState arcstate = getTimingArcState(i);
+    arcstate.delay.set(0, 0);
+    arcstate.rcdelay.set(0, 0);
+
+    timingArcDriverPinName[i] = arc.cell->actualInstType->pins[arc.pin].name;
+  }  // end for
+
+  // Setup input slew and arrival time for arcs belonging to dummy nets.
+  for (int i = 0; i < dummyNets; i++) {
+    const TimingNetState &netstate = getTimingNetState(i);
+
+    const int k0 = timingSinkArcPointers[i];
+    const int k1 = timingSinkArcPointers[i + 1];
+    for (int k = k0; k < k1; k++) {
+      // Update arc timings.
+      TimingArcState arcstate = getTimingArcState(timingSinkArcs[k]);
+
+      arcstate.arrivalTime = netstate.arrivalTime;
+      arcstate.islew = netstate.slew;
+    }  // end for
   }    // end for
 
-#endif
+  // Setup initial lambda values;
+  for (int i = 0; i < timingArcs.size(); i++) {
+    getTimingArcState(i).lambda.set(1, 1);
+  }
 
+  // Setup safe input slew and ceff values.
+  for (int i = timingOffsetToCombinationArcs; i < timingArcs.size(); i++) {
+    TimingArcState state = getTimingArcState(i);
+    state.islew.set(0, 0);
+    state.ceff.set(0, 0);
+  }  // end for
 }  // end method
 
 // -----------------------------------------------------------------------------
 
 void Circuit::buildTreeStructure() {
-  map<string, int> mapNodesToArcIndexes;
-  map<string, int> mapNodesToTreeDescriptorIndexes;
-  map<string, int>::const_iterator it;
+  // RC tree node names are interned once. Each node id maps to the timing
+  // arc and to the tree descriptor the node belongs to (-1 if none).
+  NameTable nodeNames;
+  vector<int> nodeArcs;
+  vector<int> nodeTrees;
 
   const int numArcs = timingArcs.size();
   const int numTrees = timingTreeDescriptors.size();
@@ -9043,20 +10453,29 @@ void Circuit::buildTreeStructure() {
 
   // assert( (numNets-timingOffsetToNetLevel[0]) == numTrees );
 
-  for (int i = 0; i < timingOffsetToCombinationArcs; i++) {
-    // cout << "Output Node: " << getTimingArcOutputNodeName(i) << "\n";
-    mapNodesToArcIndexes[getTimingArcOutputNodeName(i)] = i;
-  }
+  int numNodes = 0;
+  for (int i = 0; i < numTrees; i++)
+    numNodes += timingTreeDescriptors[i].getNumNodes();
+  nodeNames.reserve(numNodes, 16 * (size_t)numNodes);
+  nodeArcs.reserve(numNodes);
+  nodeTrees.reserve(numNodes);
 
-  for (int i = timingOffsetToCombinationArcs; i < numArcs; i++) {
-    // cout << "Input Node: " << getTimingArcInputNodeName(i) << "\n";
-    mapNodesToArcIndexes[getTimingArcInputNodeName(i)] = i;
-  }
+  for (int i = 0; i < numArcs; i++) {
+    const string nodeName = i < timingOffsetToCombinationArcs
+                                ? getTimingArcOutputNodeName(i)
+                                : getTimingArcInputNodeName(i);
+    const int id = nodeNames.insert(nodeName);
+    if (id == (int)nodeArcs.size()) nodeArcs.push_back(-1);
+    nodeArcs[id] = i;
+  }  // end for
 
+  nodeTrees.assign(nodeArcs.size(), -1);
   for (int i = 0; i < numTrees; i++) {
     const RCTreeDescriptor &tree = timingTreeDescriptors[i];
     for (int k = 0; k < tree.getNumNodes(); k++) {
-      mapNodesToTreeDescriptorIndexes[tree.getNode(k).propName] = i;
+      const int id = nodeNames.insert(tree.getNode(k).propName);
+      if (id == (int)nodeTrees.size()) nodeTrees.push_back(-1);
+      nodeTrees[id] = i;
     }  // end for
   }    // end for
 
@@ -9073,13 +10492,13 @@ void Circuit::buildTreeStructure() {
                                  ? timingNetName[i]
                                  : net.driver->instName + ":" + outputPin.name;
 
-    it = mapNodesToTreeDescriptorIndexes.find(nodeName);
+    const int id = nodeNames.find(nodeName);
 
-    if (it == mapNodesToTreeDescriptorIndexes.end()) {
+    if (id == -1 || nodeTrees[id] == -1) {
       cout << "[BUG] @ buildTreeStructure - Net " << timingNetName[i]
            << " has no tree associated.\n";
     } else {  // end if
-      RCTreeDescriptor &dscp = timingTreeDescriptors[it->second];
+      RCTreeDescriptor &dscp = timingTreeDescriptors[nodeTrees[id]];
 
       const int k0 = timingSinkArcPointers[i];
       const int k1 = timingSinkArcPointers[i + 1];
@@ -9108,15 +10527,14 @@ void Circuit::buildTreeStructure() {
 
     timingTreeNodePointers[i] = timingTreeNodes.size();
 
-    const int numNodes = tree.getNumNodes();
-    for (int k = 0; k < numNodes; k++) {
+    const int numTreeNodes = tree.getNumNodes();
+    for (int k = 0; k < numTreeNodes; k++) {
       if (tree.getNodeTag(k) == "sink") {
-        const string &nodeName = tree.getNodeName(k);
-        timingArcs[it->second].node = k;
-        it = mapNodesToArcIndexes.find(nodeName);
-        assert(it != mapNodesToArcIndexes.end());
-        timingTreeNodes.push_back(TreeNodePointer(it->second, k));
-      } else if (tree.getNode(k).propEndpoint) {
+        const int id = nodeNames.find(tree.getNodeName(k));
+        assert(id != -1 && id < (int)nodeArcs.size() && nodeArcs[id] != -1);
+        timingArcs[nodeArcs[id]].node = k;
+        timingTreeNodes.push_back(TreeNodePointer(nodeArcs[id], k));
+      } else if (tree.isEndpoint(k)) {
         cout << "[BUG] @ buildTreeStructure - Node '" << tree.getNodeName(k)
              << "' is a RC tree endpoint, but it is not a tree sink.\n";
       }  // end else-if
@@ -9124,7 +10542,7 @@ void Circuit::buildTreeStructure() {
   }      // end for
   timingTreeNodePointers.back() = timingTreeNodes.size();
 
-  timingTreeDescriptors.clear();
+  vector<RCTreeDescriptor>().swap(timingTreeDescriptors);
 }  // end method
 
 // -----------------------------------------------------------------------------
@@ -9132,51 +10550,103 @@ void Circuit::buildTreeStructure() {
 #ifdef PARALLEL
 
 void Circuit::setupMultithreading(const int numThreads) {
-  threadNumThreads =
-      numThreads == 0 ? Poco::Environment::processorCount() : numThreads;
+  threadNumThreads = numThreads == 0
+                         ? max(1, (int)std::thread::hardware_concurrency())
+                         : numThreads;
 
   cout << "Multithreading: Setting up the thread pool to " << threadNumThreads
        << " threads.\n";
-  myThreadPool.addCapacity(max(0, threadNumThreads - myThreadPool.capacity()));
+  threadPool.resize(threadNumThreads);
 
-  timingViolationSlewVector.resize(threadNumThreads, 0);
+  timingOverlays.resize(threadNumThreads);
 
-  threadNetPointers.resize(maxLogicalDepth + 1);
-  for (int i = 0; i < threadNetPointers.size(); i++)
-    threadNetPointers[i].resize(threadNumThreads + 1);
+  // Slot 0 plus one slot per net, which covers the cells of
+  // timingPseudIndependentSets too.
+  const int numNets = timingNets.size();
+  timingViolationSlots.resize(1 + numNets);
+  sizingTotalsSlots.resize(1 + numNets);
+
+  // Estimated cost to update a net. Each driver arc runs one simulation over
+  // the net RC tree.
+  vector<double> cost(numNets, 0);
+  for (int n = timingNumDummyNets; n < numNets; n++) {
+    const int numArcs = timingArcPointers[n + 1] - timingArcPointers[n];
+    cost[n] = max(1, numArcs) * max(1, timingTrees[n].getNumNodes());
+  }  // end for
 
-  const int minNumNetsPerThread = 1;
+  // Split each level in chunks of about the same cost. Some extra chunks per
+  // thread give room to the work-stealing pool to balance the load.
+  const int numChunksPerThread = 4;
 
+  threadNetPointers.resize(maxLogicalDepth + 1);
   for (int depth = 0; depth <= maxLogicalDepth; depth++) {
     const int k0 = timingOffsetToNetLevel[depth];
     const int k1 = timingOffsetToNetLevel[depth + 1];
 
-    const int numNetsAtThisLevel = k1 - k0;
-    const int numNetsPerThread = numNetsAtThisLevel / threadNumThreads;
+    double levelCost = 0;
+    for (int n = k0; n < k1; n++) levelCost += cost[n];
 
-    int offset = timingOffsetToNetLevel[depth];
-    for (int t = 0; t < threadNumThreads - 1; t++) {
-      threadNetPointers[depth][t] = offset;
-      offset += numNetsPerThread;
-    }  // end for
+    const int maxNumChunks = min(k1 - k0, threadNumThreads * numChunksPerThread);
+    const double chunkCost = levelCost / max(1, maxNumChunks);
+
+    vector<int> &pointers = threadNetPointers[depth];
+    pointers.clear();
+    pointers.push_back(k0);
 
-    threadNetPointers[depth][threadNumThreads - 1] = offset;
-    threadNetPointers[depth][threadNumThreads] =
-        timingOffsetToNetLevel[depth] + numNetsAtThisLevel;
+    double accumulatedCost = 0;
+    for (int n = k0; n < k1; n++) {
+      accumulatedCost += cost[n];
+      if (accumulatedCost >= chunkCost && n + 1 < k1) {
+        pointers.push_back(n + 1);
+        accumulatedCost = 0;
+      }  // end if
+    }    // end for
 
+    pointers.push_back(k1);
   }  // end for
 
-  threadWorkers.resize(maxLogicalDepth + 1);
-  for (int depth = 0; depth <= maxLogicalDepth; depth++) {
-    threadWorkers[depth].resize(threadNumThreads);
+  // Sets sized concurrently by sizingLagrangeRelaxationParallel(). Sizing a
+  // cell updates all of its local nets once per candidate.
+  computePseudoIndependentSets();
 
-    for (int i = 0; i < threadNumThreads; i++) {
-      const int n0 = threadNetPointers[depth][i];
-      const int n1 = threadNetPointers[depth][i + 1];
+  sizingThreadScratch.resize(threadNumThreads);
+
+  threadSetPointers.resize(timingNumPseudoIndependentSets);
+  for (int set = 0; set < timingNumPseudoIndependentSets; set++) {
+    const int k0 = timingPseudIndependentSetPointers[set];
+    const int k1 = timingPseudIndependentSetPointers[set + 1];
 
-      threadWorkers[depth][i].setup(this, n0, n1, i);
+    vector<double> localCost(k1 - k0, 0);
+    double setCost = 0;
+    for (int k = k0; k < k1; k++) {
+      const int n = timingPseudIndependentSets[k];
+      const int l0 = timingLocalNetPointers[n];
+      const int l1 = timingLocalNetPointers[n + 1];
+      for (int l = l0; l < l1; l++)
+        localCost[k - k0] += cost[timingLocalNets[l]];
+      setCost += localCost[k - k0];
     }  // end for
-  }    // end for
+
+    const int maxNumChunks = min(k1 - k0, threadNumThreads * numChunksPerThread);
+    const double chunkCost = setCost / max(1, maxNumChunks);
+
+    vector<int> &pointers = threadSetPointers[set];
+    pointers.clear();
+    pointers.push_back(k0);
+
+    double accumulatedCost = 0;
+    for (int k = k0; k < k1; k++) {
+      accumulatedCost += localCost[k - k0];
+      if (accumulatedCost >= chunkCost && k + 1 < k1) {
+        pointers.push_back(k + 1);
+        accumulatedCost = 0;
+      }  // end if
+    }    // end for
+
+    pointers.push_back(k1);
+  }  // end for
+
+  setupTaskGraph();
 
 #ifndef NDEBUG
 
@@ -9188,11 +10658,11 @@ void Circuit::setupMultithreading(const int numThreads) {
    timingOffsetToNetLevel[depth] << "\t" << timingOffsetToNetLevel[depth+1] <<
    "\n";
 
-   for (int t = 0; t < threadNumThreads; t++ ) {
+   for (int t = 0; t + 1 < threadNetPointers[depth].size(); t++ ) {
    const int k0 = threadNetPointers[depth][t];
    const int k1 = threadNetPointers[depth][t+1];
 
-   cerr << "\tThread " << t << "\t" << k0 << "\t" << k1 << "\n";
+   cerr << "\tChunk " << t << "\t" << k0 << "\t" << k1 << "\n";
    }
    }
    */
@@ -9203,7 +10673,8 @@ void Circuit::setupMultithreading(const int numThreads) {
   int previousNetIndex = 0;
 
   for (int depth = 0; depth <= maxLogicalDepth; depth++) {
-    for (int i = 0; i < threadNumThreads; i++) {
+    const int numChunks = threadNetPointers[depth].size() - 1;
+    for (int i = 0; i < numChunks; i++) {
       const int n0 = threadNetPointers[depth][i];
       const int n1 = threadNetPointers[depth][i + 1];
 
@@ -9249,6 +10720,48 @@ void Circuit::setupMultithreading(const int numThreads) {
 
 }  // end method
 
+// -----------------------------------------------------------------------------
+
+void Circuit::setupTaskGraph() {
+  const int numNets = timingNets.size();
+
+  threadTaskNumTasks = numNets - timingNumDummyNets;
+  threadTaskInDegree.assign(numNets, 0);
+  threadTaskRoots.clear();
+
+  for (int i = timingNumDummyNets; i < numNets; i++) {
+    const int k0 = timingDriverNetPointers[i];
+    const int k1 = timingDriverNetPointers[i + 1];
+    for (int k = k0; k < k1; k++) {
+      if (timingDriverNets[k] >= timingNumDummyNets) threadTaskInDegree[i]++;
+    }  // end for
+
+    if (threadTaskInDegree[i] == 0) threadTaskRoots.push_back(i);
+  }  // end for
+
+  threadTaskPendingDrivers.reset(new std::atomic<int>[numNets]);
+
+#ifndef NDEBUG
+  // Every driver net must release its sink nets, otherwise the update would
+  // wait forever on a net.
+  vector<int> releases(numNets, 0);
+  for (int i = timingNumDummyNets; i < numNets; i++) {
+    const int k0 = timingSinkNetPointers[i];
+    const int k1 = timingSinkNetPointers[i + 1];
+    for (int k = k0; k < k1; k++) releases[timingSinkNets[k]]++;
+  }  // end for
+
+  for (int i = timingNumDummyNets; i < numNets; i++) {
+    if (releases[i] != threadTaskInDegree[i]) {
+      cerr << "[BUG] @ Circuit::setupTaskGraph() - "
+           << "Net " << i << " has " << threadTaskInDegree[i]
+           << " driver nets, but is released " << releases[i] << " times.\n";
+    }  // end if
+  }    // end for
+#endif
+
+}  // end method
+
 #endif
 
 // -----------------------------------------------------------------------------
@@ -9306,6 +10819,8 @@ void Circuit::setupMultithreading(const int numThreads) {
 // -----------------------------------------------------------------------------
 
 void Circuit::updateTiming() {
+  timingRequiredTimeOutdated = true;
+
 #ifdef PARALLEL
   updateTimingMultiThreaded();
 #else
@@ -9318,32 +10833,66 @@ void Circuit::updateTiming() {
 void Circuit::updateTimingSingleThreaded() {
   // Combinational cells.
   const int numNets = timingNets.size();
-  for (int i = timingNumDummyNets; i < numNets; i++) updateTiming_Net(i);
+  for (int i = timingNumDummyNets; i < numNets; i++) updateTiming_Net(i);
+
+  updateTiming_WorstArrivalTime();  // compute the worst arrival time
+  updateTiming_Violations();        // reduce pending violations.
+  updateTiming_Deprecated();        // keep old stuffs up-to-date.
+
+#ifndef NDEBUG
+  updateTiming_Debug();
+#endif
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+#ifdef PARALLEL
+
+void Circuit::updateTimingMultiThreaded() {
+  // Reset dependency counters.
+  const int numNets = timingNets.size();
+  for (int i = timingNumDummyNets; i < numNets; i++)
+    threadTaskPendingDrivers[i].store(threadTaskInDegree[i],
+                                      std::memory_order_relaxed);
+
+  // Nets driven only by dummy nets (level 0) are ready right away. Spread
+  // them over the threads, the remaining nets are released by their drivers.
+  const int numRoots = threadTaskRoots.size();
+  for (int i = 0; i < numRoots; i++) {
+    const int n = threadTaskRoots[i];
+    threadPool.push((int)(((long long)i * threadNumThreads) / numRoots), n,
+                    n + 1);
+  }  // end for
+
+  threadPool.run(threadTaskNumTasks,
+                 [this](const int threadId, const int n0, const int n1) {
+                   for (int n = n0; n < n1; n++)
+                     updateTiming_TaskGraph(threadId, n);
+                 });
 
   updateTiming_WorstArrivalTime();  // compute the worst arrival time
-  updateTiming_SlewViolation();     // thread-safe slew violation update.
+  updateTiming_Violations(timingNumDummyNets, numNets);
   updateTiming_Deprecated();        // keep old stuffs up-to-date.
 
 #ifndef NDEBUG
   updateTiming_Debug();
 #endif
+
 }  // end method
 
 // -----------------------------------------------------------------------------
 
-#ifdef PARALLEL
+void Circuit::updateTimingMultiThreadedLevelized() {
+  const ThreadPool::Task task = [this](const int /*threadId*/, const int n0,
+                                       const int n1) {
+    updateTiming_Nets(n0, n1);
+  };
 
-void Circuit::updateTimingMultiThreaded() {
-  for (int depth = 0; depth <= maxLogicalDepth; depth++) {
-    for (int i = 0; i < threadNumThreads; i++) {
-      myThreadPool.start(threadWorkers[depth][i]);
-      myThreadPool.joinAll();
-    }
-    myThreadPool.joinAll();
-  }  // end for
+  for (int depth = 0; depth <= maxLogicalDepth; depth++)
+    threadPool.parallelFor(threadNetPointers[depth], task);
 
   updateTiming_WorstArrivalTime();  // compute the worst arrival time
-  updateTiming_SlewViolation();     // thread-safe slew violation update.
+  updateTiming_Violations(timingNumDummyNets, timingNets.size());
   updateTiming_Deprecated();        // keep old stuffs up-to-date.
 
 #ifndef NDEBUG
@@ -9356,68 +10905,118 @@ void Circuit::updateTimingMultiThreaded() {
 
 // -----------------------------------------------------------------------------
 
+void Circuit::startTimingFrontier() {
+  const int numNets = timingNets.size();
+  const int numLevels = max(0, timingNets.back().depth) + 1;
+
+  if ((int)timingFrontierStamp.size() != numNets) {
+    timingFrontierStamp.assign(numNets, -1);
+    timingFrontierCurrentStamp = -1;
+  }  // end if
+  if ((int)timingFrontier.size() != numLevels)
+    timingFrontier.resize(numLevels);
+
+  timingFrontierCurrentStamp++;
+  timingFrontierMinDepth = numLevels;
+  timingFrontierMaxDepth = -1;
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::pushTimingFrontier(const int n) {
+  if (timingFrontierStamp[n] == timingFrontierCurrentStamp) return;
+  timingFrontierStamp[n] = timingFrontierCurrentStamp;
+
+  const int depth = timingNets[n].depth;
+  assert(depth >= 0);
+
+  timingFrontier[depth].push_back(n);
+  timingFrontierMinDepth = min(timingFrontierMinDepth, depth);
+  timingFrontierMaxDepth = max(timingFrontierMaxDepth, depth);
+}  // end method
+
+// -----------------------------------------------------------------------------
+
 void Circuit::updateTiming(Vcell *cell) {
-  typedef pair<int, int> T;
-  priority_queue<T, vector<T>, greater<T> > queue;
+  startTimingFrontier();
+  timingFrontierUpdatedNets.clear();
 
-  // Update all timing arcs driving the seed net.
+  // Seeds: nets driving the cell, whose load has changed. Their sink nets
+  // are always updated.
   const int k0 = timingArcPointers[cell->sinkNetIndex];
   const int k1 = timingArcPointers[cell->sinkNetIndex + 1];
   for (int k = k0; k < k1; k++) {
-    const TimingArc &arc = timingArcs[k];
-    // [TODO] I think this if is not necessary anymore as now we have dummy
-    // arcs. Remove it after the contest.
-    if (arc.driver != -1) {
-      const int n = arc.driver;
+    const int n = timingArcs[k].driver;
+    if (n >= timingNumDummyNets) {
+      pushTimingFrontier(n);
+    } else {
+      // Dummy nets have no depth, so they are handled here.
       updateTiming_Net(n);
+      timingFrontierUpdatedNets.push_back(n);
 
-      // [TODO] Avoid queuing more than once!
-      // Put all sink nets in the queue.
-      const int k0 = timingSinkNetPointers[n];
-      const int k1 = timingSinkNetPointers[n + 1];
-      for (int k = k0; k < k1; k++) {
-        const int sink = timingSinkNets[k];
-        queue.push(make_pair(timingNets[sink].depth, sink));
-      }  // end for
-    }    // end if
-  }      // end for
-
-  // Propagate arrival times.
-  while (!queue.empty()) {
-    const int n = queue.top().second;
-    queue.pop();
+      const int s0 = timingSinkNetPointers[n];
+      const int s1 = timingSinkNetPointers[n + 1];
+      for (int s = s0; s < s1; s++) pushTimingFrontier(timingSinkNets[s]);
+    }  // end else
+  }    // end for
 
-    const TimingNet &net = timingNets[n];
-    const TimingNetState &netstate = getTimingNetState(n);
+  // Propagate arrival times. Nets only push nets in deeper levels, so the
+  // sweep ends as soon as changes stop propagating.
+  for (int depth = timingFrontierMinDepth; depth <= timingFrontierMaxDepth;
+       depth++) {
+    vector<int> &bucket = timingFrontier[depth];
+    const int numBucketNets = bucket.size();
+    for (int i = 0; i < numBucketNets; i++) {
+      const int n = bucket[i];
 
-    assert(net.depth > 0);
+      const TimingNetState &netstate = getTimingNetState(n);
 
-    const EdgeArray<double> previousSlew = netstate.slew;
-    const EdgeArray<double> previousArrivalTime = netstate.arrivalTime;
+      const EdgeArray<double> previousSlew = netstate.slew;
+      const EdgeArray<double> previousArrivalTime = netstate.arrivalTime;
 
-    updateTiming_Net(n);
+      updateTiming_Net(n);
+      timingFrontierUpdatedNets.push_back(n);
+
+      const EdgeArray<double> deltaSlew = netstate.slew - previousSlew;
+      const EdgeArray<double> deltaArrivalTime =
+          netstate.arrivalTime - previousArrivalTime;
+
+      bool seed = false;
+      for (int k = k0; k < k1 && !seed; k++) seed = timingArcs[k].driver == n;
+
+      // If there are some change at timing values propagate...
+      if (seed || !nearlyZero(deltaSlew[FALL]) ||
+          !nearlyZero(deltaSlew[RISE]) ||
+          !nearlyZero(deltaArrivalTime[FALL]) ||
+          !nearlyZero(deltaArrivalTime[RISE])) {
+        // Put all sink nets in the frontier.
+        const int s0 = timingSinkNetPointers[n];
+        const int s1 = timingSinkNetPointers[n + 1];
+        for (int s = s0; s < s1; s++) {
+          const int sink = timingSinkNets[s];
+          assert(timingNets[sink].depth > depth);
+          pushTimingFrontier(sink);
+        }  // end for
+      }    // end if
+    }      // end for
 
-    const EdgeArray<double> deltaSlew = netstate.slew - previousSlew;
-    const EdgeArray<double> deltaArrivalTime =
-        netstate.arrivalTime - previousArrivalTime;
+    bucket.clear();
+  }  // end for
 
-    // If there are some change at timing values propagate...
-    if (!nearlyZero(deltaSlew[FALL]) || !nearlyZero(deltaSlew[RISE]) ||
-        !nearlyZero(deltaArrivalTime[FALL]) ||
-        !nearlyZero(deltaArrivalTime[RISE])) {
-      // Put all sink nets in the queue.
-      const int k0 = timingSinkNetPointers[n];
-      const int k1 = timingSinkNetPointers[n + 1];
-      for (int k = k0; k < k1; k++) {
-        const int sink = timingSinkNets[k];
-        queue.push(make_pair(timingNets[sink].depth, sink));
-      }  // end for
-    }    // end if
-  }      // end while
+  if (timingRequiredTimeSeeds.size() + timingFrontierUpdatedNets.size() >
+      timingNets.size()) {
+    timingRequiredTimeSeeds.clear();
+    timingRequiredTimeOutdated = true;
+  } else {
+    timingRequiredTimeSeeds.insert(timingRequiredTimeSeeds.end(),
+                                   timingFrontierUpdatedNets.begin(),
+                                   timingFrontierUpdatedNets.end());
+  }  // end else
 
-  updateTiming_WorstArrivalTime();  // compute the worst arrival time
-  updateTiming_SlewViolation();     // thread-safe slew violation update.
-  updateTiming_Deprecated();        // keep old stuffs up-to-date.
+  // Only path ends driven by updated nets may have changed.
+  updateTiming_WorstArrivalTime(timingFrontierUpdatedNets);
+  updateTiming_Violations();  // reduce pending violations.
+  updateTiming_Deprecated();  // keep old stuffs up-to-date.
 
 #ifndef NDEBUG
   updateTiming_Debug();
@@ -9434,7 +11033,150 @@ void Circuit::updateTimingLocally(const int n) {
     updateTiming_Net(timingLocalNets[k]);
   }  // end for
 
-  updateTiming_SlewViolation();
+  updateTiming_Violations();
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::updateTimingLocally(const int n, TimingOverlay &overlay) {
+  const int k0 = timingLocalNetPointers[n];
+  const int k1 = timingLocalNetPointers[n + 1];
+  for (int k = k0; k < k1; k++) {
+    updateTiming_Net(timingLocalNets[k], overlay.violationCurrent, &overlay);
+  }  // end for
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::openTimingOverlay(TimingOverlay &overlay, const int n) {
+  const int numArcs = timingArcs.size();
+  const int numNets = timingNets.size();
+
+  if ((int)overlay.arcMap.size() != numArcs)
+    overlay.arcMap.assign(numArcs, -1);
+  if ((int)overlay.netMap.size() != numNets)
+    overlay.netMap.assign(numNets, -1);
+
+  // Clean-up previous usage.
+  const int numPreviousArcs = overlay.arcs.size();
+  for (int i = 0; i < numPreviousArcs; i++)
+    overlay.arcMap[overlay.arcs[i]] = -1;
+  const int numPreviousNets = overlay.nets.size();
+  for (int i = 0; i < numPreviousNets; i++)
+    overlay.netMap[overlay.nets[i]] = -1;
+  overlay.arcs.clear();
+  overlay.nets.clear();
+
+  // updateTiming_Net() writes the net itself, its driver arcs and its sink
+  // arcs.
+  const int k0 = timingLocalNetPointers[n];
+  const int k1 = timingLocalNetPointers[n + 1];
+  for (int k = k0; k < k1; k++) {
+    const int local = timingLocalNets[k];
+
+    overlay.netMap[local] = overlay.nets.size();
+    overlay.nets.push_back(local);
+
+    const int a0 = timingArcPointers[local];
+    const int a1 = timingArcPointers[local + 1];
+    for (int a = a0; a < a1; a++) {
+      if (overlay.arcMap[a] != -1) continue;
+      overlay.arcMap[a] = overlay.arcs.size();
+      overlay.arcs.push_back(a);
+    }  // end for
+
+    const int q0 = timingSinkArcPointers[local];
+    const int q1 = timingSinkArcPointers[local + 1];
+    for (int q = q0; q < q1; q++) {
+      const int a = timingSinkArcs[q];
+      if (overlay.arcMap[a] != -1) continue;
+      overlay.arcMap[a] = overlay.arcs.size();
+      overlay.arcs.push_back(a);
+    }  // end for
+  }    // end for
+
+  // Copy current state.
+  const int numOverlayArcs = overlay.arcs.size();
+  const int numOverlayNets = overlay.nets.size();
+
+  overlay.current.arcs.resize(numOverlayArcs);
+  overlay.current.nets.resize(numOverlayNets);
+
+  for (int i = 0; i < numOverlayArcs; i++) {
+    const TimingArcState src = getTimingArcState(overlay.arcs[i]);
+    TimingArcState dst(overlay.current.arcs, i);
+    dst.islew = src.islew;
+    dst.oslew = src.oslew;
+    dst.delay = src.delay;
+    dst.lambda = src.lambda;
+    dst.rcdelay = src.rcdelay;
+    dst.ceff = src.ceff;
+    dst.arrivalTime = src.arrivalTime;
+    dst.requiredTime = src.requiredTime;
+    dst.loadViolation = src.loadViolation;
+    dst.slack = src.slack;
+  }  // end for
+
+  for (int i = 0; i < numOverlayNets; i++) {
+    const TimingNetState src = getTimingNetState(overlay.nets[i]);
+    TimingNetState dst(overlay.current.nets, i);
+    dst.load = src.load;
+    dst.loadViolation = src.loadViolation;
+    dst.slew = src.slew;
+    dst.arrivalTime = src.arrivalTime;
+    dst.requiredTime = src.requiredTime;
+    dst.backtrack = src.backtrack;
+    dst.backtrackSlew = src.backtrackSlew;
+    dst.worstRCDelay = src.worstRCDelay;
+    dst.lambdaDelay = src.lambdaDelay;
+  }  // end for
+
+  overlay.violationCurrent = TimingViolationSlot();
+  storeTimingOverlay(overlay);
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::storeTimingOverlay(TimingOverlay &overlay) {
+  overlay.stored = overlay.current;
+  overlay.violationStored = overlay.violationCurrent;
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::commitTimingOverlay(TimingOverlay &overlay, const int slot) {
+  // Only fields computed by updateTiming_Net() are written back. Net loads
+  // are kept up-to-date by updateCellLoad() directly.
+  const int numOverlayArcs = overlay.arcs.size();
+  const int numOverlayNets = overlay.nets.size();
+
+  for (int i = 0; i < numOverlayArcs; i++) {
+    const TimingArcState src(overlay.stored.arcs, i);
+    TimingArcState dst = getTimingArcState(overlay.arcs[i]);
+    dst.islew = src.islew;
+    dst.oslew = src.oslew;
+    dst.delay = src.delay;
+    dst.rcdelay = src.rcdelay;
+    dst.ceff = src.ceff;
+    dst.arrivalTime = src.arrivalTime;
+    dst.loadViolation = src.loadViolation;
+  }  // end for
+
+  for (int i = 0; i < numOverlayNets; i++) {
+    const TimingNetState src(overlay.stored.nets, i);
+    TimingNetState dst = getTimingNetState(overlay.nets[i]);
+    dst.loadViolation = src.loadViolation;
+    dst.slew = src.slew;
+    dst.arrivalTime = src.arrivalTime;
+    dst.backtrack = src.backtrack;
+    dst.backtrackSlew = src.backtrackSlew;
+    dst.worstRCDelay = src.worstRCDelay;
+  }  // end for
+
+  TimingViolationSlot &violation = timingViolationSlots[slot];
+  violation.slew += overlay.violationStored.slew;
+  violation.load += overlay.violationStored.load;
+  violation.loadCellWise += overlay.violationStored.loadCellWise;
 }  // end method
 
 // -----------------------------------------------------------------------------
@@ -9446,7 +11188,7 @@ void Circuit::updateTimingLocally_LinearApproximation(const int n) {
     updateTiming_Net_LinearApproximation(timingLocalNets[k]);
   }  // end for
 
-  updateTiming_SlewViolation();
+  updateTiming_Violations();
 }  // end method
 
 // -----------------------------------------------------------------------------
@@ -9461,7 +11203,7 @@ void Circuit::updateTimingLocallyIncludingSideNets(const int n) {
     updateTiming_Net(timingLocalNetsIncludingSideNets[k]);
   }  // end for
 
-  updateTiming_SlewViolation();
+  updateTiming_Violations();
 }  // end method
 
 // -----------------------------------------------------------------------------
@@ -9478,12 +11220,19 @@ void Circuit::updateTimingDriverCell(const int n) {
        */
   updateTiming_Net(n);
 
-  updateTiming_SlewViolation();
+  updateTiming_Violations();
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::updateTiming_Net(const int i, const int slot) {
+  updateTiming_Net(i, timingViolationSlots[slot], NULL);
 }  // end method
 
 // -----------------------------------------------------------------------------
 
-void Circuit::updateTiming_Net(const int i, const int threadId) {
+void Circuit::updateTiming_Net(const int i, TimingViolationSlot &violation,
+                               TimingOverlay *overlay) {
   const EdgeArray<double> EMPTY(-numeric_limits<double>::max(),
                                 -numeric_limits<double>::max());
 
@@ -9496,9 +11245,7 @@ void Circuit::updateTiming_Net(const int i, const int threadId) {
                                   -numeric_limits<double>::max());
 
   const TimingNet &net = timingNets[i];
-  TimingNetState &netstate = getTimingNetState(i);
-
-  double &slewViolation = timingViolationSlewVector[threadId];
+  TimingNetState netstate = getTimingNetState(i, overlay);
 
   RCTree &tree = timingTrees[i];
 
@@ -9510,10 +11257,10 @@ void Circuit::updateTiming_Net(const int i, const int threadId) {
 
   // Clean-up sink arc's state.
   for (int q = q0; q < q1; q++) {
-    TimingArcState &arcstate = getTimingArcState(timingSinkArcs[q]);
+    TimingArcState arcstate = getTimingArcState(timingSinkArcs[q], overlay);
 
-    slewViolation -= computeSlewViolation(arcstate.islew[RISE], 1);
-    slewViolation -= computeSlewViolation(arcstate.islew[FALL], 1);
+    violation.slew -= computeSlewViolation(arcstate.islew[RISE], 1);
+    violation.slew -= computeSlewViolation(arcstate.islew[FALL], 1);
 
     arcstate.arrivalTime = EMPTY;
     arcstate.islew = EMPTY;
@@ -9524,57 +11271,97 @@ void Circuit::updateTiming_Net(const int i, const int threadId) {
 
   double maxArcLoadViolation = 0;
 
+  // Driver context of the last RC tree simulation. Only tracked when the
+  // simulation may be shared among driver arcs.
+  bool simulated = false;
+  EdgeArray<double> simulatedInputSlew(0, 0);
+  EdgeArray<double> simulatedDelay(0, 0);
+  EdgeArray<double> simulatedSlew(0, 0);
+
   for (int k = k0; k < k1; k++) {
     // Update arc timings.
     const TimingArc &driverArc = timingArcs[k];
-    TimingArcState &driverArcState = getTimingArcState(k);
+    TimingArcState driverArcState = getTimingArcState(k, overlay);
 
-    timingViolationLoad -= driverArcState.loadViolation;
+    violation.load -= driverArcState.loadViolation;
 
     const LibParserTimingInfo &timingInfo =
         driverArc.cell->actualInstType->timingArcs[driverArc.lut];
-    tree.simulate(RCTreeDriver(timingInfo, driverArcState.islew), EPSILON, 100);
-    const RCTree::Node &root = tree.getRoot();
+    const RCTreeDriver driver(timingInfo, driverArcState.islew);
+
+    // If this arc drives the tree almost as the arc last simulated, the
+    // simulation is reused.
+    bool shared = false;
+    if (simulated && nearlyEqual(driverArcState.islew, simulatedInputSlew,
+                                 timingRCTreeSharingTolerance)) {
+      EdgeArray<double> td;
+      EdgeArray<double> tf;
+      driver.computeDelayAndSlew(tree.getEffectiveCap(0), td, tf);
+      shared = nearlyEqual(td, simulatedDelay, timingRCTreeSharingTolerance) &&
+               nearlyEqual(tf, simulatedSlew, timingRCTreeSharingTolerance);
+    }  // end if
+
+    if (!shared) {
+      // The Ceff converged in the last update of this arc, if any, is a good
+      // guess as the driver slew usually changes only slightly between
+      // updates.
+      const EdgeArray<double> previousCeff = driverArcState.ceff * 1e-15;
+      const bool warmStart = timingRCTreeWarmStart &&
+                             previousCeff[RISE] > 0 && previousCeff[FALL] > 0;
+
+      if (timingRCTreePiModel)
+        tree.simulatePiModel(driver, timingRCTreeMaxShielding, EPSILON, 100,
+                             warmStart ? &previousCeff : NULL);
+      else
+        tree.simulate(driver, EPSILON, 100, warmStart ? &previousCeff : NULL);
 
-    driverArcState.ceff = root.propEffectiveCap * 1e15;
+      if (timingRCTreeSharingTolerance > 0 && k + 1 < k1) {
+        simulated = true;
+        simulatedInputSlew = driverArcState.islew;
+        driver.computeDelayAndSlew(tree.getEffectiveCap(0),
+                                   simulatedDelay, simulatedSlew);
+      }  // end if
+    }    // end if
+
+    driverArcState.ceff = tree.getEffectiveCap(0) * 1e15;
     // driverArcState.ceff =
     // tree.computeEffectiveCapacitanceBasedOnJessica(RCTreeDriver(timingInfo,
     // driverArcState.islew)) * 1e15; driverArcState.ceff =
     // tree.computeEffectiveCapacitanceBasedOnMenezes(RCTreeDriver(timingInfo,
     // driverArcState.islew)) * 1e15;
 
-    driverArcState.oslew = root.propSlew * 1e12;
-    driverArcState.delay.set(
-        lookup(timingInfo.riseDelay, driverArcState.ceff[RISE],
-               driverArcState.islew[FALL]),
-        lookup(timingInfo.fallDelay, driverArcState.ceff[FALL],
-               driverArcState.islew[RISE]));
+    driverArcState.oslew = tree.getSlew(0) * 1e12;
+    lookupDelay(timingInfo, driverArcState.ceff[RISE],
+                driverArcState.ceff[FALL], driverArcState.islew[RISE],
+                driverArcState.islew[FALL], driverArcState.delay[RISE],
+                driverArcState.delay[FALL]);
     driverArcState.loadViolation =
         computeLoadViolationUsingEffectiveCap(driverArc, driverArcState);
 
     maxArcLoadViolation =
         max(maxArcLoadViolation, computeLoadViolationUsingEffectiveCapCellWise(
                                      driverArc, driverArcState));
-    timingViolationLoad += driverArcState.loadViolation;
+    violation.load += driverArcState.loadViolation;
 
     const int l0 = timingTreeNodePointers[i];
     const int l1 = timingTreeNodePointers[i + 1];
     for (int l = l0; l < l1; l++) {
       const TreeNodePointer &p = timingTreeNodes[l];
-      const RCTree::Node &node = tree.getNode(p.node);
+      const EdgeArray<double> &nodeDelay = tree.getDelay(p.node);
+      const EdgeArray<double> &nodeSlew = tree.getSlew(p.node);
 
-      TimingArcState &sinkArcState = getTimingArcState(p.arc);
+      TimingArcState sinkArcState = getTimingArcState(p.arc, overlay);
 
       for (int edge = 0, reverseEdge = 1; edge < 2; edge++, reverseEdge--) {
-        const double arrivalTime = node.propDelay[edge] * 1e12 +
+        const double arrivalTime = nodeDelay[edge] * 1e12 +
                                    driverArcState.arrivalTime[reverseEdge] +
                                    driverArcState.delay[edge];
 
-        const double slew = node.propSlew[edge] * 1e12;
+        const double slew = nodeSlew[edge] * 1e12;
 
         if (arrivalTime > sinkArcState.arrivalTime[edge]) {
           sinkArcState.arrivalTime[edge] = arrivalTime;
-          sinkArcState.rcdelay[edge] = node.propDelay[edge] * 1e12;
+          sinkArcState.rcdelay[edge] = nodeDelay[edge] * 1e12;
         }  // end if
 
         if (slew > sinkArcState.islew[edge]) {
@@ -9606,8 +11393,8 @@ void Circuit::updateTiming_Net(const int i, const int threadId) {
   }  // end for
 
   // Update load violation.
-  timingViolationLoadCellWise -= netstate.loadViolation;
-  timingViolationLoadCellWise += maxArcLoadViolation;
+  violation.loadCellWise -= netstate.loadViolation;
+  violation.loadCellWise += maxArcLoadViolation;
 
   // Update net state.
   netstate.arrivalTime = maxArrivalTime;
@@ -9620,9 +11407,10 @@ void Circuit::updateTiming_Net(const int i, const int threadId) {
   netstate.worstRCDelay.set(-numeric_limits<double>::max(),
                             -numeric_limits<double>::max());
   for (int q = q0; q < q1; q++) {
-    const TimingArcState &arcstate = getTimingArcState(timingSinkArcs[q]);
-    slewViolation += computeSlewViolation(arcstate.islew[RISE], 1);
-    slewViolation += computeSlewViolation(arcstate.islew[FALL], 1);
+    const TimingArcState &arcstate =
+        getTimingArcState(timingSinkArcs[q], overlay);
+    violation.slew += computeSlewViolation(arcstate.islew[RISE], 1);
+    violation.slew += computeSlewViolation(arcstate.islew[FALL], 1);
 
     netstate.worstRCDelay = max(netstate.worstRCDelay, arcstate.rcdelay);
   }  // end for
@@ -9631,7 +11419,7 @@ void Circuit::updateTiming_Net(const int i, const int threadId) {
 
   for (int k = k0; k < k1; k++) {
     const TimingArc &arc = timingArcs[k];
-    const TimingArcState &arcstate = getTimingArcState(k);
+    const TimingArcState &arcstate = getTimingArcState(k, overlay);
 
     for (int edge = 0, reverseEdge = 1; edge < 2; edge++, reverseEdge--) {
       if (netstate.arrivalTime[edge] <
@@ -9660,12 +11448,12 @@ void Circuit::updateTiming_Net_LinearApproximation(const int i) {
                                   -numeric_limits<double>::max());
 
   const TimingNet &net = timingNets[i];
-  TimingNetState &netstate = getTimingNetState(i);
+  TimingNetState netstate = getTimingNetState(i);
   const TimingNetState &netsnap = getTimingNetState(i, timingStateStored);
 
   const double loadChange = netstate.load / netsnap.load;
 
-  double &slewViolation = timingViolationSlewVector[0];
+  TimingViolationSlot &violation = timingViolationSlots[0];
 
   const int k0 = timingArcPointers[i];
   const int k1 = timingArcPointers[i + 1];
@@ -9674,10 +11462,10 @@ void Circuit::updateTiming_Net_LinearApproximation(const int i) {
   const int q1 = timingSinkArcPointers[i + 1];
 
   for (int q = q0; q < q1; q++) {
-    TimingArcState &arcstate = getTimingArcState(timingSinkArcs[q]);
+    TimingArcState arcstate = getTimingArcState(timingSinkArcs[q]);
 
-    slewViolation -= computeSlewViolation(arcstate.islew[RISE], 1);
-    slewViolation -= computeSlewViolation(arcstate.islew[FALL], 1);
+    violation.slew -= computeSlewViolation(arcstate.islew[RISE], 1);
+    violation.slew -= computeSlewViolation(arcstate.islew[FALL], 1);
 
     arcstate.arrivalTime = EMPTY;
     arcstate.islew = EMPTY;
@@ -9689,7 +11477,7 @@ void Circuit::updateTiming_Net_LinearApproximation(const int i) {
   for (int k = k0; k < k1; k++) {
     // Update arc timings.
     const TimingArc &driverArc = timingArcs[k];
-    TimingArcState &driverArcState = getTimingArcState(k);
+    TimingArcState driverArcState = getTimingArcState(k);
     const TimingArcState &driverArcSnap =
         getTimingArcState(k, timingStateStored);
 
@@ -9701,21 +11489,14 @@ void Circuit::updateTiming_Net_LinearApproximation(const int i) {
     const EdgeArray<double> shielding = driverArcSnap.ceff / netsnap.load;
     const EdgeArray<double> multiplier = loadChange * shielding;
 
-    timingViolationLoad -= driverArcState.loadViolation;
+    violation.load -= driverArcState.loadViolation;
 
     driverArcState.ceff = driverArcSnap.ceff * multiplier;
 
-    driverArcState.oslew.set(
-        lookup(timingInfo.riseTransition, driverArcState.ceff[RISE],
-               driverArcState.islew[FALL]),
-        lookup(timingInfo.fallTransition, driverArcState.ceff[FALL],
-               driverArcState.islew[RISE]));
-
-    driverArcState.delay.set(
-        lookup(timingInfo.riseDelay, driverArcState.ceff[RISE],
-               driverArcState.islew[FALL]),
-        lookup(timingInfo.fallDelay, driverArcState.ceff[FALL],
-               driverArcState.islew[RISE]));
+    lookup(timingInfo, driverArcState.ceff[RISE], driverArcState.ceff[FALL],
+           driverArcState.islew[RISE], driverArcState.islew[FALL],
+           driverArcState.delay[RISE], driverArcState.delay[FALL],
+           driverArcState.oslew[RISE], driverArcState.oslew[FALL]);
 
     driverArcState.loadViolation =
         computeLoadViolationUsingEffectiveCap(driverArc, driverArcState);
@@ -9723,13 +11504,13 @@ void Circuit::updateTiming_Net_LinearApproximation(const int i) {
     maxArcLoadViolation =
         max(maxArcLoadViolation, computeLoadViolationUsingEffectiveCapCellWise(
                                      driverArc, driverArcState));
-    timingViolationLoad += driverArcState.loadViolation;
+    violation.load += driverArcState.loadViolation;
 
     const EdgeArray<double> slewChange =
         driverArcState.oslew / driverArcSnap.oslew;
 
     for (int q = q0; q < q1; q++) {
-      TimingArcState &sinkArcState = getTimingArcState(timingSinkArcs[q]);
+      TimingArcState sinkArcState = getTimingArcState(timingSinkArcs[q]);
       const TimingArcState &sinkArcSnap =
           getTimingArcState(timingSinkArcs[q], timingStateStored);
 
@@ -9781,8 +11562,8 @@ void Circuit::updateTiming_Net_LinearApproximation(const int i) {
   }  // end for
 
   // Update load violation.
-  timingViolationLoadCellWise -= netstate.loadViolation;
-  timingViolationLoadCellWise += maxArcLoadViolation;
+  violation.loadCellWise -= netstate.loadViolation;
+  violation.loadCellWise += maxArcLoadViolation;
 
   // Update net state.
   netstate.arrivalTime = maxArrivalTime;
@@ -9794,8 +11575,8 @@ void Circuit::updateTiming_Net_LinearApproximation(const int i) {
   // Update slew violation at sink arc's input.
   for (int q = q0; q < q1; q++) {
     const TimingArcState &arcstate = getTimingArcState(timingSinkArcs[q]);
-    slewViolation += computeSlewViolation(arcstate.islew[RISE], 1);
-    slewViolation += computeSlewViolation(arcstate.islew[FALL], 1);
+    violation.slew += computeSlewViolation(arcstate.islew[RISE], 1);
+    violation.slew += computeSlewViolation(arcstate.islew[FALL], 1);
   }  // end for
 
   //	const TimingNet &net = timingNets[i];
@@ -9833,24 +11614,44 @@ void Circuit::updateTiming_Net_LinearApproximation(const int i) {
   //		const TimingArcState &arcsnap =
   // getTimingArcState(timingSinkArcs[q], timingStateStored);
   //
-  //		slewViolation -= computeSlewViolation(arcstate.islew[RISE], 1);
-  //		slewViolation -= computeSlewViolation(arcstate.islew[FALL], 1);
+  //		violation.slew -= computeSlewViolation(arcstate.islew[RISE], 1);
+  //		violation.slew -= computeSlewViolation(arcstate.islew[FALL], 1);
   //
   //		arcstate.arrivalTime = netstate.arrivalTime + arcstate.rcdelay;
   //		arcstate.islew = arcsnap.islew * slewChange;
   //
-  //		slewViolation += computeSlewViolation(arcstate.islew[RISE], 1);
-  //		slewViolation += computeSlewViolation(arcstate.islew[FALL], 1);
+  //		violation.slew += computeSlewViolation(arcstate.islew[RISE], 1);
+  //		violation.slew += computeSlewViolation(arcstate.islew[FALL], 1);
   //	} // end for
 }  // end method
 
 // -----------------------------------------------------------------------------
 
-void Circuit::updateTiming_Nets(const int n0, const int n1,
-                                const int threadId) {
-  for (int n = n0; n < n1; n++) updateTiming_Net(n, threadId);
+void Circuit::updateTiming_Nets(const int n0, const int n1) {
+  for (int n = n0; n < n1; n++) updateTiming_Net(n, 1 + n);
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+#ifdef PARALLEL
+
+void Circuit::updateTiming_TaskGraph(const int threadId, const int n) {
+  updateTiming_Net(n, 1 + n);
+
+  // Release sink nets whose drivers are all done. The released net is
+  // pushed to this thread deque as it will likely reuse data in cache.
+  const int k0 = timingSinkNetPointers[n];
+  const int k1 = timingSinkNetPointers[n + 1];
+  for (int k = k0; k < k1; k++) {
+    const int sink = timingSinkNets[k];
+    if (threadTaskPendingDrivers[sink].fetch_sub(
+            1, std::memory_order_acq_rel) == 1)
+      threadPool.push(threadId, sink, sink + 1);
+  }  // end for
 }  // end method
 
+#endif
+
 // -----------------------------------------------------------------------------
 
 void Circuit::updateTiming_NetEndpoints(const int i) {
@@ -9862,7 +11663,7 @@ void Circuit::updateTiming_NetEndpoints(const int i) {
   const int k1 = timingSinkArcPointers[i + 1];
   for (int k = k0; k < k1; k++) {
     // Update arc timings.
-    TimingArcState &arcstate = getTimingArcState(timingSinkArcs[k]);
+    TimingArcState arcstate = getTimingArcState(timingSinkArcs[k]);
 
     arcstate.arrivalTime = netstate.arrivalTime;
     arcstate.islew = netstate.slew;
@@ -9879,9 +11680,9 @@ void Circuit::updateTiming_WorstArrivalTime() {
 
   const double T = getT();
 
-  timingTotalNegativeSlack = 0;
-  timingTotalPositiveSlack = 0;
-  timingTotalAbsoluteSlack = 0;
+  timingTotalNegativeSlackHundredths = 0;
+  timingTotalPositiveSlackHundredths = 0;
+  timingTotalAbsoluteSlackHundredths = 0;
 
   timingWorstArrivalTime.set(-numeric_limits<double>::max(),
                              -numeric_limits<double>::max());
@@ -9891,6 +11692,9 @@ void Circuit::updateTiming_WorstArrivalTime() {
 
   // Tail Arcs
   const int numArcs = timingArcs.size();
+  timingEndpointSlack.assign(numArcs - timingOffsetToExtraSequentialArcs,
+                             EdgeArray<int>(0, 0));
+
   for (int i = timingOffsetToExtraSequentialArcs; i < numArcs; i++) {
     const TimingArc &arc = timingArcs[i];
     const TimingArcState &arcstate = getTimingArcState(i);
@@ -9900,19 +11704,14 @@ void Circuit::updateTiming_WorstArrivalTime() {
         timingWorstArrivalTime[edge] = arcstate.arrivalTime[edge];
         timingWorstArrivalTimeArc[edge] = i;
       }  // end if
+    }    // end for
 
-      const double slack = myRound(T - arcstate.arrivalTime[edge], 2);
-
-      if (slack < 0) {
-        timingTotalNegativeSlack -= slack;
-        timingNumPathsWithNegativeSlack++;
-      } else {
-        timingTotalPositiveSlack += slack;
-      }  // end else
+    updateTiming_EndpointSlack(i, T);
+  }  // end for
 
-      timingTotalAbsoluteSlack += fabs(slack);
-    }  // end for
-  }    // end for
+  timingTotalNegativeSlack = timingTotalNegativeSlackHundredths / 100.0;
+  timingTotalPositiveSlack = timingTotalPositiveSlackHundredths / 100.0;
+  timingTotalAbsoluteSlack = timingTotalAbsoluteSlackHundredths / 100.0;
 
   //	const int numTails = timingTailNets.size();
   //	for (int i = 0; i < numTails; i++) {
@@ -9943,14 +11742,142 @@ void Circuit::updateTiming_WorstArrivalTime() {
 
 // -----------------------------------------------------------------------------
 
-void Circuit::updateTiming_SlewViolation() {
-#ifdef PARALLEL
-  timingViolationSlew = 0;
-  for (int i = 0; i < threadNumThreads; i++)
-    timingViolationSlew += timingViolationSlewVector[i];
-#else
-  timingViolationSlew = timingViolationSlewVector[0];
-#endif
+void Circuit::updateTiming_WorstArrivalTime(const vector<int> &nets) {
+  const int numArcs = timingArcs.size();
+  const int numEndpoints = numArcs - timingOffsetToExtraSequentialArcs;
+  if ((int)timingEndpointSlack.size() != numEndpoints) {
+    updateTiming_WorstArrivalTime();
+    return;
+  }  // end if
+
+  const double T = getT();
+
+  // Set if the arc with the worst arrival time got faster. Then the worst
+  // arrival time is not known and all path ends need to be checked.
+  bool rescan = false;
+
+  const int numUpdatedNets = nets.size();
+  for (int i = 0; i < numUpdatedNets; i++) {
+    const int n = nets[i];
+
+    const int q0 = timingSinkArcPointers[n];
+    const int q1 = timingSinkArcPointers[n + 1];
+    for (int q = q0; q < q1; q++) {
+      const int k = timingSinkArcs[q];
+      if (k < timingOffsetToExtraSequentialArcs) continue;
+
+      const TimingArcState &arcstate = getTimingArcState(k);
+
+      for (int edge = 0; edge < 2; edge++) {
+        if (arcstate.arrivalTime[edge] > timingWorstArrivalTime[edge]) {
+          timingWorstArrivalTime[edge] = arcstate.arrivalTime[edge];
+          timingWorstArrivalTimeArc[edge] = k;
+        } else if (k == timingWorstArrivalTimeArc[edge] &&
+                   arcstate.arrivalTime[edge] < timingWorstArrivalTime[edge]) {
+          rescan = true;
+        }  // end else
+      }    // end for
+
+      updateTiming_EndpointSlack(k, T);
+    }  // end for
+  }    // end for
+
+  if (rescan) {
+    timingWorstArrivalTime.set(-numeric_limits<double>::max(),
+                               -numeric_limits<double>::max());
+    timingWorstArrivalTimeArc.set(-1, -1);
+
+    for (int k = timingOffsetToExtraSequentialArcs; k < numArcs; k++) {
+      const TimingArcState &arcstate = getTimingArcState(k);
+      for (int edge = 0; edge < 2; edge++) {
+        if (arcstate.arrivalTime[edge] > timingWorstArrivalTime[edge]) {
+          timingWorstArrivalTime[edge] = arcstate.arrivalTime[edge];
+          timingWorstArrivalTimeArc[edge] = k;
+        }  // end if
+      }    // end for
+    }      // end for
+  }        // end if
+
+  timingTotalNegativeSlack = timingTotalNegativeSlackHundredths / 100.0;
+  timingTotalPositiveSlack = timingTotalPositiveSlackHundredths / 100.0;
+  timingTotalAbsoluteSlack = timingTotalAbsoluteSlackHundredths / 100.0;
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::updateTiming_EndpointSlack(const int k, const double T) {
+  const TimingArcState &arcstate = getTimingArcState(k);
+  EdgeArray<int> &slack =
+      timingEndpointSlack[k - timingOffsetToExtraSequentialArcs];
+
+  for (int edge = 0; edge < 2; edge++) {
+    // Remove the previous contribution. Slacks start at zero, which
+    // contributes nothing.
+    const int previous = slack[edge];
+    if (previous < 0) {
+      timingTotalNegativeSlackHundredths += previous;
+      timingNumPathsWithNegativeSlack--;
+    } else if (previous > 0) {
+      timingTotalPositiveSlackHundredths -= previous;
+    }  // end else
+    timingTotalAbsoluteSlackHundredths -= abs(previous);
+
+    // Same rounding as myRound(T - arrivalTime, 2).
+    const int current =
+        (int)floor((T - arcstate.arrivalTime[edge]) * 100.0 + 0.5);
+    if (current < 0) {
+      timingTotalNegativeSlackHundredths -= current;
+      timingNumPathsWithNegativeSlack++;
+    } else {
+      timingTotalPositiveSlackHundredths += current;
+    }  // end else
+    timingTotalAbsoluteSlackHundredths += abs(current);
+
+    slack[edge] = current;
+  }  // end for
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::updateTiming_Violations(const int i0, const int i1) {
+  // Slots are reduced in index order, so totals do not depend on how tasks
+  // were scheduled.
+  TimingViolationSlot &serial = timingViolationSlots[0];
+  timingViolationSlew += serial.slew;
+  timingViolationLoad += serial.load;
+  timingViolationLoadCellWise += serial.loadCellWise;
+  serial = TimingViolationSlot();
+
+  for (int i = i0; i < i1; i++) {
+    TimingViolationSlot &slot = timingViolationSlots[1 + i];
+
+    timingViolationSlew += slot.slew;
+    timingViolationLoad += slot.load;
+    timingViolationLoadCellWise += slot.loadCellWise;
+
+    slot = TimingViolationSlot();
+  }  // end for
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+void Circuit::updateSizing_Totals(const int i0, const int i1) {
+  // Reduced in index order as in updateTiming_Violations().
+  SizingTotalsSlot &serial = sizingTotalsSlots[0];
+  loadViol += serial.loadViolation;
+  totalLeakage += serial.leakage;
+  totalArea += serial.area;
+  serial = SizingTotalsSlot();
+
+  for (int i = i0; i < i1; i++) {
+    SizingTotalsSlot &slot = sizingTotalsSlots[1 + i];
+
+    loadViol += slot.loadViolation;
+    totalLeakage += slot.leakage;
+    totalArea += slot.area;
+
+    slot = SizingTotalsSlot();
+  }  // end for
 }  // end method
 
 // -----------------------------------------------------------------------------
@@ -9976,7 +11903,7 @@ void Circuit::updateLambdasByTennakoon() {
   // Output Timing Arcs (tail)
   const int numArcs = timingArcs.size();
   for (int i = timingOffsetToExtraSequentialArcs; i < numArcs; i++) {
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const EdgeArray<double> ai = arcstate.arrivalTime;
 
@@ -9987,7 +11914,7 @@ void Circuit::updateLambdasByTennakoon() {
   for (int i = timingOffsetToCombinationArcs;
        i < timingOffsetToExtraSequentialArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const TimingNetState &netstate = getTimingNetState(arc.sink);
 
@@ -10001,7 +11928,7 @@ void Circuit::updateLambdasByTennakoon() {
   // Input Timing Arcs (head)
   for (int i = 0; i < timingOffsetToCombinationArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const TimingNetState &netstate = getTimingNetState(arc.sink);
 
@@ -10029,7 +11956,7 @@ void Circuit::updateLambdasByFlach() {
   const int numArcs = timingArcs.size();
   for (int i = 0; i < numArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const EdgeArray<double> q = arc.sink == -1
                                     ? EdgeArray<double>(T, T)
@@ -10075,7 +12002,7 @@ void Circuit::updateLambdasByFlachReimann() {
   const int numArcs = timingArcs.size();
   for (int i = 0; i < numArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     EdgeArray<double> a;
     EdgeArray<double> q;
@@ -10115,32 +12042,34 @@ void Circuit::updateLambdasByFlachReimannAlpha(const double alpha) {
 
   const double T = sdcInfos.clk_period;
 
+  // Only a few fields are touched, so sweep the state arrays directly.
+  ArcStateArrays &arcs = timingStateCurrent.arcs;
+  const NetStateArrays &nets = timingStateCurrent.nets;
+
   const int numArcs = timingArcs.size();
   for (int i = 0; i < numArcs; i++) {
-    const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    const int sink = timingArcs[i].sink;
 
     EdgeArray<double> a;
     EdgeArray<double> q;
 
-    if (arc.sink != -1) {
-      const TimingNetState &netstate = getTimingNetState(arc.sink);
-
-      q = netstate.requiredTime;
-      a = arcstate.arrivalTime.getReversed() + arcstate.delay +
-          netstate.worstRCDelay;
+    if (sink != -1) {
+      q = nets.requiredTime[sink];
+      a = arcs.arrivalTime[i].getReversed() + arcs.delay[i] +
+          nets.worstRCDelay[sink];
     } else {
       q.set(T, T);
-      a = arcstate.arrivalTime.getReversed();
+      a = arcs.arrivalTime[i].getReversed();
     }  // end else
 
+    EdgeArray<double> &lambda = arcs.lambda[i];
     for (int edge = 0, reverseEdge = 1; edge < 2; edge++, reverseEdge--) {
       const double damping =
           a[edge] > q[edge]
               ? pow(1.0 + ((a[edge] - q[edge]) / T), 1.0 / alpha)
               : pow(1.0 / (1.0 + ((q[edge] - a[edge]) / T)), alpha);
 
-      arcstate.lambda[edge] *= damping;
+      lambda[edge] *= damping;
     }  // end for
   }    // end for
 
@@ -10162,7 +12091,7 @@ void Circuit::updateLambdasByFlachAlpha(const double alpha) {
   const int numArcs = timingArcs.size();
   for (int i = 0; i < numArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const EdgeArray<double> q = arc.sink == -1
                                     ? EdgeArray<double>(T, T)
@@ -10210,7 +12139,7 @@ void Circuit::updateLambdasByFlachWeighted() {
   const int numArcs = timingArcs.size();
   for (int i = 0; i < numArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const EdgeArray<double> q = arc.sink == -1
                                     ? EdgeArray<double>(T, T)
@@ -10256,7 +12185,7 @@ void Circuit::updateLambdasByTennakoonFig4(const double stepSize) {
   // Output Timing Arcs (tail)
   const int numArcs = timingArcs.size();
   for (int i = timingOffsetToExtraSequentialArcs; i < numArcs; i++) {
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const EdgeArray<double> ai = arcstate.arrivalTime;
 
@@ -10267,7 +12196,7 @@ void Circuit::updateLambdasByTennakoonFig4(const double stepSize) {
   for (int i = timingOffsetToCombinationArcs;
        i < timingOffsetToExtraSequentialArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const TimingNetState &netstate = getTimingNetState(arc.sink);
 
@@ -10281,7 +12210,7 @@ void Circuit::updateLambdasByTennakoonFig4(const double stepSize) {
   // Input Timing Arcs (head)
   for (int i = 0; i < timingOffsetToCombinationArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const TimingNetState &netstate = getTimingNetState(arc.sink);
 
@@ -10302,7 +12231,7 @@ void Circuit::updateLambdas_Subgradient() {
 
   // Timing Arcs (head)
   for (int i = timingOffsetToCombinationArcs; i < numArcs; i++) {
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const EdgeArray<double> aj = arcstate.arrivalTime.getReversed();
     const EdgeArray<double> Di = arcstate.delay;
@@ -10345,6 +12274,8 @@ void Circuit::updateLambdas_Normalization() {
 // -----------------------------------------------------------------------------
 
 void Circuit::updateLambdas_KKT() {
+  vector<EdgeArray<double> > &lambdas = timingStateCurrent.arcs.lambda;
+
   const int numNets = timingNets.size();
   for (int i = numNets - 1; i >= timingNumDummyNets; i--) {
     EdgeArray<double> sumDriverLambdas(0, 0);
@@ -10358,27 +12289,23 @@ void Circuit::updateLambdas_KKT() {
 
     // Compute sum of driver timing arc lambdas.
     for (int k = k0; k < k1; k++)
-      sumDriverLambdas = sumDriverLambdas + getTimingArcState(k).lambda;
+      sumDriverLambdas = sumDriverLambdas + lambdas[k];
 
     // Compute sum of sink timing arc lambdas.
     for (int q = q0; q < q1; q++)
-      sumSinkLambdas =
-          sumSinkLambdas + getTimingArcState(timingSinkArcs[q]).lambda;
+      sumSinkLambdas = sumSinkLambdas + lambdas[timingSinkArcs[q]];
 
     // Update driver arcs.
     for (int edge = 0, reverseEdge = 1; edge < 2; edge++, reverseEdge--) {
       const double sum = sumDriverLambdas[reverseEdge];
       if (sum > 0) {
-        for (int k = k0; k < k1; k++) {
-          TimingArcState &arcstate = getTimingArcState(k);
-          arcstate.lambda[reverseEdge] =
-              sumSinkLambdas[edge] * (arcstate.lambda[reverseEdge] / sum);
-        }  // end for
+        for (int k = k0; k < k1; k++)
+          lambdas[k][reverseEdge] =
+              sumSinkLambdas[edge] * (lambdas[k][reverseEdge] / sum);
       } else {
         const int numSinks = k1 - k0;
         for (int k = k0; k < k1; k++) {
-          getTimingArcState(k).lambda[reverseEdge] =
-              (sumSinkLambdas[edge] / numSinks);
+          lambdas[k][reverseEdge] = (sumSinkLambdas[edge] / numSinks);
         }  // end for
       }    // end else
     }      // end for
@@ -10466,7 +12393,7 @@ double Circuit::computeNorm() {
   // Output Timing Arcs (tail)
   const int numArcs = timingArcs.size();
   for (int i = timingOffsetToExtraSequentialArcs; i < numArcs; i++) {
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const EdgeArray<double> ai = arcstate.arrivalTime;
 
@@ -10586,6 +12513,9 @@ void Circuit::updateRequiredTime() {
   const int numNets = timingNets.size();
   const int numArcs = timingArcs.size();
 
+  timingRequiredTimeSeeds.clear();
+  timingRequiredTimeOutdated = false;
+
   // For each dummy path-end timing arc.
   for (int i = timingOffsetToExtraSequentialArcs; i < numArcs; i++) {
     getTimingArcState(i).requiredTime.set(T, T);
@@ -10593,7 +12523,7 @@ void Circuit::updateRequiredTime() {
 
   // Propagate back the required time.
   for (int i = numNets - 1; i >= timingNumDummyNets; i--) {
-    TimingNetState &netstate = getTimingNetState(i);
+    TimingNetState netstate = getTimingNetState(i);
     netstate.requiredTime.set(T, T);
 
     {  // Sink arcs
@@ -10618,7 +12548,7 @@ void Circuit::updateRequiredTime() {
       const int k1 = timingArcPointers[i + 1];
       for (int k = k0; k < k1; k++) {
         const TimingArc &arc = timingArcs[k];
-        TimingArcState &arcstate = getTimingArcState(k);
+        TimingArcState arcstate = getTimingArcState(k);
         arcstate.requiredTime =
             (netstate.requiredTime - arcstate.delay).getReversed();
       }  // end for
@@ -10699,6 +12629,82 @@ void Circuit::updateRequiredTime() {
 
 // -----------------------------------------------------------------------------
 
+void Circuit::updateRequiredTimeFromSeeds() {
+  if (timingRequiredTimeOutdated) {
+    updateRequiredTime();
+    return;
+  }  // end if
+
+  const double T = sdcInfos.clk_period;
+
+  // Delays and rc delays may have changed at the driver and sink arcs of
+  // every net updated by updateTiming(cell).
+  startTimingFrontier();
+  const int numSeeds = timingRequiredTimeSeeds.size();
+  for (int i = 0; i < numSeeds; i++) {
+    const int n = timingRequiredTimeSeeds[i];
+    if (n >= timingNumDummyNets) pushTimingFrontier(n);
+  }  // end for
+  timingRequiredTimeSeeds.clear();
+
+  // Same as updateRequiredTime(), but sweeping the frontier from the
+  // deepest level.
+  for (int depth = timingFrontierMaxDepth; depth >= timingFrontierMinDepth;
+       depth--) {
+    vector<int> &bucket = timingFrontier[depth];
+    const int numBucketNets = bucket.size();
+    for (int i = 0; i < numBucketNets; i++) {
+      const int n = bucket[i];
+
+      TimingNetState netstate = getTimingNetState(n);
+      netstate.requiredTime.set(T, T);
+
+      {  // Sink arcs
+        const int s0 = timingSinkArcPointers[n];
+        const int s1 = timingSinkArcPointers[n + 1];
+        for (int s = s0; s < s1; s++) {
+          const TimingArcState &arcstate = getTimingArcState(timingSinkArcs[s]);
+
+          for (int edge = 0; edge < 2; edge++) {
+            const double requiredTime =
+                arcstate.requiredTime[edge] - arcstate.rcdelay[edge];
+            if (netstate.requiredTime[edge] > requiredTime)
+              netstate.requiredTime[edge] = requiredTime;
+          }  // end for
+        }    // end for
+      }      // end block
+
+      {  // Driver arcs
+        const int k0 = timingArcPointers[n];
+        const int k1 = timingArcPointers[n + 1];
+        for (int k = k0; k < k1; k++) {
+          const TimingArc &arc = timingArcs[k];
+          TimingArcState arcstate = getTimingArcState(k);
+
+          const EdgeArray<double> requiredTime =
+              (netstate.requiredTime - arcstate.delay).getReversed();
+
+          // Driver nets only need to be revisited if the required time
+          // changed. Exact comparison keeps the result equal to the full
+          // update.
+          if (requiredTime[RISE] != arcstate.requiredTime[RISE] ||
+              requiredTime[FALL] != arcstate.requiredTime[FALL]) {
+            arcstate.requiredTime = requiredTime;
+            if (arc.driver >= timingNumDummyNets) {
+              assert(timingNets[arc.driver].depth < depth);
+              pushTimingFrontier(arc.driver);
+            }  // end if
+          }    // end if
+        }      // end for
+      }        // end block
+    }          // end for
+
+    bucket.clear();
+  }  // end for
+}  // end method
+
+// -----------------------------------------------------------------------------
+
 void Circuit::updateLambdaDelaySensitivities() {
   const int numNets = timingNets.size();
   const int numArcs = timingArcs.size();
@@ -10758,7 +12764,7 @@ void Circuit::updateLambdaDelaySensitivities() {
   //			cout << "### Outputs ###\n";
   //
   //		cout << timingLambdaDelaySensitivity[i] << "\t" <<
-  // timingArcs[i].cell->instType << "\t" <<
+  // timingArcs[i].cell->getTypeName() << "\t" <<
   //(i<timingOffsetToCombinationArcs?"dummy":"") << "\n"; 	} // end for
   // exit(1);
 
@@ -10784,7 +12790,7 @@ void Circuit::updateTiming_Debug() {
     if (!nearlyEqual(netstate.load, cell->actualLoad)) {
       cerr << "[BUG] @ Circuit::updateTiming() - Divergent total load for net "
            << i << " and driver cell " << cell->instName << " ("
-           << cell->instType << ").\n";
+           << cell->getTypeName() << ").\n";
       cerr << "\tNet  Total Load: " << netstate.load << "\n";
       cerr << "\tCell Total Load: " << cell->actualLoad << "\n";
       assert(false);
@@ -10970,16 +12976,28 @@ double Circuit::computeSizingEffectOnDriverCellFanoutDelay(const int netIndex) {
 
 // -----------------------------------------------------------------------------
 
-double Circuit::computeSizingEffectOnLambdaDelay(const int netIndex) {
+double Circuit::computeSizingEffectOnLambdaDelay(const int netIndex,
+                                                 TimingOverlay *overlay) {
   EdgeArray<double> effect(0, 0);
 
   const int k0 = timingLocalArcPointers[netIndex];
   const int k1 = timingLocalArcPointers[netIndex + 1];
-  for (int k = k0; k < k1; k++) {
-    const TimingArcState &arcstate = getTimingArcState(timingLocalArcs[k]);
-    effect +=
-        arcstate.lambda * (arcstate.delay + arcstate.rcdelay.getReversed());
-  }  // end for
+
+  if (!overlay) {
+    const ArcStateArrays &arcs = timingStateCurrent.arcs;
+    for (int k = k0; k < k1; k++) {
+      const int arc = timingLocalArcs[k];
+      effect +=
+          arcs.lambda[arc] * (arcs.delay[arc] + arcs.rcdelay[arc].getReversed());
+    }  // end for
+  } else {
+    for (int k = k0; k < k1; k++) {
+      const TimingArcState arcstate =
+          getTimingArcState(timingLocalArcs[k], overlay);
+      effect += arcstate.lambda *
+                (arcstate.delay + arcstate.rcdelay.getReversed());
+    }  // end for
+  }    // end else
 
   return effect.aggregate();
 }  // end method
@@ -11146,13 +13164,17 @@ double Circuit::computeSizingEffectOnSlack(const int netIndex) {
 
 // -----------------------------------------------------------------------------
 
-double Circuit::computeSizingEffectOnLocalNegativeSlack(const int netIndex) {
+double Circuit::computeSizingEffectOnLocalNegativeSlack(
+    const int netIndex, TimingOverlay *overlay) {
   EdgeArray<double> effect(0, 0);
 
   const int k0 = timingLocalNetPointers[netIndex];
   const int k1 = timingLocalNetPointers[netIndex + 1];
   for (int k = k0; k < k1; k++) {
-    effect += getNetNegativeSlack(timingLocalNets[k]);
+    const TimingNetState netstate =
+        getTimingNetState(timingLocalNets[k], overlay);
+    effect += min(EdgeArray<double>(0, 0),
+                  netstate.requiredTime - netstate.arrivalTime);
   }  // end for
 
   return effect.aggregate();
@@ -12715,6 +14737,7 @@ void Circuit::updateTimingLR() {
 
   // Find the worst arrival time.
   updateTiming_WorstArrivalTime();
+  updateTiming_Violations();
 
 #ifndef NDEBUG
   updateTiming_Debug();
@@ -12733,7 +14756,7 @@ void Circuit::updateTimingLR_KKT() {
 
   // Find the worst arrival time.
   updateTiming_WorstArrivalTime();
-  updateTiming_SlewViolation();  // thread-safe slew violation update.
+  updateTiming_Violations();     // reduce pending violations.
   updateTiming_Deprecated();     // keep old stuffs up-to-date.
 
 #ifndef NDEBUG
@@ -12761,7 +14784,7 @@ void Circuit::updateRequiredTimeLR() {
   // Propagate back the required time.
   for (int i = numNets - 1; i >= timingNumDummyNets; --i) {
     const TimingNet &net = timingNets[i];
-    TimingNetState &netstate = getTimingNetState(i);
+    TimingNetState netstate = getTimingNetState(i);
 
     const EdgeArray<double> &requiredTimeAtSink = netstate.requiredTime;
 
@@ -12771,7 +14794,7 @@ void Circuit::updateRequiredTimeLR() {
     const int k1 = timingArcPointers[i + 1];
     for (int k = k0; k < k1; k++) {
       const TimingArc &arc = timingArcs[k];
-      TimingArcState &arcstate = getTimingArcState(k);
+      TimingArcState arcstate = getTimingArcState(k);
 
       EdgeArray<double> &requiredTimeAtDriver =
           getTimingNetState(arc.driver).requiredTime;
@@ -12826,7 +14849,7 @@ void Circuit::updateRequiredTimeLR_PT() {
   // Propagate back the required time.
   for (int i = numNets - 1; i >= timingNumDummyNets; --i) {
     const TimingNet &net = timingNets[i];
-    TimingNetState &netstate = getTimingNetState(i);
+    TimingNetState netstate = getTimingNetState(i);
 
     const EdgeArray<double> &requiredTimeAtSink = netstate.requiredTime;
 
@@ -12838,7 +14861,7 @@ void Circuit::updateRequiredTimeLR_PT() {
     const int k1 = timingArcPointers[i + 1];
     for (int k = k0; k < k1; k++) {
       const TimingArc &arc = timingArcs[k];
-      TimingArcState &arcstate = getTimingArcState(k);
+      TimingArcState arcstate = getTimingArcState(k);
 
       EdgeArray<double> &requiredTimeAtDriver =
           getTimingNetState(arc.driver).requiredTime;
@@ -12887,7 +14910,7 @@ void Circuit::updateRequiredTimeLR_KKT() {
   // Propagate back the required time.
   for (int i = numNets - 1; i >= timingNumDummyNets; --i) {
     const TimingNet &net = timingNets[i];
-    TimingNetState &netstate = getTimingNetState(i);
+    TimingNetState netstate = getTimingNetState(i);
 
     const EdgeArray<double> &requiredTimeAtSink = netstate.requiredTime;
 
@@ -12897,7 +14920,7 @@ void Circuit::updateRequiredTimeLR_KKT() {
     const int k1 = timingArcPointers[i + 1];
     for (int k = k0; k < k1; k++) {
       const TimingArc &arc = timingArcs[k];
-      TimingArcState &arcstate = getTimingArcState(k);
+      TimingArcState arcstate = getTimingArcState(k);
 
       EdgeArray<double> &requiredTimeAtDriver =
           getTimingNetState(arc.driver).requiredTime;
@@ -12956,7 +14979,7 @@ void Circuit::updateRequiredTimeLR_KKT() {
       // cout << "Only driving endpoint: " << net.driver->instName << endl;
       for (int k = k0; k < k1; k++) {
         const TimingArc &arc = timingArcs[k];
-        TimingArcState &arcstate = getTimingArcState(k);
+        TimingArcState arcstate = getTimingArcState(k);
 
         EdgeArray<double> &requiredTimeAtDriver =
             getTimingNetState(arc.driver).requiredTime;
@@ -12991,7 +15014,7 @@ void Circuit::updateRequiredTimeLR_KKT() {
     } else {
       for (int k = k0; k < k1; k++) {
         const TimingArc &arc = timingArcs[k];
-        TimingArcState &arcstate = getTimingArcState(k);
+        TimingArcState arcstate = getTimingArcState(k);
         // cout << "NOT! only driving endpoint: " << net.driver->instName <<
         // "\tlambdas: " << totalLambda << endl;
 
@@ -13020,7 +15043,7 @@ void Circuit::updateRequiredTimeLR_KKT() {
       }  // end for
     }
     // cout <<endl;
-    const int outPin = net.driver->pinNetPairs.size() - 1;
+    const int outPin = net.driver->numPins - 1;
     // cout << net.driver->instName << "/" <<
     // net.driver->pinNetPairs[outPin].first << "\t slack neg.: (" <<
     // -requiredTimeAtSink[RISE]+net.arrivalTime[RISE] << ", " <<
@@ -13049,7 +15072,7 @@ void Circuit::updateRequiredTimeLR_PT_KKT() {
   // Propagate back the required time.
   for (int i = numNets - 1; i >= timingNumDummyNets; --i) {
     const TimingNet &net = timingNets[i];
-    TimingNetState &netstate = getTimingNetState(i);
+    TimingNetState netstate = getTimingNetState(i);
 
     const EdgeArray<double> &requiredTimeAtSink = netstate.requiredTime;
 
@@ -13061,7 +15084,7 @@ void Circuit::updateRequiredTimeLR_PT_KKT() {
     const int k1 = timingArcPointers[i + 1];
     for (int k = k0; k < k1; k++) {
       const TimingArc &arc = timingArcs[k];
-      TimingArcState &arcstate = getTimingArcState(k);
+      TimingArcState arcstate = getTimingArcState(k);
 
       EdgeArray<double> &requiredTimeAtDriver =
           getTimingNetState(arc.driver).requiredTime;
@@ -13104,7 +15127,7 @@ void Circuit::updateRequiredTimeLR_PT_KKT() {
       // cout << "Only driving endpoint: " << net.driver->instName << endl;
       for (int k = k0; k < k1; k++) {
         const TimingArc &arc = timingArcs[k];
-        TimingArcState &arcstate = getTimingArcState(k);
+        TimingArcState arcstate = getTimingArcState(k);
 
         EdgeArray<double> &requiredTimeAtDriver =
             getTimingNetState(arc.driver).requiredTime;
@@ -13136,7 +15159,7 @@ void Circuit::updateRequiredTimeLR_PT_KKT() {
       // cout << "NOT! only driving endpoint: " << net.driver->instName << endl;
       for (int k = k0; k < k1; k++) {
         const TimingArc &arc = timingArcs[k];
-        TimingArcState &arcstate = getTimingArcState(k);
+        TimingArcState arcstate = getTimingArcState(k);
 
         EdgeArray<double> lambda;
         for (int edge = 0; edge < 2; edge++) {
@@ -13168,7 +15191,7 @@ void Circuit::updateRequiredTimeLR_PT_KKT() {
 
       }  // end for
     }
-    const int outPin = net.driver->pinNetPairs.size() - 1;
+    const int outPin = net.driver->numPins - 1;
   }  // end for
 }  // end method
 
@@ -13179,20 +15202,12 @@ void Circuit::readTimingLR() {
   // store values on cells
   // shouldn't be used
 
-  Vcell *tmpCell = new Vcell;
   AddrCell tmpCell1;
   set<AddrCell>::iterator it;
   int index = 0, lastViol = 0;
   // char nada;
   string filename = rootDir + "/" + benchName + "/" + benchName + ".timing";
 
-  map<string, int> cellNameMap;
-  map<string, int>::iterator cellIndex;
-  const int cellCount = depthSortedCells.size();
-  for (int i = offsetSequential; i < cellCount; ++i) {
-    cellNameMap.insert(make_pair(depthSortedCells[i]->instName, i));
-  }
-
   worstSlack = DBL_MAX;
   double totalSlack = 0.0;
   worstSlew = 0.0;
@@ -13229,9 +15244,7 @@ void Circuit::readTimingLR() {
       // fallSlack << " " << riseTransition << " " << fallTransition << " " <<
       // riseArrival << " " << fallArrival << endl ;
 
-      cellIndex = cellNameMap.find(name1);
-
-      Vcell *cell = depthSortedCells[cellIndex->second];
+      Vcell *cell = findCell(name1);
 
       // const int c = cell->depthIndex;
       const int n = cell->sinkNetIndex;
@@ -13241,7 +15254,7 @@ void Circuit::readTimingLR() {
       const int k1 = timingArcPointers[n + 1];
       for (int k = k0; k < k1; k++) {
         if (timingArcDriverPinName[k] == name2) {
-          TimingArcState &arcstate = getTimingArcState(k);
+          TimingArcState arcstate = getTimingArcState(k);
 
           arcstate.slack.set(riseSlack, fallSlack);
           arcstate.oslew.set(riseTransition, fallTransition);
@@ -13275,20 +15288,12 @@ void Circuit::readTimingLR() {
 void Circuit::readTimingFromPT() {
   // read timing from PrimeTime
 
-  Vcell *tmpCell = new Vcell;
   AddrCell tmpCell1;
   set<AddrCell>::iterator it;
   int index = 0, lastViol = 0;
   // char nada;
   string filename = rootDir + "/" + benchName + "/" + benchName + ".timing";
 
-  map<string, int> cellNameMap;
-  map<string, int>::iterator cellIndex;
-  const int cellCount = depthSortedCells.size();
-  for (int i = offsetSequential; i < cellCount; ++i) {
-    cellNameMap.insert(make_pair(depthSortedCells[i]->instName, i));
-  }
-
   worstSlack = DBL_MAX;
   double totalSlack = 0.0;
   worstSlew = 0.0;
@@ -13325,9 +15330,7 @@ void Circuit::readTimingFromPT() {
       // fallSlack << " " << riseTransition << " " << fallTransition << " " <<
       // riseArrival << " " << fallArrival << endl ;
 
-      cellIndex = cellNameMap.find(name1);
-
-      Vcell *cell = depthSortedCells[cellIndex->second];
+      Vcell *cell = findCell(name1);
 
       // const int c = cell->depthIndex;
       const int n = cell->sinkNetIndex;
@@ -13337,7 +15340,7 @@ void Circuit::readTimingFromPT() {
       const int k1 = timingArcPointers[n + 1];
       for (int k = k0; k < k1; k++) {
         if (timingArcDriverPinName[k] == name2) {
-          TimingArcState &arcstate = getTimingArcState(k);
+          TimingArcState arcstate = getTimingArcState(k);
 
           arcstate.slack.set(riseSlack, fallSlack);
           arcstate.oslew.set(riseTransition, fallTransition);
@@ -13376,20 +15379,6 @@ void Circuit::readTimingFromPTForTimingRecovery() {
 
   string filename = rootDir + "/" + benchName + "/" + benchName + ".timing";
   // cout << filename << endl;
-  map<string, int> cellNameMap;
-
-  const int cellCount = depthSortedCells.size();
-  for (int i = 0; i < cellCount; ++i) {
-    cellNameMap.insert(make_pair(depthSortedCells[i]->instName, i));
-  }
-
-  map<string, int> netNameMap;
-
-  const int netCount = timingNets.size();
-  for (int i = 0; i < netCount; ++i) {
-    netNameMap.insert(make_pair(timingNetName[i], i));
-  }
-
   if (!fopen(filename.c_str(), "r")) return;
   // cout << " Reading timing from PrimeTime..." << endl;
 
@@ -13418,28 +15407,22 @@ void Circuit::readTimingFromPTForTimingRecovery() {
       // fallSlack << " " << riseTransition << " " << fallTransition << " " <<
       // riseArrival << " " << fallArrival << endl ;
 
-      const map<string, int>::iterator cellIndex = cellNameMap.find(name1);
+      Vcell *cell = findCell(name1);
 
-      if (cellIndex == cellNameMap.end()) continue;
+      if (!cell) continue;
 
-      const int cellDepthIndex = cellIndex->second;
+      const int cellDepthIndex = cell->depthIndex;
 
       if (max(riseTransition, fallTransition) > maxTransition) {
         ++counter;
-        Vcell *cell = depthSortedCells[cellDepthIndex];
 
-        if (depthSortedCells[cellIndex->second]->dontTouch) cout << endl;
+        if (cell->dontTouch) cout << endl;
 
         // cout << " -I- Found pin with slew violation: " << name1 << "/" <<
         // name2 << endl;
         Vcell *driverCell = NULL;
-        const int sinkNetIndex =
-            depthSortedCells[cellIndex->second]->sinkNetIndex;
-        const string netName =
-            depthSortedCells[cellIndex->second]->returnNetConnectedToPin(name2);
-
-        const map<string, int>::iterator netIndex = netNameMap.find(netName);
-        driverCell = timingNets[netIndex->second].driver;
+        const int sinkNetIndex = cell->sinkNetIndex;
+        driverCell = timingNets[findTimingNet(cell, name2)].driver;
 
         // cout << " drived by cell: " << driverCell->instName << endl;
         slewViolCells.insert(driverCell->depthIndex);
@@ -13448,11 +15431,9 @@ void Circuit::readTimingFromPTForTimingRecovery() {
       const double cellSlack = min(riseSlack, fallSlack);
       if (cellSlack > 0.0) continue;
 
-      Vcell *cell = depthSortedCells[cellIndex->second];
-
       // cout << " Inserting " << cell->instName << "\t" << cellSlack << endl;
-      pathMappedCells.insert(make_pair(cellSlack, cellIndex->second));
-      slackMappedCells.insert(make_pair(cellIndex->second, cellSlack));
+      pathMappedCells.insert(make_pair(cellSlack, cellDepthIndex));
+      slackMappedCells.insert(make_pair(cellDepthIndex, cellSlack));
 
     } else {
       // timing of a port
@@ -13508,7 +15489,7 @@ void Circuit::runDP() {
       lagrangianMap[costVectorIndex][lastOption] =
           originalLeakage + originalSizingEffect;
       // debug("tiago10", "\tCell: " << driver->instName << "(" <<
-      // driver->instType << ")\tcost: " <<
+      // driver->getTypeName() << ")\tcost: " <<
       // lagrangianMap[costVectorIndex][lastOption] << endl;);
     } else {
       for (int a = 0; a < libOptions; ++a) {
@@ -13522,7 +15503,7 @@ void Circuit::runDP() {
             costSizingEffectOnDelay;
         lagrangianMap[costVectorIndex][a] = cost;
         // debug("tiago10", "\tCell: " << driver->instName << "(" <<
-        // driver->instType << ")\tcost: " << lagrangianMap[costVectorIndex][a]
+        // driver->getTypeName() << ")\tcost: " << lagrangianMap[costVectorIndex][a]
         // << "\tfor: " << a << endl;);
       }
       updateCellType(driver, lastOption);
@@ -13545,7 +15526,7 @@ void Circuit::runDP() {
       const int k1 = timingArcPointers[i + 1];
       for (int k = k0; k < k1; k++) {
         TimingArc &arc = timingArcs[k];
-        TimingArcState &arcstate = getTimingArcState(k);
+        TimingArcState arcstate = getTimingArcState(k);
 
         Vcell *arcDriver = timingNets[arc.driver].driver;
         const int arcDriverCostVectorIndex = lagrangianMapPointers[arc.driver];
@@ -13710,7 +15691,7 @@ void Circuit::runDP() {
     const int k1 = timingArcPointers[i + 1];
     for (int k = k0; k < k1; k++) {
       TimingArc &arc = timingArcs[k];
-      TimingArcState &arcstate = getTimingArcState(k);
+      TimingArcState arcstate = getTimingArcState(k);
 
       Vcell *arcDriver = timingNets[arc.driver].driver;
 
@@ -13852,7 +15833,7 @@ bool Circuit::isRoot(const int netIndex) {  //
   const int a1 = timingSinkArcPointers[netIndex + 1];
   for (int a = a0; a < a1; ++a) {
     TimingArc &arc = timingArcs[timingSinkArcs[a]];
-    TimingArcState &arcstate = getTimingArcState(timingSinkArcs[a]);
+    TimingArcState arcstate = getTimingArcState(timingSinkArcs[a]);
     Vcell *arcDriver = timingNets[arc.driver].driver;
 
     assert(timingNets[netIndex].driver == timingNets[arc.driver].driver);
@@ -13909,7 +15890,7 @@ void Circuit::backTrack(const int netIndex) {
       lagrangianMap[costVectorIndex][lastOption] =
           alpha * originalLeakage + originalSizingEffect;
       // debug("tiago10", "\tCell: " << driver->instName << "(" <<
-      // driver->instType << ")\tcost: " <<
+      // driver->getTypeName() << ")\tcost: " <<
       // lagrangianMap[costVectorIndex][lastOption] << endl;);
     } else {
       for (int a = 0; a < libOptions; ++a) {
@@ -13924,7 +15905,7 @@ void Circuit::backTrack(const int netIndex) {
             costSizingEffectOnDelay;
         lagrangianMap[costVectorIndex][a] = cost;
         // debug("tiago10", "\tCell: " << driver->instName << "(" <<
-        // driver->instType << ")\tcost: " << lagrangianMap[costVectorIndex][a]
+        // driver->getTypeName() << ")\tcost: " << lagrangianMap[costVectorIndex][a]
         // << "\tfor: " << a << endl;);
       }
       updateCellType(driver, lastOption);
@@ -13939,7 +15920,7 @@ void Circuit::backTrack(const int netIndex) {
     const int k1 = timingArcPointers[n + 1];
     for (int k = k0; k < k1; k++) {
       TimingArc &arc = timingArcs[k];
-      TimingArcState &arcstate = getTimingArcState(k);
+      TimingArcState arcstate = getTimingArcState(k);
       Vcell *arcDriver = timingNets[arc.driver].driver;
       assert(driver == arc.cell);
       // const bool ignoredArc = ignoreArc(arc);
@@ -13981,7 +15962,7 @@ void Circuit::backTrack(const int netIndex) {
       const int k1 = timingArcPointers[i + 1];
       for (int k = k0; k < k1; k++) {
         TimingArc &arc = timingArcs[k];
-        TimingArcState &arcstate = getTimingArcState(k);
+        TimingArcState arcstate = getTimingArcState(k);
         Vcell *arcDriver = timingNets[arc.driver].driver;
         const int arcDriverCostVectorIndex = lagrangianMapPointers[arc.driver];
         double totalArcLambda = 0.0, maxArcLambda = 0.0,
@@ -14154,7 +16135,7 @@ void Circuit::backTrack(const int netIndex) {
     for (int k = k0; k < k1; k++) {
       TimingArc &arc = timingArcs[k];
       Vcell *arcDriver = timingNets[arc.driver].driver;
-      TimingArcState &arcstate = getTimingArcState(k);
+      TimingArcState arcstate = getTimingArcState(k);
 
       // const bool ignoredArc = ignoreArc(arc);
       const bool ignoredArc = ignoreArcOzdal(k, arcstate);
@@ -14260,7 +16241,7 @@ void Circuit::backTrack2(const int netIndex) {
       lagrangianMap[costVectorIndex][lastOption] =
           alpha * originalLeakage + originalSizingEffect;
       // debug("tiago10", "\tCell: " << driver->instName << "(" <<
-      // driver->instType << ")\tcost: " <<
+      // driver->getTypeName() << ")\tcost: " <<
       // lagrangianMap[costVectorIndex][lastOption] << endl;);
     } else {
       for (int a = 0; a < libOptions; ++a) {
@@ -14275,7 +16256,7 @@ void Circuit::backTrack2(const int netIndex) {
             costSizingEffectOnDelay;
         lagrangianMap[costVectorIndex][a] = cost;
         // debug("tiago10", "\tCell: " << driver->instName << "(" <<
-        // driver->instType << ")\tcost: " << lagrangianMap[costVectorIndex][a]
+        // driver->getTypeName() << ")\tcost: " << lagrangianMap[costVectorIndex][a]
         // << "\tfor: " << a << endl;);
       }
       updateCellType(driver, lastOption);
@@ -14290,7 +16271,7 @@ void Circuit::backTrack2(const int netIndex) {
     const int k1 = timingArcPointers[n + 1];
     for (int k = k0; k < k1; k++) {
       TimingArc &arc = timingArcs[k];
-      TimingArcState &arcstate = getTimingArcState(k);
+      TimingArcState arcstate = getTimingArcState(k);
       Vcell *arcDriver = timingNets[arc.driver].driver;
 
       assert(driver == arc.cell);
@@ -14349,7 +16330,7 @@ void Circuit::backTrack2(const int netIndex) {
       const int k1 = timingArcPointers[i + 1];
       for (int k = k0; k < k1; k++) {
         TimingArc &arc = timingArcs[k];
-        TimingArcState &arcstate = getTimingArcState(k);
+        TimingArcState arcstate = getTimingArcState(k);
 
         Vcell *arcDriver = timingNets[arc.driver].driver;
         const int arcDriverCostVectorIndex = lagrangianMapPointers[arc.driver];
@@ -14519,7 +16500,7 @@ void Circuit::backTrack2(const int netIndex) {
     const int k1 = timingArcPointers[i + 1];
     for (int k = k0; k < k1; k++) {
       TimingArc &arc = timingArcs[k];
-      TimingArcState &arcstate = getTimingArcState(k);
+      TimingArcState arcstate = getTimingArcState(k);
 
       Vcell *arcDriver = timingNets[arc.driver].driver;
 
@@ -14594,7 +16575,7 @@ bool Circuit::ignoreArc(TimingArc &arc, TimingArcState &arcstate) {
   for (int arcIndex = arc0; arcIndex < arc1; ++arcIndex) {
     const TimingArc &arc2 = timingArcs[timingSinkArcs[arcIndex]];
     if (!arc2.cell) continue;
-    TimingArcState &arcstate2 = getTimingArcState(timingSinkArcs[arcIndex]);
+    TimingArcState arcstate2 = getTimingArcState(timingSinkArcs[arcIndex]);
 
     totalArcLambda += arcstate2.lambda.getMax();
     maxArcLambda = max(maxArcLambda, arcstate2.lambda.getMax());
@@ -14633,8 +16614,8 @@ bool Circuit::ignoreArcOzdal(const int arcIndex, TimingArcState &arcstate) {
   int maxArcIndex = timingSinkArcs[a0];
   for (int a = a0; a < a1; ++a) {
     TimingArc &arc = timingArcs[timingSinkArcs[a]];
-    TimingArcState &arcstate2 = getTimingArcState(timingSinkArcs[a]);
-    TimingArcState &maxarcstate2 =
+    TimingArcState arcstate2 = getTimingArcState(timingSinkArcs[a]);
+    TimingArcState maxarcstate2 =
         getTimingArcState(timingSinkArcs[maxArcIndex]);
     maxArcLambda = max(maxArcLambda, arcstate2.lambda.getMax());
     if (arcstate2.lambda.getMax() > maxarcstate2.lambda.getMax()) {
@@ -14645,8 +16626,8 @@ bool Circuit::ignoreArcOzdal(const int arcIndex, TimingArcState &arcstate) {
   bool root = false;
   for (int a = a0; a < a1; ++a) {
     TimingArc &arc = timingArcs[a];
-    TimingArcState &arcstate2 = getTimingArcState(timingSinkArcs[a]);
-    TimingArcState &maxarcstate2 =
+    TimingArcState arcstate2 = getTimingArcState(timingSinkArcs[a]);
+    TimingArcState maxarcstate2 =
         getTimingArcState(timingSinkArcs[maxArcIndex]);
     if (timingSinkArcs[a] != maxArcIndex) {
       if (arcstate2.lambda.getMax() * beta > maxarcstate2.lambda.getMax()) {
@@ -14739,7 +16720,7 @@ void Circuit::setDeltaLoadSlew(const int netIndex) {
   for (int k = k0; k < k1; k++) {
     // Update arc timings.
     const TimingArc &arc = timingArcs[k];
-    TimingArcState &arcstate = getTimingArcState(k);
+    TimingArcState arcstate = getTimingArcState(k);
 
     const LibParserTimingInfo &timingInfo =
         arc.cell->actualInstType->timingArcs[arc.lut];
@@ -14811,7 +16792,7 @@ mv)).aggregate();
 */
   for (int i = timingOffsetToExtraSequentialArcs; i < numArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     LRS += -(arcstate.lambda * T).aggregate();
     div += T * T;
@@ -14822,7 +16803,7 @@ mv)).aggregate();
   for (int i = timingOffsetToCombinationArcs;
        i < timingOffsetToExtraSequentialArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const EdgeArray<double> mv =
         getTimingNetState(arc.sink).arrivalTime.getReversed() -
@@ -14836,7 +16817,7 @@ mv)).aggregate();
   // Input Timing Arcs (head)
   for (int i = 0; i < timingOffsetToCombinationArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const EdgeArray<double> mv =
         getTimingNetState(arc.sink).arrivalTime.getReversed() -
@@ -15115,7 +17096,7 @@ void Circuit::updateLambdasByOzdal() {
 
   for (int i = timingOffsetToExtraSequentialArcs; i < numArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     arcstate.slack = clk - arcstate.arrivalTime;
     // cout << arc.lambda << "\t";
@@ -15136,7 +17117,7 @@ void Circuit::updateLambdasByOzdal() {
   for (int i = timingOffsetToCombinationArcs;
        i < timingOffsetToExtraSequentialArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const EdgeArray<double> mv =
         getTimingNetState(arc.sink).arrivalTime.getReversed() -
@@ -15160,7 +17141,7 @@ void Circuit::updateLambdasByOzdal() {
   // Input Timing Arcs (head)
   for (int i = 0; i < timingOffsetToCombinationArcs; i++) {
     const TimingArc &arc = timingArcs[i];
-    TimingArcState &arcstate = getTimingArcState(i);
+    TimingArcState arcstate = getTimingArcState(i);
 
     const EdgeArray<double> mv =
         getTimingNetState(arc.sink).arrivalTime.getReversed() -
@@ -15272,8 +17253,8 @@ void Circuit::setInitialLambda() {
   const int arcSize = timingArcs.size();
   for (int i = 0; i < arcSize; ++i) {
     // Update arc timings.
-    TimingArcState &arcstate = getTimingArcState(i);
-    // cout << arc.cell->instName << "\t" << arc.cell->instType << "\t" <<
+    TimingArcState arcstate = getTimingArcState(i);
+    // cout << arc.cell->instName << "\t" << arc.cell->getTypeName() << "\t" <<
     // arc.cell->logicalDepth <<  "\t" << arc.driver << endl;
     arcstate.lambda.set(lambdaInit, lambdaInit);
   }
@@ -15290,8 +17271,8 @@ void Circuit::setInitialLambdaKKT() {
   const int arcSize = timingArcs.size();
   for (int i = 0; i < arcSize; ++i) {
     // Update arc timings.
-    TimingArcState &arcstate = getTimingArcState(i);
-    // cout << arc.cell->instName << "\t" << arc.cell->instType << "\t" <<
+    TimingArcState arcstate = getTimingArcState(i);
+    // cout << arc.cell->instName << "\t" << arc.cell->getTypeName() << "\t" <<
     // arc.cell->logicalDepth <<  "\t" << arc.driver << endl;
     arcstate.lambda.set(lambdaMin, lambdaMin);
   }
@@ -15347,7 +17328,7 @@ void Circuit::primeTimeUpdateTiming() {
     ostringstream oss;
     for (int i = 0; i < icells.size(); ++i) {
       const Vcell *tmpCell = icells[i];
-      oss << tmpCell->instName.c_str() << " " << tmpCell->instType.c_str()
+      oss << tmpCell->instName.c_str() << " " << tmpCell->getTypeName().c_str()
           << "\n";
     }  // end for
 
@@ -15862,13 +17843,6 @@ void Circuit::legalizeLoadViolPrimeTime() {
   DigestDescriptor digest(*this, "Max-Cap Violation Legalizer - PrimeTime");
   digest.print();
 
-  map<string, int> cellNameMap;
-  map<string, int>::iterator cellIndex;
-  const int cellCount = depthSortedCells.size();
-  for (int i = 0; i < cellCount; ++i) {
-    cellNameMap.insert(make_pair(depthSortedCells[i]->instName, i));
-  }
-
   const string filename = rootDir + "/" + benchName + "/" + benchName + ".ceff";
   while (true) {
     callPTCeffOnly();
@@ -15891,14 +17865,11 @@ void Circuit::legalizeLoadViolPrimeTime() {
         // std::cout << name1 << "/" << name2 << " " << riseCeff << " " <<
         // fallCeff << endl ;
 
-        cellIndex = cellNameMap.find(name1);
-
-        Vcell *cell = depthSortedCells[cellIndex->second];
+        Vcell *cell = findCell(name1);
 
         if (cell->dontTouch) continue;
 
-        const int pinIndex =
-            depthSortedCells[cellIndex->second]->returnPinIndex(name2);
+        const int pinIndex = cell->returnPinIndex(name2);
 
         const double pinMaxCapacitance =
             cell->actualInstType->pins[pinIndex].maxCapacitance;
@@ -15961,20 +17932,6 @@ void Circuit::compareTimingEngines() {
 
   string filename = rootDir + "/" + benchName + "/" + benchName + ".timing";
   string ceffFilename = rootDir + "/" + benchName + "/" + benchName + ".ceff";
-  map<string, int> cellNameMap;
-
-  const int cellCount = depthSortedCells.size();
-  for (int i = 0; i < cellCount; ++i) {
-    cellNameMap.insert(make_pair(depthSortedCells[i]->instName, i));
-  }
-
-  map<string, int> netNameMap;
-
-  const int netCount = timingNets.size();
-  for (int i = 0; i < netCount; ++i) {
-    netNameMap.insert(make_pair(timingNetName[i], i));
-  }
-
   if (!fopen(filename.c_str(), "r")) return;
 
   TimingParser tp(filename);
@@ -16013,9 +17970,7 @@ void Circuit::compareTimingEngines() {
       // fallSlack << " " << riseTransition << " " << fallTransition << " " <<
       // riseArrival << " " << fallArrival << endl ;
 
-      const map<string, int>::iterator cellIndex = cellNameMap.find(name1);
-
-      Vcell *cell = depthSortedCells[cellIndex->second];
+      Vcell *cell = findCell(name1);
 
       // const int c = cell->depthIndex;
       const int n = cell->sinkNetIndex;
@@ -16032,7 +17987,7 @@ void Circuit::compareTimingEngines() {
       const int k1 = timingArcPointers[n + 1];
       EdgeArray<double> worstCeff(0.0, 0.0);
       for (int k = k0; k < k1; k++) {
-        TimingArcState &arcstate = getTimingArcState(k);
+        TimingArcState arcstate = getTimingArcState(k);
         if (timingArcDriverPinName[k] == name2) {
           cout << name1 << "/" << name2 << ": ";
 
@@ -16088,7 +18043,7 @@ void Circuit::compareTimingEngines() {
       const int k1 = timingArcs.size();
 
       for (int k = timingOffsetToExtraPrimaryOutputArcs; k < k1; k++) {
-        TimingArcState &arcstate = getTimingArcState(k);
+        TimingArcState arcstate = getTimingArcState(k);
         TimingArc &arc = timingArcs[k];
         if (name1 == timingNetName[timingArcs[k].driver]) {
           // std::cout << "\n" << name1 << " " << riseSlack << " " << fallSlack
@@ -16117,7 +18072,7 @@ void Circuit::compareTimingEngines() {
 
   const int k1 = timingArcs.size();
   for (int k = 0; k < timingOffsetToSequentialArcs; k++) {
-    TimingArcState &arcstate = getTimingArcState(k);
+    TimingArcState arcstate = getTimingArcState(k);
     // cout << /*timingArcs[k].cell->instName << " " <<*/
     // timingNetName[timingArcs[k].sink] << " Ceff: " << arcstate.ceff << endl ;
 
@@ -16125,7 +18080,7 @@ void Circuit::compareTimingEngines() {
 
   for (int k = timingOffsetToExtraSequentialArcs;
        k < timingOffsetToExtraPrimaryOutputArcs; k++) {
-    TimingArcState &arcstate = getTimingArcState(k);
+    TimingArcState arcstate = getTimingArcState(k);
     TimingArc &arc = timingArcs[k];
     const int driverCellIndex =
         timingNets[timingArcs[k].driver].driver->depthIndex;
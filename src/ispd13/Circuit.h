@@ -27,7 +27,9 @@ using std::ostringstream;
 using std::numeric_limits;
 
 #include "ispd13/EdgeArray.h"
+#include "ispd13/ObjectPool.h"
 #include "ispd13/RCTree.h"
+#include "ispd13/Snapshot.h"
 #include "ispd13/Stopwatch.h"
 #include "ispd13/Vcell.h"
 #include "ispd13/global.h"
@@ -37,9 +39,11 @@ using std::numeric_limits;
 #endif
 
 #ifdef PARALLEL
-#include <Poco/Environment.h>
-#include <Poco/Runnable.h>
-#include <Poco/ThreadPool.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "ispd13/ThreadPool.h"
 #endif
 
 using namespace std;
@@ -86,6 +90,17 @@ class Circuit {
                                    1e-12);
     }  // end method
 
+    // Delay and slew at the same effective capacitance in a single lookup.
+    void computeDelayAndSlew(const EdgeArray<double> &ceff,
+                             EdgeArray<double> &delay,
+                             EdgeArray<double> &slew) const {
+      lookup(clsTimingInfo, ceff[RISE] * 1e15, ceff[FALL] * 1e15,
+             clsInputSlew[RISE], clsInputSlew[FALL], delay[RISE], delay[FALL],
+             slew[RISE], slew[FALL]);
+      delay *= 1e-12;
+      slew *= 1e-12;
+    }  // end method
+
     EdgeArray<double> getInputSlew() const { return clsInputSlew * 1e-12; }
 
   };  // end class
@@ -309,67 +324,198 @@ class Circuit {
     }  // end constructor
   };   // end struct
 
-  struct TimingArcState {
-    EdgeArray<double> islew;  //  input slew at this arc
-    EdgeArray<double> oslew;  // output slew at this arc
+  struct TreeNodePointer {
+    int arc;   // timing arc node driving by the tree node
+    int node;  // tree node index inside the tree
+
+    TreeNodePointer(const int arcIndex, const int nodeIndex) {
+      arc = arcIndex;
+      node = nodeIndex;
+    }  // end constructor
+  };   // end class
 
-    EdgeArray<double> delay;   // delay of this arc
-    EdgeArray<double> lambda;  // Lagrange Relaxation
+  // Timing state is stored as a structure of arrays, one array per field, so
+  // sweeps touching only a few fields (e.g. lambdas or required times)
+  // stream through contiguous memory. Hot loops should index these arrays
+  // directly. See TimingArcState and TimingNetState for per-arc/net access.
+  struct ArcStateArrays {
+    vector<EdgeArray<double> > islew;  //  input slew at this arc
+    vector<EdgeArray<double> > oslew;  // output slew at this arc
 
-    EdgeArray<double> rcdelay;  // delay at input of this arc due to rc tree
-    EdgeArray<double> ceff;     // effective capacitance driven by this arc
+    vector<EdgeArray<double> > delay;   // delay of this arc
+    vector<EdgeArray<double> > lambda;  // Lagrange Relaxation
 
-    EdgeArray<double> arrivalTime;   // arrival time at the input of this arc
-    EdgeArray<double> requiredTime;  // required time at the input of this arc
+    vector<EdgeArray<double> > rcdelay;  // delay at input of this arc due to
+                                         // rc tree
+    vector<EdgeArray<double> > ceff;     // effective capacitance driven by
+                                         // this arc
 
-    double loadViolation;  // load violation based on ceff
+    vector<EdgeArray<double> > arrivalTime;   // arrival time at the input of
+                                              // this arc
+    vector<EdgeArray<double> > requiredTime;  // required time at the input of
+                                              // this arc
+
+    vector<double> loadViolation;  // load violation based on ceff
 
     // Reimann
-    EdgeArray<double>
+    vector<EdgeArray<double> >
         slack;  // slack (m_u->v) (worst arrival time + arc delay + worst delay
                 // to endpoint) [TODO] consider moving to outside
 
-    TimingArcState() { lambda.set(-1.0, -1.0); }  // end constructor
-  };
+    int size() const { return lambda.size(); }
+
+    void resize(const int n) {
+      islew.resize(n);
+      oslew.resize(n);
+      delay.resize(n);
+      lambda.resize(n, EdgeArray<double>(-1.0, -1.0));
+      rcdelay.resize(n);
+      ceff.resize(n);
+      arrivalTime.resize(n);
+      requiredTime.resize(n);
+      loadViolation.resize(n, 0);
+      slack.resize(n);
+    }  // end method
+  };   // end struct
 
-  struct TimingNetState {
-    double
+  struct NetStateArrays {
+    vector<double>
         load;  // total net load (due to wires, input pins and primary outputs)
-    double loadViolation;            // load violation based on ceff
-    EdgeArray<double> slew;          // slew in this net
-    EdgeArray<double> arrivalTime;   // arrival time at this net
-    EdgeArray<double> requiredTime;  // required time at the driver of this net
-    EdgeArray<int> backtrack;      // index of net driving the driver input with
-                                   // greatest arrival time
-    EdgeArray<int> backtrackSlew;  // index of net driving the driver input with
-                                   // greatest slew
-
-    EdgeArray<double> worstRCDelay;  // worst rc tree delay at sinks
+    vector<double> loadViolation;            // load violation based on ceff
+    vector<EdgeArray<double> > slew;         // slew in this net
+    vector<EdgeArray<double> > arrivalTime;  // arrival time at this net
+    vector<EdgeArray<double> > requiredTime;  // required time at the driver of
+                                              // this net
+    vector<EdgeArray<int> > backtrack;  // index of net driving the driver input
+                                        // with greatest arrival time
+    vector<EdgeArray<int> > backtrackSlew;  // index of net driving the driver
+                                            // input with greatest slew
+
+    vector<EdgeArray<double> > worstRCDelay;  // worst rc tree delay at sinks
 
     // Reimann
-    EdgeArray<double> lambdaDelay;  // sum(lambda_arcs)
-
-    TimingNetState() {
-      load = 0;
-      slew.set(0, 0);
-    }  // end constructor
-  };
-
-  struct TreeNodePointer {
-    int arc;   // timing arc node driving by the tree node
-    int node;  // tree node index inside the tree
-
-    TreeNodePointer(const int arcIndex, const int nodeIndex) {
-      arc = arcIndex;
-      node = nodeIndex;
-    }  // end constructor
-  };   // end class
+    vector<EdgeArray<double> > lambdaDelay;  // sum(lambda_arcs)
+
+    int size() const { return load.size(); }
+
+    void resize(const int n) {
+      load.resize(n, 0);
+      loadViolation.resize(n, 0);
+      slew.resize(n, EdgeArray<double>(0, 0));
+      arrivalTime.resize(n);
+      requiredTime.resize(n);
+      backtrack.resize(n);
+      backtrackSlew.resize(n);
+      worstRCDelay.resize(n);
+      lambdaDelay.resize(n);
+    }  // end method
+  };   // end struct
 
   struct State {
-    vector<TimingArcState> arcs;
-    vector<TimingNetState> nets;
+    ArcStateArrays arcs;
+    NetStateArrays nets;
   };
 
+  // View over the state of a single arc. It only binds references to the
+  // state arrays, so it is cheap to create and writes go to the state.
+  struct TimingArcState {
+    EdgeArray<double> &islew;
+    EdgeArray<double> &oslew;
+    EdgeArray<double> &delay;
+    EdgeArray<double> &lambda;
+    EdgeArray<double> &rcdelay;
+    EdgeArray<double> &ceff;
+    EdgeArray<double> &arrivalTime;
+    EdgeArray<double> &requiredTime;
+    double &loadViolation;
+    EdgeArray<double> &slack;
+
+    TimingArcState(ArcStateArrays &arcs, const int k)
+        : islew(arcs.islew[k]),
+          oslew(arcs.oslew[k]),
+          delay(arcs.delay[k]),
+          lambda(arcs.lambda[k]),
+          rcdelay(arcs.rcdelay[k]),
+          ceff(arcs.ceff[k]),
+          arrivalTime(arcs.arrivalTime[k]),
+          requiredTime(arcs.requiredTime[k]),
+          loadViolation(arcs.loadViolation[k]),
+          slack(arcs.slack[k]) {}  // end constructor
+  };                               // end struct
+
+  // View over the state of a single net.
+  struct TimingNetState {
+    double &load;
+    double &loadViolation;
+    EdgeArray<double> &slew;
+    EdgeArray<double> &arrivalTime;
+    EdgeArray<double> &requiredTime;
+    EdgeArray<int> &backtrack;
+    EdgeArray<int> &backtrackSlew;
+    EdgeArray<double> &worstRCDelay;
+    EdgeArray<double> &lambdaDelay;
+
+    TimingNetState(NetStateArrays &nets, const int n)
+        : load(nets.load[n]),
+          loadViolation(nets.loadViolation[n]),
+          slew(nets.slew[n]),
+          arrivalTime(nets.arrivalTime[n]),
+          requiredTime(nets.requiredTime[n]),
+          backtrack(nets.backtrack[n]),
+          backtrackSlew(nets.backtrackSlew[n]),
+          worstRCDelay(nets.worstRCDelay[n]),
+          lambdaDelay(nets.lambdaDelay[n]) {}  // end constructor
+  };                                           // end struct
+
+  // Read-only views, returned by the const get methods.
+  struct ConstTimingArcState {
+    const EdgeArray<double> &islew;
+    const EdgeArray<double> &oslew;
+    const EdgeArray<double> &delay;
+    const EdgeArray<double> &lambda;
+    const EdgeArray<double> &rcdelay;
+    const EdgeArray<double> &ceff;
+    const EdgeArray<double> &arrivalTime;
+    const EdgeArray<double> &requiredTime;
+    const double &loadViolation;
+    const EdgeArray<double> &slack;
+
+    ConstTimingArcState(const ArcStateArrays &arcs, const int k)
+        : islew(arcs.islew[k]),
+          oslew(arcs.oslew[k]),
+          delay(arcs.delay[k]),
+          lambda(arcs.lambda[k]),
+          rcdelay(arcs.rcdelay[k]),
+          ceff(arcs.ceff[k]),
+          arrivalTime(arcs.arrivalTime[k]),
+          requiredTime(arcs.requiredTime[k]),
+          loadViolation(arcs.loadViolation[k]),
+          slack(arcs.slack[k]) {}  // end constructor
+  };                               // end struct
+
+  struct ConstTimingNetState {
+    const double &load;
+    const double &loadViolation;
+    const EdgeArray<double> &slew;
+    const EdgeArray<double> &arrivalTime;
+    const EdgeArray<double> &requiredTime;
+    const EdgeArray<int> &backtrack;
+    const EdgeArray<int> &backtrackSlew;
+    const EdgeArray<double> &worstRCDelay;
+    const EdgeArray<double> &lambdaDelay;
+
+    ConstTimingNetState(const NetStateArrays &nets, const int n)
+        : load(nets.load[n]),
+          loadViolation(nets.loadViolation[n]),
+          slew(nets.slew[n]),
+          arrivalTime(nets.arrivalTime[n]),
+          requiredTime(nets.requiredTime[n]),
+          backtrack(nets.backtrack[n]),
+          backtrackSlew(nets.backtrackSlew[n]),
+          worstRCDelay(nets.worstRCDelay[n]),
+          lambdaDelay(nets.lambdaDelay[n]) {}  // end constructor
+  };                                           // end struct
+
   State timingStateCurrent;
   State timingStateStored;
 
@@ -437,8 +583,53 @@ class Circuit {
   double timingTotalPositiveSlack;
   double timingTotalAbsoluteSlack;
 
-  // Used for thread-safe slew calculation.
-  vector<double> timingViolationSlewVector;
+  // Changes on the violation totals not reduced yet. Serial code writes slot
+  // 0. Parallel code writes the slot of the work item it runs, 1 + n when
+  // updating net n and 1 + k when sizing the k-th cell of
+  // timingPseudIndependentSets, so each slot has a single writer. Slots are
+  // folded into the totals in index order by updateTiming_Violations(), which
+  // makes the totals independent of the schedule and of the thread count.
+  struct TimingViolationSlot {
+    double slew;
+    double load;
+    double loadCellWise;
+
+    TimingViolationSlot() : slew(0), load(0), loadCellWise(0) {}
+  };  // end struct
+
+  vector<TimingViolationSlot> timingViolationSlots;
+
+  // Rounded slack of each path-end arc (timing arcs starting at
+  // timingOffsetToExtraSequentialArcs) in hundredths of the time unit. Slack
+  // totals are integer sums of these values, so incremental updates give
+  // exactly the same totals as a full sweep.
+  vector<EdgeArray<int> > timingEndpointSlack;
+  long long timingTotalNegativeSlackHundredths;
+  long long timingTotalPositiveSlackHundredths;
+  long long timingTotalAbsoluteSlackHundredths;
+
+  // Copy-on-write timing state used to evaluate sizing candidates without
+  // writing timingStateCurrent. openTimingOverlay() copies the arcs and nets
+  // written by the local timing update of a net; everything else is read
+  // from timingStateCurrent. Violation changes are kept in the overlay and
+  // only reach a violation slot when the stored state is committed.
+  struct TimingOverlay {
+    State current;
+    State stored;
+    TimingViolationSlot violationCurrent;
+    TimingViolationSlot violationStored;
+
+    vector<int> arcs;    // original index of the copied arcs
+    vector<int> nets;    // original index of the copied nets
+    vector<int> arcMap;  // original arc index -> copied arc or -1
+    vector<int> netMap;  // original net index -> copied net or -1
+  };  // end struct
+
+  vector<TimingOverlay> timingOverlays;  // one per thread
+
+  void openTimingOverlay(TimingOverlay &overlay, const int n);
+  void storeTimingOverlay(TimingOverlay &overlay);
+  void commitTimingOverlay(TimingOverlay &overlay, const int slot);
 
   int timingNumPathsWithNegativeSlack;
 
@@ -456,11 +647,37 @@ class Circuit {
   // context (arrival time, input slews) changed significantly. Also the load
   // seen by the cells inside a same set will never be affected by changes
   // in other cells in the same set.
+  //
+  // Sets store the output net of the cells. Local nets of a net in a set are
+  // not read by the local timing update of any other net in the same set, so
+  // the cells of a set can be sized concurrently. Each net appears once.
 
   int timingNumPseudoIndependentSets;
   vector<int> timingPseudIndependentSets;
   vector<int> timingPseudIndependentSetPointers;
 
+  // Level-bucketed frontier used by the incremental timing updates. Nets are
+  // queued in the bucket of their logical depth, at most once per pass (see
+  // timingFrontierStamp), and buckets are swept in depth order.
+  vector<vector<int> > timingFrontier;
+  vector<int> timingFrontierStamp;
+  int timingFrontierCurrentStamp;
+  int timingFrontierMinDepth;
+  int timingFrontierMaxDepth;
+
+  // Nets updated by the last call to updateTiming(Vcell *).
+  vector<int> timingFrontierUpdatedNets;
+
+  // Nets updated by updateTiming(Vcell *) since required times were last
+  // updated. They seed updateRequiredTimeFromSeeds(). When too many nets
+  // pile up, or after a full timing update, required times are flagged as
+  // outdated and the next update is a full one.
+  vector<int> timingRequiredTimeSeeds;
+  bool timingRequiredTimeOutdated;
+
+  void startTimingFrontier();
+  void pushTimingFrontier(const int n);
+
   // Stores locals nets of a net. Local nets include the net itself. Also
   // local nets are stored in topological order.
   vector<int> timingLocalNets;
@@ -492,16 +709,75 @@ class Circuit {
   vector<RCTree> timingTrees;
   vector<RCTreeDescriptor> timingTreeDescriptors;
 
+  // Seed the Ceff iteration of an arc with the Ceff converged in its last
+  // update instead of the lumped capacitance. On unless the -rc-no-warm-start
+  // command line option is given.
+  bool timingRCTreeWarmStart;
+
+  // A driver arc reuses the RC tree simulation of a previous driver arc of
+  // the same net when their input slews, and their delays and slews at the
+  // simulated Ceff, differ at most by this relative tolerance. Zero disables
+  // the reuse (exact mode). Defaults to the -rc-sharing <tolerance> command
+  // line option. See reportRCTreeSharingError().
+  double timingRCTreeSharingTolerance;
+
+  // Compute Ceff in closed form from the cached pi-model of the RC tree
+  // (see RCTree::simulatePiModel()). Nets whose shielded fraction of the
+  // lumped capacitance exceeds timingRCTreeMaxShielding are simulated as
+  // usual. Default to the -rc-pi-model and -rc-max-shielding <fraction>
+  // command line options.
+  bool timingRCTreePiModel;
+  double timingRCTreeMaxShielding;
+
+  // Read the SPEF with the original tokenizing parser instead of the
+  // memory-mapped one. Defaults to the -spef-legacy-parser command line
+  // option.
+  bool spefLegacyParser;
+
+  // Compare both SPEF parsers (see checkSPEFParsers()) before the SPEF is
+  // read. Defaults to the -spef-check-parsers command line option.
+  bool spefCheckParsers;
+
+  // Read the verilog with the original tokenizing parser instead of the
+  // memory-mapped one. Defaults to the -verilog-legacy-parser command line
+  // option.
+  bool verilogLegacyParser;
+
+  // Snapshot of the parsed design. When it was built from library, verilog,
+  // SDC and SPEF files with the same contents (size and checksum) and with
+  // the same reduction tolerance, the netlist, the net to cell table, the RC
+  // tree descriptors and the timing graph are loaded from it instead of
+  // being parsed and built. Otherwise they are built as usual and written
+  // to it. Library and SDC are still parsed. Empty disables snapshots.
+  // Defaults to the -snapshot command line option. See openSnapshot().
+  string snapshotFile;
+  SnapshotReader snapshotReader;  // open while sections are being loaded
+  SnapshotWriter snapshotWriter;  // sections built so far, when saving
+
+  // Non-terminal RC tree nodes whose time constant is below this fraction of
+  // the max Elmore delay of the net are removed when the SPEF is read (see
+  // RCTreeDescriptor::reduce()). Zero disables the reduction. Defaults to
+  // the -rc-reduction <tolerance> command line option.
+  double timingRCTreeReductionTolerance;
+  RCTreeDescriptor::ReductionStats timingRCTreeReductionStats;
+
   vector<int> timingTreeNodePointers;
   vector<TreeNodePointer> timingTreeNodes;
 
   void buildTimingStructure();
+  void buildTimingGraph();
+  void initializeTimingGraphState();
   void buildTreeStructure();
-  void updateTiming_Net(const int n, const int threadId = 0);
-  void updateTiming_Nets(const int n0, const int n1,
-                         const int threadId = 0);  // [n0,n1)
+  void updateTiming_Net(const int n, const int slot = 0);
+  void updateTiming_Net(const int n, TimingViolationSlot &violation,
+                        TimingOverlay *overlay);
+  void updateTiming_Nets(const int n0, const int n1);  // [n0,n1), slot 1 + n
   void updateTiming_WorstArrivalTime();
-  void updateTiming_SlewViolation();
+  // Only path ends driven by the given nets are revisited.
+  void updateTiming_WorstArrivalTime(const vector<int> &nets);
+  void updateTiming_EndpointSlack(const int k, const double T);
+  // Folds slot 0 and then the slots of work items [i0, i1) into the totals.
+  void updateTiming_Violations(const int i0 = 0, const int i1 = 0);
   void updateTiming_Deprecated();
   void updateTiming_Debug();
 
@@ -513,6 +789,10 @@ class Circuit {
   void updateTimingLocally(const int n);
   void updateTimingLocallyIncludingSideNets(const int n);
 
+  // Same as updateTimingLocally(), but the timing is written to an overlay
+  // opened for net n.
+  void updateTimingLocally(const int n, TimingOverlay &overlay);
+
   // Update timing regardless RC Tree. Suppose RC Tree timing is linearly
   // dependent of load.
   void updateTiming_Net_LinearApproximation(const int n);
@@ -525,12 +805,14 @@ class Circuit {
   void updateTimingDriverCell(const int n);
 
   // Refer to Li Li paper.
-  double computeSizingEffectOnLambdaDelay(const int n);
+  double computeSizingEffectOnLambdaDelay(const int n,
+                                          TimingOverlay *overlay = NULL);
   double computeSizingEffectOnLambdaDelaySensitivities(const int n);
   double computeSizingEffectOnDelayWithoutLambda(const int n);
 
   // [TODO] Explain them :)
-  double computeSizingEffectOnLocalNegativeSlack(const int n);
+  double computeSizingEffectOnLocalNegativeSlack(
+      const int n, TimingOverlay *overlay = NULL);
   double computeSizingEffectOnLocalPositiveSlack(const int n);
   double computeSizingEffectOnAbsoluteSlack(const int n);
   double computeSizingEffectOnExpectedArrivalTime(const int n);
@@ -579,7 +861,20 @@ class Circuit {
 
   set<Wire> wires;
   // set< AddrCell > icells_addr;
-  map<string, Net> nets;
+
+  // Netlist as read from the verilog. Nets are identified by their ids in
+  // netlist.netNames and cell i of the netlist is icells[i].
+  VerilogFlatNetlist netlist;
+
+  // Distinct cells connected to net n are in [netCellPointers[n],
+  // netCellPointers[n + 1]) of netCells. netNumPins[n] counts the pins of
+  // net n, including the primary output port.
+  vector<int> netCellPointers;
+  vector<Vcell *> netCells;
+  vector<int> netNumPins;
+
+  // Timing net of each netlist net or -1. Built by buildTimingStructure().
+  vector<int> timingNetIndexes;
 
   Vcell graphRoot;
 
@@ -639,10 +934,46 @@ class Circuit {
   double alpha;
 
   void readVerilog();
+  void readVerilogLegacy(const string &filename);
   void readLib();
   void sortCells();
   void readSDC();
   void readSPEF();
+  // Per-net data read from the SPEF besides the RC tree.
+  struct SpefNetInfo {
+    string name;
+    double lumpedCap;
+    double totalCap;  // sum of the net capacitances (fF)
+  };
+
+  void readSPEFSections(const string &filename, vector<SpefNetInfo> &infos);
+
+  // Snapshot sections, in file order. Load methods return false and close
+  // the snapshot, leaving the data they fill untouched, if the section is
+  // malformed.
+  void openSnapshot();
+  void saveSnapshot();
+  bool loadNetlistSnapshot(vector<int> &netCellIndexes);
+  void saveNetlistSnapshot();
+  bool loadRCTreeSnapshot(vector<SpefNetInfo> &infos);
+  void saveRCTreeSnapshot(const vector<SpefNetInfo> &infos);
+  bool loadTimingGraphSnapshot();
+  void saveTimingGraphSnapshot();
+  void finishTreeDescriptor(RCTreeDescriptor &dscp,
+                            const vector<int> &terminals, const int driver,
+                            RCTreeDescriptor::ReductionStats &stats) const;
+  void addSPEFWire(const string &netName, const double netLumpedCap,
+                   const double totalCap, int &countWires);
+
+  // Fill the descriptor with the net parasitics. Terminals are the nodes
+  // connected to pins or ports and driver is the one driving the net (-1 if
+  // none).
+  static void buildTreeDescriptor(const SpefNet &spefNet,
+                                  RCTreeDescriptor &dscp,
+                                  vector<int> &terminals, int &driver);
+  static void buildTreeDescriptor(const SpefFlatNet &spefNet,
+                                  RCTreeDescriptor &dscp,
+                                  vector<int> &terminals, int &driver);
 
   void setInitialLambda();
   void setInitialLambdaKKT();
@@ -656,35 +987,36 @@ class Circuit {
 
 #ifdef PARALLEL
 
-  class Worker : public Poco::Runnable {
-   private:
-    Circuit *circuit;
-    int n0;
-    int n1;
-    int threadId;
-
-   public:
-    void setup(Circuit *circuit, const int n0, const int n1,
-               const int threadId) {
-      this->circuit = circuit;
-      this->n0 = n0;
-      this->n1 = n1;
-      this->threadId = threadId;
-    }  // end method
-
-    virtual void run() {
-      circuit->updateTiming_Nets(n0, n1, threadId);
-    }  // end method
-  };   // end class
-
-  Poco::ThreadPool myThreadPool;
+  ThreadPool threadPool;
 
   void setupMultithreading(const int numThreads = 0);
+  void setupTaskGraph();
+
+  void updateTiming_TaskGraph(const int threadId, const int n);
 
   int threadNumThreads;
 
+  // Chunks of nets per logical level, [threadNetPointers[depth][i],
+  // threadNetPointers[depth][i+1]). Chunks have about the same cost, which is
+  // estimated from the RC tree size and the number of driver arcs of a net.
   vector<vector<int> > threadNetPointers;
-  vector<vector<Worker> > threadWorkers;
+
+  // Chunks of each pseudo-independent set, [threadSetPointers[s][i],
+  // threadSetPointers[s][i+1]) indexing timingPseudIndependentSets.
+  vector<vector<int> > threadSetPointers;
+
+  // Solves the Lagrangian subproblem one pseudo-independent set at a time.
+  // Cells of a set are sized concurrently and totals are reduced between
+  // sets. Returns the number of cells that changed.
+  int sizingLagrangeRelaxationParallel(const double alpha = 1.0);
+
+  // Task graph. A net becomes ready when all of its driver nets (see
+  // timingDriverNets) were updated. Dummy nets are never updated, so they
+  // are not counted as dependencies.
+  int threadTaskNumTasks;
+  vector<int> threadTaskInDegree;  // non-dummy driver nets of net i
+  vector<int> threadTaskRoots;     // nets driven only by dummy nets
+  std::unique_ptr<std::atomic<int>[]> threadTaskPendingDrivers;
 
 #endif
 
@@ -692,6 +1024,11 @@ class Circuit {
   string rootDir, benchName;
   double maxLeakage, maxTimingViol, maxWorstSlack;
 
+  // Storage of all cells, including input drivers. Cells read from the
+  // netlist are contiguous and in netlist order. They are released together
+  // with the circuit.
+  ObjectPool<Vcell> cellPool;
+
   // Stores cell pointers not including input drivers in no specific order.
   vector<Vcell *> icells;
 
@@ -842,6 +1179,7 @@ class Circuit {
 
   // Update loads for a changed cell (update previous cells loads)
   void updateLoads(Vcell *changedCell);
+  void updateLoads(Vcell *changedCell, double &loadViolation);
 
   // Set new cell size for a overloaded cell
   void setNewCellSize(Vcell *tmpCell);
@@ -852,9 +1190,14 @@ class Circuit {
 
   void changeCellsGraci();
 
+  // Sets the pin capacitances seen by the RC tree driven by the cell. Trees
+  // only update nodes whose capacitance actually changed (see
+  // RCTree::setNodeExtraCap()), so resizing a sink costs O(depth).
   void updateCellLoad(Vcell *cell);
   void updateCellTiming(Vcell *cell);
   void updateCellType(Vcell *cell, int typeIndex);
+  void updateCellType(Vcell *cell, const int typeIndex, double &loadViolation,
+                      double &leakage, double &area);
   void updateTopCriticalTailNets();
 
   // [TODO] Explain...
@@ -863,6 +1206,72 @@ class Circuit {
 
   // [TODO] Explain...
   bool updateCellTypeLagrangeRelaxation(Vcell *cell, const double alpha = 1.0);
+
+  // Evaluates the given candidates with the overlay and scratch of thread
+  // threadId. Changes on the totals are left in the violation and sizing
+  // slots given by slot, see updateTiming_Violations() and
+  // updateSizing_Totals().
+  bool updateCellTypeLagrangeRelaxation(Vcell *cell, const vector<int> &candidates,
+                                        const double alpha, const int threadId,
+                                        const int slot);
+
+  // Same as updateCellTypeLagrangeRelaxation(), but totals are not reduced.
+  // When sizingPruneCandidates is set, this is a pruning heuristic: candidates
+  // are ranked by estimateCellTypeCandidatesLagrangeRelaxation() and only the
+  // most promising ones are evaluated with the local timing engine. Otherwise
+  // every candidate is evaluated.
+  bool updateCellTypeLagrangeRelaxationPruned(Vcell *cell,
+                                              const double alpha = 1.0,
+                                              const int threadId = 0,
+                                              const int slot = 0);
+
+  // Estimates the local lambda-delay plus leakage cost of every candidate type
+  // of a cell in a single pass over its local arcs, without touching the
+  // circuit state. Uses first order models: effective capacitances of the
+  // driver nets scale with the input pin capacitance change and slew changes
+  // are propagated one stage forward. Arc rc delays are kept. Costs are left
+  // in scratch.candidateCosts.
+  struct SizingThreadScratch;
+  void estimateCellTypeCandidatesLagrangeRelaxation(
+      Vcell *cell, const double alpha, SizingThreadScratch &scratch);
+
+  // Max number of candidates evaluated exactly after pruning.
+  static constexpr int SIZING_NUM_EXACT_CANDIDATES = 2;
+
+  // Prune the candidates of the Lagrangian subproblem with the first order
+  // estimation. This is faster, but changes the solution, as candidates
+  // estimated not to improve the cost are never timed. Defaults to the
+  // -lr-prune-candidates command line option.
+  bool sizingPruneCandidates;
+
+  // Per-thread scratch of the Lagrangian subproblem solver.
+  struct alignas(64) SizingThreadScratch {
+    vector<double> candidateCosts;
+    vector<int> candidates;
+
+    // Per candidate changes used by the estimation.
+    vector<EdgeArray<double> > deltaInputSlew;
+    vector<double> deltaLoad;
+    vector<EdgeArray<double> > deltaSlew;
+    vector<EdgeArray<double> > deltaOutputSlew;
+  };  // end struct
+
+  vector<SizingThreadScratch> sizingThreadScratch;
+
+  // Changes on the downstream load violation, leakage and area not reduced
+  // yet. Indexed and folded into the totals as the violation slots (see
+  // TimingViolationSlot and updateSizing_Totals()).
+  struct SizingTotalsSlot {
+    double loadViolation;
+    double leakage;
+    double area;
+
+    SizingTotalsSlot() : loadViolation(0), leakage(0), area(0) {}
+  };  // end struct
+
+  vector<SizingTotalsSlot> sizingTotalsSlots;
+
+  void updateSizing_Totals(const int i0 = 0, const int i1 = 0);
   bool updateCellTypeLagrangeRelaxationLinearApproximation(
       Vcell *cell, const double alpha = 1.0);
   bool updateCellTypeLagrangeRelaxationSensitivitiesLinearApproximation(
@@ -912,6 +1321,20 @@ class Circuit {
   // Print some library stats.
   void printLibraryReport(ostream &out);
 
+  // Print RC tree stats including the Ceff iteration counters. The flows in
+  // main.cpp print it at the end when the -rc-report option is given.
+  void printRCTreeReport(ostream &out);
+
+  // Compares the timing computed sharing RC tree simulations among driver
+  // arcs (see timingRCTreeSharingTolerance) against the exact timing. Timing
+  // is left updated with the current tolerance. The flows in main.cpp print
+  // it at the end when the -rc-sharing option is given.
+  void reportRCTreeSharingError(ostream &out);
+
+  // Reads the SPEF with both parsers and compares the RC tree descriptors
+  // they produce. Returns true if they are identical.
+  bool checkSPEFParsers(ostream &out);
+
   // Generate a sight visualization file.
   void printSigth(const string &filename);
 
@@ -1251,6 +1674,7 @@ class Circuit {
   void updateTiming();
   void updateTimingSingleThreaded();
   void updateTimingMultiThreaded();
+  void updateTimingMultiThreadedLevelized();
 
   void updateTimingLR();
   void updateTimingLR_KKT();
@@ -1302,6 +1726,12 @@ class Circuit {
   // timing (arrival times) has been computed. Note that calling this method
   // is not necessary if only slacks at path tails are required.
   void updateRequiredTime();
+
+  // Updates required times after one or more calls to updateTiming(cell).
+  // Starts from the nets whose timing was updated (timingRequiredTimeSeeds)
+  // and propagates back while required times keep changing, so the result is
+  // the same as the one of updateRequiredTime().
+  void updateRequiredTimeFromSeeds();
   // Also updates lambdas used in Lagrangian Relaxation
   void updateRequiredTimeLR();
   void updateRequiredTimeLR_KKT();
@@ -1358,6 +1788,13 @@ class Circuit {
     return fabs(x - y) / max(fabs(x), fabs(y)) <= precision;
   }  // end method
 
+  static bool nearlyEqual(const EdgeArray<double> &x,
+                          const EdgeArray<double> &y,
+                          const double precision = EPSILON) {
+    return nearlyEqual(x[RISE], y[RISE], precision) &&
+           nearlyEqual(x[FALL], y[FALL], precision);
+  }  // end method
+
   // Checks if a number is approximately zero.
   static bool nearlyZero(const double v, const double precision = EPSILON) {
     return fabs(v) < precision;
@@ -1374,34 +1811,47 @@ class Circuit {
   // Get Methods
   // -------------------------------------------------------------------------
 
-  const TimingArcState &getTimingArcState(const int k) const {
-    return timingStateCurrent.arcs[k];
+  ConstTimingArcState getTimingArcState(const int k) const {
+    return ConstTimingArcState(timingStateCurrent.arcs, k);
   }
-  const TimingNetState &getTimingNetState(const int n) const {
-    return timingStateCurrent.nets[n];
+  ConstTimingNetState getTimingNetState(const int n) const {
+    return ConstTimingNetState(timingStateCurrent.nets, n);
   }
 
-  const TimingArcState &getTimingArcState(const int k,
-                                          const State &state) const {
-    return state.arcs[k];
+  ConstTimingArcState getTimingArcState(const int k,
+                                        const State &state) const {
+    return ConstTimingArcState(state.arcs, k);
   }
-  const TimingNetState &getTimingNetState(const int n,
-                                          const State &state) const {
-    return state.nets[n];
+  ConstTimingNetState getTimingNetState(const int n,
+                                        const State &state) const {
+    return ConstTimingNetState(state.nets, n);
   }
 
-  TimingArcState &getTimingArcState(const int k) {
-    return timingStateCurrent.arcs[k];
+  TimingArcState getTimingArcState(const int k) {
+    return TimingArcState(timingStateCurrent.arcs, k);
   }
-  TimingNetState &getTimingNetState(const int n) {
-    return timingStateCurrent.nets[n];
+  TimingNetState getTimingNetState(const int n) {
+    return TimingNetState(timingStateCurrent.nets, n);
   }
 
-  TimingArcState &getTimingArcState(const int k, State &state) {
-    return state.arcs[k];
+  TimingArcState getTimingArcState(const int k, State &state) {
+    return TimingArcState(state.arcs, k);
   }
-  TimingNetState &getTimingNetState(const int n, State &state) {
-    return state.nets[n];
+  TimingNetState getTimingNetState(const int n, State &state) {
+    return TimingNetState(state.nets, n);
+  }
+
+  // Views into the overlay when it holds a copy of the arc/net, otherwise
+  // into timingStateCurrent. overlay may be NULL.
+  TimingArcState getTimingArcState(const int k, TimingOverlay *overlay) {
+    if (overlay && overlay->arcMap[k] != -1)
+      return TimingArcState(overlay->current.arcs, overlay->arcMap[k]);
+    return TimingArcState(timingStateCurrent.arcs, k);
+  }
+  TimingNetState getTimingNetState(const int n, TimingOverlay *overlay) {
+    if (overlay && overlay->netMap[n] != -1)
+      return TimingNetState(overlay->current.nets, overlay->netMap[n]);
+    return TimingNetState(timingStateCurrent.nets, n);
   }
 
   double getAvgNumberOfSinks() const { return avgNumberOfSinks; }
@@ -1409,6 +1859,24 @@ class Circuit {
   int getPathTailsSize() const { return this->pathTails.size(); }
   int getSize() const { return this->icells.size(); }
 
+  // Cell with the given instance name or NULL.
+  Vcell *findCell(const string &instName) const {
+    const int id = netlist.instNames.find(instName);
+    return id == -1 ? NULL : icells[id];
+  }  // end method
+
+  // Index of the timing net with the given name or -1.
+  int findTimingNet(const string &netName) const {
+    const int id = netlist.netNames.find(netName);
+    return id == -1 ? -1 : timingNetIndexes[id];
+  }  // end method
+
+  // Index of the timing net connected to the given pin of a cell or -1.
+  int findTimingNet(const Vcell *cell, const string &pinName) const {
+    const int id = cell->findNetConnectedToPin(netlist, pinName);
+    return id == -1 ? -1 : timingNetIndexes[id];
+  }  // end method
+
   const string &getBenchmarkName() const { return benchName; }
   int getNumTailNets() const { return timingTailNets.size(); }
   int getNumPathsWithNegativeSlack() const {
@@ -1437,15 +1905,15 @@ class Circuit {
   }  // end method
 
   EdgeArray<double> getNetSlack(const int n) const {
-    const TimingNetState &s = getTimingNetState(n);
+    const ConstTimingNetState s = getTimingNetState(n);
     return s.requiredTime - s.arrivalTime;
   }
   EdgeArray<double> getNetNegativeSlack(const int n) const {
-    const TimingNetState &s = getTimingNetState(n);
+    const ConstTimingNetState s = getTimingNetState(n);
     return min(EdgeArray<double>(0, 0), s.requiredTime - s.arrivalTime);
   }
   EdgeArray<double> getNetPositiveSlack(const int n) const {
-    const TimingNetState &s = getTimingNetState(n);
+    const ConstTimingNetState s = getTimingNetState(n);
     return max(EdgeArray<double>(0, 0), s.requiredTime - s.arrivalTime);
   }
 
@@ -1463,7 +1931,7 @@ class Circuit {
     const int k0 = timingArcPointers[n];
     const int k1 = timingArcPointers[n + 1];
     for (int k = k0; k < k1; k++) {
-      const TimingArcState &arc = getTimingArcState(k);
+      const ConstTimingArcState arc = getTimingArcState(k);
 
       const EdgeArray<double> arrivalTime =
           (arc.arrivalTime + arc.delay.getReversed());
@@ -1604,6 +2072,19 @@ class Circuit {
         timingOk(false),
         timingViolationSlew(0),
         timingTotalNegativeSlack(0),
+        timingRequiredTimeOutdated(true),
+        timingRCTreeWarmStart(!App::hasOption("rc-no-warm-start")),
+        timingRCTreeSharingTolerance(
+            App::getOptionValueAsDouble("rc-sharing", 0)),
+        timingRCTreePiModel(App::hasOption("rc-pi-model")),
+        timingRCTreeMaxShielding(
+            App::getOptionValueAsDouble("rc-max-shielding", 0.05)),
+        spefLegacyParser(App::hasOption("spef-legacy-parser")),
+        spefCheckParsers(App::hasOption("spef-check-parsers")),
+        verilogLegacyParser(App::hasOption("verilog-legacy-parser")),
+        snapshotFile(App::getOptionValue("snapshot")),
+        timingRCTreeReductionTolerance(
+            App::getOptionValueAsDouble("rc-reduction", 0)),
         loadViol(0),
         slewViol(0),
         timingViol(0),
@@ -1614,6 +2095,7 @@ class Circuit {
         kIndex(0),
         initialized(false),
         totalArea(-1),
+        sizingPruneCandidates(App::hasOption("lr-prune-candidates")),
         runTimeLimit(-1) {}
 
   ~Circuit() { primeTimeDisconnect(); }
@@ -1632,7 +2114,7 @@ void Circuit::walkFollowingBacktrackPointers(const int netIndex,
     const TimingNet &net = timingNets[n];
     if (net.depth == 0) break;
 
-    TimingNetState &state = getTimingNetState(n);
+    TimingNetState state = getTimingNetState(n);
     stepper(state.backtrack[e]);
 
     n = timingArcs[state.backtrack[e]].driver;
@@ -0,0 +1,367 @@
+#ifndef LUT_H
+#define LUT_H
+
+// Flattened look-up tables used for delay and slew evaluation.
+//
+// Indexes, reciprocals of the index spacing and table values are stored in a
+// single contiguous block. The segment search is branch-free: as indexes are
+// sorted, the lower segment is the number of inner indexes not greater than
+// the query value. Values outside the table are extrapolated from the border
+// segments.
+//
+// Tables are built in their own storage and may later be relocated into a
+// library-wide arena (see OrgCells::buildLUTArena() in global.h), so that all
+// the tables of a library sit in one contiguous block.
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+using std::vector;
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+class FlatLUT {
+ private:
+  int clsSizeX;
+  int clsSizeY;
+
+  // [x indexes | y indexes | 1/dx | 1/dy | values (x-major)]
+  vector<double> clsData;
+
+  // Start of the table, either in clsData or in an arena after relocate().
+  const double *clsBase;
+
+  const double *getX() const { return clsBase; }
+  const double *getY() const { return clsBase + clsSizeX; }
+  const double *getInvDx() const { return clsBase + clsSizeX + clsSizeY; }
+  const double *getInvDy() const {
+    return clsBase + 2 * clsSizeX + clsSizeY - 1;
+  }
+  const double *getValues() const {
+    return clsBase + 2 * clsSizeX + 2 * clsSizeY - 2;
+  }
+
+ public:
+  FlatLUT() : clsSizeX(0), clsSizeY(0), clsBase(0) {}
+
+  FlatLUT(const FlatLUT &other)
+      : clsSizeX(other.clsSizeX),
+        clsSizeY(other.clsSizeY),
+        clsData(other.clsData),
+        clsBase(clsData.empty() ? other.clsBase : clsData.data()) {}
+
+  FlatLUT &operator=(const FlatLUT &other) {
+    clsSizeX = other.clsSizeX;
+    clsSizeY = other.clsSizeY;
+    clsData = other.clsData;
+    clsBase = clsData.empty() ? other.clsBase : clsData.data();
+    return *this;
+  }  // end method
+
+  // Moving a vector keeps its buffer, so clsBase remains valid.
+  FlatLUT(FlatLUT &&other) = default;
+  FlatLUT &operator=(FlatLUT &&other) = default;
+
+  // ---------------------------------------------------------------------------
+
+  void build(const vector<double> &x, const vector<double> &y,
+             const vector<vector<double> > &values) {
+    clsSizeX = x.size();
+    clsSizeY = y.size();
+    clsData.clear();
+    clsBase = 0;
+
+    if (clsSizeX < 2 || clsSizeY < 2) {
+      clsSizeX = clsSizeY = 0;
+      return;
+    }  // end if
+
+    clsData.reserve(getDataSize());
+    clsData.insert(clsData.end(), x.begin(), x.end());
+    clsData.insert(clsData.end(), y.begin(), y.end());
+    for (int i = 0; i < clsSizeX - 1; i++)
+      clsData.push_back(1.0 / (x[i + 1] - x[i]));
+    for (int j = 0; j < clsSizeY - 1; j++)
+      clsData.push_back(1.0 / (y[j + 1] - y[j]));
+    for (int i = 0; i < clsSizeX; i++)
+      clsData.insert(clsData.end(), values[i].begin(), values[i].end());
+    clsBase = clsData.data();
+  }  // end method
+
+  // ---------------------------------------------------------------------------
+
+  // Number of doubles taken by the table.
+  int getDataSize() const {
+    return clsSizeX == 0 ? 0
+                         : 2 * clsSizeX + 2 * clsSizeY - 2 + clsSizeX * clsSizeY;
+  }  // end method
+
+  // Moves the table to dst, which must have room for getDataSize() doubles
+  // and outlive this object. Returns the position right after the table.
+  double *relocate(double *dst) {
+    const int size = getDataSize();
+    std::copy(clsBase, clsBase + size, dst);
+    clsBase = dst;
+    vector<double>().swap(clsData);
+    return dst + size;
+  }  // end method
+
+  // ---------------------------------------------------------------------------
+
+  bool isEmpty() const { return clsSizeX == 0; }
+  int getSizeX() const { return clsSizeX; }
+  int getSizeY() const { return clsSizeY; }
+
+  double getX(const int i) const { return getX()[i]; }
+  double getY(const int j) const { return getY()[j]; }
+  double getInvDx(const int i) const { return getInvDx()[i]; }
+  double getInvDy(const int j) const { return getInvDy()[j]; }
+  double getValue(const int i, const int j) const {
+    return getValues()[i * clsSizeY + j];
+  }
+
+  // ---------------------------------------------------------------------------
+
+  int findSegmentX(const double x) const {
+    const double *xs = getX();
+    int i = 0;
+    for (int k = 1; k < clsSizeX - 1; k++) i += xs[k] <= x;
+    return i;
+  }  // end method
+
+  int findSegmentY(const double y) const {
+    const double *ys = getY();
+    int j = 0;
+    for (int k = 1; k < clsSizeY - 1; k++) j += ys[k] <= y;
+    return j;
+  }  // end method
+
+  // ---------------------------------------------------------------------------
+
+  // Must not be called on empty tables.
+  double lookup(const double x, const double y) const {
+    assert(!isEmpty());
+
+    const int i = findSegmentX(x);
+    const int j = findSegmentY(y);
+
+    const double weightX = (x - getX()[i]) * getInvDx()[i];
+    const double weightY = (y - getY()[j]) * getInvDy()[j];
+
+    const double *v0 = &getValues()[i * clsSizeY + j];
+    const double *v1 = v0 + clsSizeY;
+
+    double result;
+    result = (1.0 - weightX) * (1.0 - weightY) * v0[0];
+    result += (weightX) * (1.0 - weightY) * v1[0];
+    result += (1.0 - weightX) * (weightY)*v0[1];
+    result += (weightX) * (weightY)*v1[1];
+    return result;
+  }  // end method
+
+};  // end class
+
+// -----------------------------------------------------------------------------
+
+// The four tables of a timing arc interleaved so that one call evaluates all
+// of them. Lanes follow the order of the Lane enum below. Interleaving is only
+// possible when the tables share the same dimensions, which is the common
+// case. Otherwise isEmpty() is true and tables must be evaluated one by one.
+class FlatTimingArcLUT {
+ public:
+  enum Lane { RISE_DELAY, FALL_DELAY, RISE_SLEW, FALL_SLEW, NUM_LANES };
+
+ private:
+  int clsSizeX;
+  int clsSizeY;
+
+  // Same layout as FlatLUT, but each entry stores one value per lane.
+  vector<double> clsData;
+
+  // Start of the table, either in clsData or in an arena after relocate().
+  const double *clsBase;
+
+ public:
+  FlatTimingArcLUT() : clsSizeX(0), clsSizeY(0), clsBase(0) {}
+
+  FlatTimingArcLUT(const FlatTimingArcLUT &other)
+      : clsSizeX(other.clsSizeX),
+        clsSizeY(other.clsSizeY),
+        clsData(other.clsData),
+        clsBase(clsData.empty() ? other.clsBase : clsData.data()) {}
+
+  FlatTimingArcLUT &operator=(const FlatTimingArcLUT &other) {
+    clsSizeX = other.clsSizeX;
+    clsSizeY = other.clsSizeY;
+    clsData = other.clsData;
+    clsBase = clsData.empty() ? other.clsBase : clsData.data();
+    return *this;
+  }  // end method
+
+  FlatTimingArcLUT(FlatTimingArcLUT &&other) = default;
+  FlatTimingArcLUT &operator=(FlatTimingArcLUT &&other) = default;
+
+  // ---------------------------------------------------------------------------
+
+  void build(const FlatLUT &riseDelay, const FlatLUT &fallDelay,
+             const FlatLUT &riseSlew, const FlatLUT &fallSlew) {
+    const FlatLUT *tables[NUM_LANES] = {&riseDelay, &fallDelay, &riseSlew,
+                                        &fallSlew};
+
+    clsSizeX = riseDelay.getSizeX();
+    clsSizeY = riseDelay.getSizeY();
+    clsData.clear();
+    clsBase = 0;
+
+    bool uniform = clsSizeX > 0;
+    for (int l = 0; l < NUM_LANES; l++)
+      if (tables[l]->getSizeX() != clsSizeX ||
+          tables[l]->getSizeY() != clsSizeY)
+        uniform = false;
+
+    if (!uniform) {
+      clsSizeX = clsSizeY = 0;
+      return;
+    }  // end if
+
+    clsData.reserve(getDataSize());
+    for (int i = 0; i < clsSizeX; i++)
+      for (int l = 0; l < NUM_LANES; l++) clsData.push_back(tables[l]->getX(i));
+    for (int j = 0; j < clsSizeY; j++)
+      for (int l = 0; l < NUM_LANES; l++) clsData.push_back(tables[l]->getY(j));
+    for (int i = 0; i < clsSizeX - 1; i++)
+      for (int l = 0; l < NUM_LANES; l++)
+        clsData.push_back(tables[l]->getInvDx(i));
+    for (int j = 0; j < clsSizeY - 1; j++)
+      for (int l = 0; l < NUM_LANES; l++)
+        clsData.push_back(tables[l]->getInvDy(j));
+    for (int i = 0; i < clsSizeX; i++)
+      for (int j = 0; j < clsSizeY; j++)
+        for (int l = 0; l < NUM_LANES; l++)
+          clsData.push_back(tables[l]->getValue(i, j));
+    clsBase = clsData.data();
+  }  // end method
+
+  // ---------------------------------------------------------------------------
+
+  // Number of doubles taken by the table.
+  int getDataSize() const {
+    return clsSizeX == 0 ? 0
+                         : NUM_LANES * (2 * clsSizeX + 2 * clsSizeY - 2 +
+                                        clsSizeX * clsSizeY);
+  }  // end method
+
+  // Same as FlatLUT::relocate().
+  double *relocate(double *dst) {
+    const int size = getDataSize();
+    std::copy(clsBase, clsBase + size, dst);
+    clsBase = dst;
+    vector<double>().swap(clsData);
+    return dst + size;
+  }  // end method
+
+  // ---------------------------------------------------------------------------
+
+  bool isEmpty() const { return clsSizeX == 0; }
+
+  // ---------------------------------------------------------------------------
+
+  // Evaluates lane l at (x[l], y[l]). Must not be called on empty tables.
+  void lookup(const double x[NUM_LANES], const double y[NUM_LANES],
+              double result[NUM_LANES]) const {
+    assert(!isEmpty());
+
+    const double *xs = clsBase;
+    const double *ys = xs + NUM_LANES * clsSizeX;
+    const double *invDx = ys + NUM_LANES * clsSizeY;
+    const double *invDy = invDx + NUM_LANES * (clsSizeX - 1);
+    const double *values = invDy + NUM_LANES * (clsSizeY - 1);
+
+#ifdef __AVX2__
+    const __m256d vx = _mm256_loadu_pd(x);
+    const __m256d vy = _mm256_loadu_pd(y);
+
+    // Branch-free segment search, one segment per lane. Comparisons yield all
+    // ones (i.e. -1) when true.
+    __m256i i = _mm256_setzero_si256();
+    for (int k = 1; k < clsSizeX - 1; k++) {
+      const __m256d le =
+          _mm256_cmp_pd(_mm256_loadu_pd(xs + NUM_LANES * k), vx, _CMP_LE_OQ);
+      i = _mm256_sub_epi64(i, _mm256_castpd_si256(le));
+    }  // end for
+
+    __m256i j = _mm256_setzero_si256();
+    for (int k = 1; k < clsSizeY - 1; k++) {
+      const __m256d le =
+          _mm256_cmp_pd(_mm256_loadu_pd(ys + NUM_LANES * k), vy, _CMP_LE_OQ);
+      j = _mm256_sub_epi64(j, _mm256_castpd_si256(le));
+    }  // end for
+
+    const __m256i lanes = _mm256_set_epi64x(3, 2, 1, 0);
+    const __m256i ioffset = _mm256_add_epi64(_mm256_slli_epi64(i, 2), lanes);
+    const __m256i joffset = _mm256_add_epi64(_mm256_slli_epi64(j, 2), lanes);
+
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    const __m256d weightX =
+        _mm256_mul_pd(_mm256_sub_pd(vx, _mm256_i64gather_pd(xs, ioffset, 8)),
+                      _mm256_i64gather_pd(invDx, ioffset, 8));
+    const __m256d weightY =
+        _mm256_mul_pd(_mm256_sub_pd(vy, _mm256_i64gather_pd(ys, joffset, 8)),
+                      _mm256_i64gather_pd(invDy, joffset, 8));
+    const __m256d complementX = _mm256_sub_pd(one, weightX);
+    const __m256d complementY = _mm256_sub_pd(one, weightY);
+
+    // Offset of value (i, j) for each lane.
+    const __m256i v00 = _mm256_add_epi64(
+        _mm256_slli_epi64(
+            _mm256_add_epi64(_mm256_mul_epu32(i, _mm256_set1_epi64x(clsSizeY)),
+                             j),
+            2),
+        lanes);
+    const __m256i v10 =
+        _mm256_add_epi64(v00, _mm256_set1_epi64x(NUM_LANES * clsSizeY));
+    const __m256i v01 = _mm256_add_epi64(v00, _mm256_set1_epi64x(NUM_LANES));
+    const __m256i v11 = _mm256_add_epi64(v10, _mm256_set1_epi64x(NUM_LANES));
+
+    __m256d sum = _mm256_mul_pd(_mm256_mul_pd(complementX, complementY),
+                                _mm256_i64gather_pd(values, v00, 8));
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_mul_pd(weightX, complementY),
+                                           _mm256_i64gather_pd(values, v10, 8)));
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_mul_pd(complementX, weightY),
+                                           _mm256_i64gather_pd(values, v01, 8)));
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_mul_pd(weightX, weightY),
+                                           _mm256_i64gather_pd(values, v11, 8)));
+
+    _mm256_storeu_pd(result, sum);
+#else
+    for (int l = 0; l < NUM_LANES; l++) {
+      int i = 0;
+      for (int k = 1; k < clsSizeX - 1; k++) i += xs[NUM_LANES * k + l] <= x[l];
+
+      int j = 0;
+      for (int k = 1; k < clsSizeY - 1; k++) j += ys[NUM_LANES * k + l] <= y[l];
+
+      const double weightX =
+          (x[l] - xs[NUM_LANES * i + l]) * invDx[NUM_LANES * i + l];
+      const double weightY =
+          (y[l] - ys[NUM_LANES * j + l]) * invDy[NUM_LANES * j + l];
+
+      const double *v0 = &values[NUM_LANES * (i * clsSizeY + j) + l];
+      const double *v1 = v0 + NUM_LANES * clsSizeY;
+
+      double sum;
+      sum = (1.0 - weightX) * (1.0 - weightY) * v0[0];
+      sum += (weightX) * (1.0 - weightY) * v1[0];
+      sum += (1.0 - weightX) * (weightY)*v0[NUM_LANES];
+      sum += (weightX) * (weightY)*v1[NUM_LANES];
+      result[l] = sum;
+    }  // end for
+#endif
+  }  // end method
+
+};  // end class
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef NAME_TABLE_H
+#define NAME_TABLE_H
+
+// Interned names. Each distinct name is stored once, null terminated, in a
+// single character arena and identified by a dense integer id assigned in
+// order of first insertion. Lookups go through an open addressing hash table
+// (FNV-1a, linear probing) holding only ids, so no per-name allocation is
+// done.
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+class NameTable {
+ private:
+  std::vector<char> clsChars;
+  std::vector<int> clsOffsets;  // name i is at clsOffsets[i] in clsChars
+  std::vector<int> clsSlots;    // -1 if empty
+
+  static unsigned int hash(const char *name, const int len) {
+    unsigned int h = 2166136261u;
+    for (int i = 0; i < len; i++) {
+      h ^= (unsigned char)name[i];
+      h *= 16777619u;
+    }  // end for
+    return h;
+  }  // end method
+
+  // Returns the id of the name or -1. In the latter case, slot is set to
+  // where the name should be inserted.
+  int findSlot(const char *name, const int len, unsigned int &slot) const {
+    const unsigned int mask = clsSlots.size() - 1;
+    for (slot = hash(name, len) & mask;; slot = (slot + 1) & mask) {
+      const int id = clsSlots[slot];
+      if (id == -1) return -1;
+      if (getNameLength(id) == len &&
+          std::memcmp(&clsChars[clsOffsets[id]], name, len) == 0)
+        return id;
+    }  // end for
+  }    // end method
+
+  void rehash(const size_t numSlots) {
+    clsSlots.assign(numSlots, -1);
+    unsigned int slot;
+    for (int i = 0; i < size(); i++) {
+      findSlot(getName(i), getNameLength(i), slot);
+      clsSlots[slot] = i;
+    }  // end for
+  }    // end method
+
+ public:
+  NameTable() : clsOffsets(1, 0), clsSlots(64, -1) {}
+
+  void clear() {
+    clsChars.clear();
+    clsOffsets.assign(1, 0);
+    clsSlots.assign(64, -1);
+  }  // end method
+
+  void reserve(const int numNames, const size_t numChars) {
+    clsOffsets.reserve(numNames + 1);
+    clsChars.reserve(numChars + numNames);
+    size_t numSlots = clsSlots.size();
+    while (numSlots < 2 * (size_t)numNames) numSlots *= 2;
+    if (numSlots != clsSlots.size()) rehash(numSlots);
+  }  // end method
+
+  // Returns the id of the name, adding it if it is not in the table yet.
+  int insert(const char *name, const int len) {
+    unsigned int slot;
+    const int id = findSlot(name, len, slot);
+    if (id != -1) return id;
+
+    const int newId = size();
+    clsChars.insert(clsChars.end(), name, name + len);
+    clsChars.push_back('\0');
+    clsOffsets.push_back(clsChars.size());
+    clsSlots[slot] = newId;
+
+    // Keep the load factor below 1/2.
+    if (2 * (size_t)size() > clsSlots.size()) rehash(2 * clsSlots.size());
+    return newId;
+  }  // end method
+
+  int insert(const std::string &name) {
+    return insert(name.c_str(), name.size());
+  }  // end method
+
+  // Returns the id of the name or -1 if it is not in the table.
+  int find(const char *name, const int len) const {
+    unsigned int slot;
+    return findSlot(name, len, slot);
+  }  // end method
+
+  int find(const std::string &name) const {
+    return find(name.c_str(), name.size());
+  }  // end method
+
+  int size() const { return clsOffsets.size() - 1; }
+
+  // The pointer is invalidated by the next insertion.
+  const char *getName(const int id) const { return &clsChars[clsOffsets[id]]; }
+  int getNameLength(const int id) const {
+    return clsOffsets[id + 1] - clsOffsets[id] - 1;
+  }  // end method
+  std::string getString(const int id) const {
+    return std::string(getName(id), getNameLength(id));
+  }  // end method
+
+  // Writes or reads the whole table, including its hash slots, through a
+  // SnapshotWriter or SnapshotReader (see Snapshot.h).
+  template <class Writer>
+  void save(Writer &writer) const {
+    writer.writeVector(clsChars);
+    writer.writeVector(clsOffsets);
+    writer.writeVector(clsSlots);
+  }  // end method
+
+  template <class Reader>
+  bool load(Reader &reader) {
+    NameTable table;
+    if (!reader.readVector(table.clsChars) ||
+        !reader.readVector(table.clsOffsets) ||
+        !reader.readVector(table.clsSlots) || table.clsOffsets.empty() ||
+        table.clsOffsets[0] != 0 ||
+        table.clsOffsets.back() != (int)table.clsChars.size() ||
+        table.clsSlots.empty() ||
+        (table.clsSlots.size() & (table.clsSlots.size() - 1)) != 0 ||
+        2 * (size_t)table.size() > table.clsSlots.size())
+      return false;
+
+    // Every name must be null terminated, every slot must be empty or hold a
+    // valid id, and every name must be found at its own id.
+    const int numNames = table.size();
+    for (int i = 0; i < numNames; i++)
+      if (table.clsOffsets[i] >= table.clsOffsets[i + 1] ||
+          table.clsOffsets[i + 1] > table.clsOffsets.back() ||
+          table.clsChars[table.clsOffsets[i + 1] - 1] != '\0')
+        return false;
+    const int numSlots = table.clsSlots.size();
+    int numUsedSlots = 0;
+    for (int i = 0; i < numSlots; i++) {
+      if (table.clsSlots[i] < -1 || table.clsSlots[i] >= numNames)
+        return false;
+      if (table.clsSlots[i] != -1) numUsedSlots++;
+    }  // end for
+    if (numUsedSlots != numNames) return false;
+    for (int i = 0; i < numNames; i++)
+      if (table.find(table.getName(i), table.getNameLength(i)) != i)
+        return false;
+
+    clsChars.swap(table.clsChars);
+    clsOffsets.swap(table.clsOffsets);
+    clsSlots.swap(table.clsSlots);
+    return true;
+  }  // end method
+};  // end class
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+// Owns objects allocated in large chunks. Objects never move, so pointers to
+// them remain valid for the lifetime of the pool, and all of them are
+// destroyed at once with the pool. Objects created after a reserve(n) call
+// are contiguous in memory up to n objects.
+
+#include <algorithm>
+#include <vector>
+
+template <class T>
+class ObjectPool {
+ private:
+  // Chunks never grow beyond their reserved capacity, so their storage is
+  // never reallocated. Moving a chunk keeps its storage.
+  std::vector<std::vector<T> > clsChunks;
+  size_t clsChunkSize;
+  size_t clsSize;
+
+  ObjectPool(const ObjectPool &);
+  ObjectPool &operator=(const ObjectPool &);
+
+ public:
+  ObjectPool(const size_t chunkSize = 1024)
+      : clsChunkSize(chunkSize), clsSize(0) {}
+
+  // Makes room for n objects in the current chunk.
+  void reserve(const size_t n) {
+    if (!clsChunks.empty()) {
+      const std::vector<T> &chunk = clsChunks.back();
+      if (chunk.capacity() - chunk.size() >= n) return;
+    }  // end if
+    clsChunks.push_back(std::vector<T>());
+    clsChunks.back().reserve(std::max(n, clsChunkSize));
+  }  // end method
+
+  T *create() {
+    reserve(1);
+    clsChunks.back().emplace_back();
+    clsSize++;
+    return &clsChunks.back().back();
+  }  // end method
+
+  size_t size() const { return clsSize; }
+
+  void clear() {
+    clsChunks.clear();
+    clsSize = 0;
+  }  // end method
+};  // end class
+
+#endif
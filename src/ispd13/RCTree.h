@@ -1,6 +1,7 @@
 #ifndef RCTREE_H
 #define RCTREE_H
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 using std::vector;
@@ -64,12 +65,16 @@ class Newton_functor {
 class RCTreeDescriptor {
  public:
   struct Node {
-    Node() { totalCap = 0; }  // end constructor
+    Node() {
+      totalCap = 0;
+      propTerminal = false;
+    }  // end constructor
 
     string propName;
     vector<int> propResistors;
     double totalCap;
     string propTag;
+    bool propTerminal;  // connected to a pin or port, never reduced
   };  // end struct
 
   struct Resistor {
@@ -104,6 +109,33 @@ class RCTreeDescriptor {
     double propValue;
   };  // end struct
 
+  struct ReductionStats {
+    ReductionStats() {
+      numTrees = 0;
+      numReducedTrees = 0;
+      numNodesBefore = 0;
+      numNodesAfter = 0;
+      maxDelayError = 0;
+      maxCapError = 0;
+    }  // end constructor
+
+    int numTrees;
+    int numReducedTrees;
+    long long numNodesBefore;
+    long long numNodesAfter;
+    double maxDelayError;  // relative to the max Elmore delay of the tree
+    double maxCapError;    // relative to the total tree capacitance
+
+    void add(const ReductionStats &other) {
+      numTrees += other.numTrees;
+      numReducedTrees += other.numReducedTrees;
+      numNodesBefore += other.numNodesBefore;
+      numNodesAfter += other.numNodesAfter;
+      maxDelayError = max(maxDelayError, other.maxDelayError);
+      maxCapError = max(maxCapError, other.maxCapError);
+    }  // end method
+  };  // end struct
+
  private:
   map<string, int> clsNodeMap;
 
@@ -155,6 +187,59 @@ class RCTreeDescriptor {
     clsTotalTreeCapacitance += c.propValue;
   }  // end method
 
+  // Index-based construction for parsers that already assigned node ids
+  // (e.g. SpefFastParser). Nodes must be added in id order and only once.
+  void reserve(const int numNodes, const int numResistors,
+               const int numCapacitors) {
+    clsNodes.reserve(numNodes);
+    clsResistors.reserve(numResistors);
+    clsCapacitors.reserve(numCapacitors);
+  }  // end method
+
+  int addNode(const string &name) {
+    const int index = clsNodes.size();
+    clsNodes.resize(clsNodes.size() + 1);
+    clsNodes.back().propName = name;
+    clsNodeMap.insert(clsNodeMap.end(), make_pair(name, index));
+    return index;
+  }  // end method
+
+  void addResistor(const int node0, const int node1, const double resistance) {
+    const int index = clsResistors.size();
+    clsResistors.resize(clsResistors.size() + 1);
+
+    Resistor &r = clsResistors.back();
+    r.propNode0 = node0;
+    r.propNode1 = node1;
+    r.propValue = resistance;
+
+    clsNodes[r.propNode0].propResistors.push_back(index);
+    clsNodes[r.propNode1].propResistors.push_back(index);
+  }  // end method
+
+  void addCapacitor(const int node, const double capacitance) {
+    clsCapacitors.resize(clsCapacitors.size() + 1);
+
+    Capacitor &c = clsCapacitors.back();
+    c.propNode = node;
+    c.propValue = capacitance;
+
+    clsNodes[c.propNode].totalCap += c.propValue;
+
+    clsTotalTreeCapacitance += c.propValue;
+  }  // end method
+
+  // Restore values saved from another descriptor (see
+  // Circuit::loadRCTreeSnapshot()). Capacitors do not necessarily add up to
+  // them after applyDefaultCap().
+  void setNodeCap(const int nodeIndex, const double cap) {
+    clsNodes[nodeIndex].totalCap = cap;
+  }  // end method
+
+  void setTotalTreeCapacitance(const double cap) {
+    clsTotalTreeCapacitance = cap;
+  }  // end method
+
   double getTotalTreeCapacitance() const { return clsTotalTreeCapacitance; }
 
   int getNumNodes() const { return clsNodes.size(); }
@@ -178,6 +263,10 @@ class RCTreeDescriptor {
     clsNodes[nodeIndex].propTag = tag;
   }  // end method
 
+  void setNodeTerminal(const int nodeIndex) {
+    clsNodes[nodeIndex].propTerminal = true;
+  }  // end method
+
   void applyDefaultCap(const double cap) {
     const int numCaps = clsCapacitors.size();
     for (int i = 0; i < numCaps; i++) {
@@ -189,31 +278,203 @@ class RCTreeDescriptor {
     }    // end for
   }      // end method
 
-};  // end class
+  // Removes non-terminal nodes whose time constant is below tolerance times
+  // the max Elmore delay of the tree (TICER-like quick node elimination).
+  // Dangling nodes are merged into their parent. Degree-2 nodes are removed
+  // by joining their resistors in series and splitting their capacitance
+  // between the neighbours, so that the Elmore delay and the downstream
+  // capacitance of every remaining node are preserved. Returns false, leaving
+  // the tree unchanged, if it is not a tree rooted at the given node.
+  bool reduce(const string &rootNodeName, const double tolerance,
+              ReductionStats &stats) {
+    const int numNodes = clsNodes.size();
+    const int root = findNode(rootNodeName);
+
+    stats.numTrees++;
+    stats.numNodesBefore += numNodes;
+
+    if (root == -1 || (int)clsResistors.size() != numNodes - 1) {
+      stats.numNodesAfter += numNodes;
+      return false;
+    }  // end if
+
+    // Orient the tree from the root.
+    vector<int> order;
+    vector<int> parents(numNodes, -1);
+    vector<double> resistances(numNodes, 0);
+    vector<double> caps(numNodes);
+    vector<vector<int> > children(numNodes);
+    vector<bool> visited(numNodes, false);
+
+    order.reserve(numNodes);
+    order.push_back(root);
+    visited[root] = true;
+    for (int i = 0; i < (int)order.size(); i++) {
+      const int n = order[i];
+      caps[n] = clsNodes[n].totalCap;
+
+      const vector<int> &resistors = clsNodes[n].propResistors;
+      const int numResistors = resistors.size();
+      for (int k = 0; k < numResistors; k++) {
+        const Resistor &r = clsResistors[resistors[k]];
+        const int m = r.getOtherNode(n);
+        if (visited[m]) continue;
+        visited[m] = true;
+        parents[m] = n;
+        resistances[m] = r.propValue;
+        children[n].push_back(m);
+        order.push_back(m);
+      }  // end for
+    }    // end for
+
+    if ((int)order.size() != numNodes) {
+      stats.numNodesAfter += numNodes;
+      return false;
+    }  // end if
+
+    const vector<double> elmoreBefore = computeElmoreDelays(order, parents,
+                                                            resistances, caps);
+    double maxElmore = 0;
+    for (int i = 0; i < numNodes; i++)
+      maxElmore = max(maxElmore, elmoreBefore[i]);
+
+    const double maxTimeConstant = tolerance * maxElmore;
+
+    // Parents come before their children, so a chain is collapsed top-down
+    // and each step sees the resistance merged so far.
+    vector<bool> removed(numNodes, false);
+    int numRemoved = 0;
+    for (int i = 1; i < numNodes; i++) {  // 1 => skips root node
+      const int n = order[i];
+      if (clsNodes[n].propTerminal || children[n].size() > 1) continue;
+
+      const int p = parents[n];
+      const double R1 = resistances[n];
+      const double C = caps[n];
+
+      if (children[n].empty()) {
+        if (R1 * C > maxTimeConstant) continue;
+        caps[p] += C;
+        children[p].erase(find(children[p].begin(), children[p].end(), n));
+      } else {
+        const int c = children[n][0];
+        const double R2 = resistances[c];
+        if (R1 + R2 <= 0 || C * (R1 * R2) / (R1 + R2) > maxTimeConstant)
+          continue;
+
+        const double alpha = R1 / (R1 + R2);
+        caps[c] += alpha * C;
+        caps[p] += (1 - alpha) * C;
+        resistances[c] = R1 + R2;
+        parents[c] = p;
+        *find(children[p].begin(), children[p].end(), n) = c;
+      }  // end else
+
+      removed[n] = true;
+      numRemoved++;
+    }  // end for
+
+    stats.numNodesAfter += numNodes - numRemoved;
+    if (numRemoved == 0) return true;
+    stats.numReducedTrees++;
+
+    // Check the error on the remaining nodes.
+    vector<int> reducedOrder;
+    reducedOrder.reserve(numNodes - numRemoved);
+    for (int i = 0; i < numNodes; i++)
+      if (!removed[order[i]]) reducedOrder.push_back(order[i]);
+
+    const vector<double> elmoreAfter = computeElmoreDelays(
+        reducedOrder, parents, resistances, caps);
+
+    double capBefore = 0;
+    double capAfter = 0;
+    for (int i = 0; i < numNodes; i++) {
+      const int n = order[i];
+      capBefore += clsNodes[n].totalCap;
+      if (removed[n]) continue;
+      capAfter += caps[n];
+      if (maxElmore > 0)
+        stats.maxDelayError =
+            max(stats.maxDelayError,
+                fabs(elmoreAfter[n] - elmoreBefore[n]) / maxElmore);
+    }  // end for
+    if (capBefore > 0)
+      stats.maxCapError =
+          max(stats.maxCapError, fabs(capAfter - capBefore) / capBefore);
+
+    // Rebuild the descriptor with the remaining nodes in their original
+    // order. The total tree capacitance is kept as is.
+    vector<Node> nodes;
+    nodes.swap(clsNodes);
+    clsNodeMap.clear();
+    clsResistors.clear();
+    clsCapacitors.clear();
+
+    vector<int> newIndex(numNodes, -1);
+    for (int n = 0; n < numNodes; n++) {
+      if (removed[n]) continue;
+      newIndex[n] = clsNodes.size();
+      clsNodes.push_back(nodes[n]);
+
+      Node &node = clsNodes.back();
+      node.propResistors.clear();
+      node.totalCap = caps[n];
+      clsNodeMap[node.propName] = newIndex[n];
+
+      clsCapacitors.resize(clsCapacitors.size() + 1);
+      clsCapacitors.back().propNode = newIndex[n];
+      clsCapacitors.back().propValue = caps[n];
+    }  // end for
+
+    for (int n = 0; n < numNodes; n++) {
+      if (removed[n] || n == root) continue;
+
+      const int index = clsResistors.size();
+      clsResistors.resize(clsResistors.size() + 1);
+
+      Resistor &r = clsResistors.back();
+      r.propNode0 = newIndex[parents[n]];
+      r.propNode1 = newIndex[n];
+      r.propValue = resistances[n];
+
+      clsNodes[r.propNode0].propResistors.push_back(index);
+      clsNodes[r.propNode1].propResistors.push_back(index);
+    }  // end for
+
+    return true;
+  }  // end method
 
+ private:
+  static vector<double> computeElmoreDelays(const vector<int> &order,
+                                            const vector<int> &parents,
+                                            const vector<double> &resistances,
+                                            const vector<double> &caps) {
+    const int numNodes = order.size();
+    vector<double> downstreamCaps(caps);
+    for (int i = numNodes - 1; i > 0; i--)
+      downstreamCaps[parents[order[i]]] += downstreamCaps[order[i]];
+
+    vector<double> delays(caps.size(), 0);
+    for (int i = 1; i < numNodes; i++) {
+      const int n = order[i];
+      delays[n] = delays[parents[n]] + resistances[n] * downstreamCaps[n];
+    }  // end for
+    return delays;
+  }  // end method
+
+};  // end class
 // =============================================================================
 // Original version of RCTree.
 // =============================================================================
 
+// Node data is split in two blocks. Hot data touched by every sweep (parent,
+// resistance, capacitances, effective capacitance, slew and delay) is stored
+// as a structure of arrays indexed in topological order, i.e. the root is 0
+// and parents always come before their children. Cold data (names, tags,
+// original capacitance and pi-model moments) is kept apart so that it does
+// not pollute the cache during the sweeps.
 class RCTreeBase {
- public:
-  struct Node {
-    double propCap;
-    double propOriginalCap;
-    double propDownstreamCap;
-    double propDrivingResistance;
-    int propParent;
-    bool propEndpoint;
-
-    EdgeArray<double> propDelay;
-    EdgeArray<double> propSlew;
-    EdgeArray<double> propEffectiveCap;
-
-    double propY1;
-    double propY2;
-    double propY3;
-  };
-
  protected:
   struct Ref {
     int propNodeIndex;
@@ -230,13 +491,57 @@ class RCTreeBase {
     }  // end constructor
   };
 
+  struct ColdNode {
+    double propOriginalCap;
+    bool propEndpoint;
+
+    // Driving-point admittance moments.
+    double propY1;
+    double propY2;
+    double propY3;
+  };
+
+  // Hot data.
+  vector<int> clsParents;
+  vector<double> clsResistances;  // resistance driving the node
+  vector<double> clsCaps;
+  vector<double> clsDownstreamCaps;
+  vector<EdgeArray<double> > clsEffectiveCaps;
+  vector<EdgeArray<double> > clsSlews;
+  vector<EdgeArray<double> > clsDelays;
+
+  // Nodes of level l are [clsLevelPointers[l], clsLevelPointers[l+1]).
+  vector<int> clsLevelPointers;
+
+  // Scratch used by stepBackward().
+  vector<EdgeArray<double> > clsCeffs;
+
+  // Scratch for exponentials evaluated in batch by the sweeps.
+  vector<EdgeArray<double> > clsExps;
+
+  // Cold data.
+  vector<ColdNode> clsColdNodes;
   vector<string> clsNodeNames;
   vector<string> clsNodeTags;
-  vector<Node> clsNodes;
-  vector<EdgeArray<double> > clsCeffs;
 
   bool clsDirty;
 
+  // Number of incremental downstream capacitance updates since the last full
+  // update. See setNodeExtraCap().
+  int clsNumDeltaUpdates;
+
+  // Profiling counters. Iterations count the Ceff iterations of all
+  // simulations done on this tree since the last call to resetCounters().
+  long long clsNumSimulations;
+  long long clsNumIterations;
+  long long clsNumClosedForms;
+
+  // Pi-model cached by reduceToPiModel(). Only recomputed after loads change.
+  double clsPiC1;
+  double clsPiR;
+  double clsPiC2;
+  bool clsPiModelDirty;
+
   // -------------------------------------------------------------------------
 
   // Source:
@@ -272,12 +577,11 @@ class RCTreeBase {
 
     const RCTreeDescriptor::Node &rootNodeDescriptor = dscp.getNode(root);
 
-    Node &rootNode = clsNodes[0];
-    rootNode.propDelay.set(0.0, 0.0);
-    rootNode.propCap = rootNodeDescriptor.totalCap;
-    rootNode.propOriginalCap = rootNodeDescriptor.totalCap;
-    rootNode.propDrivingResistance = -1;
-    rootNode.propParent = -1;
+    clsDelays[0].set(0.0, 0.0);
+    clsCaps[0] = rootNodeDescriptor.totalCap;
+    clsResistances[0] = -1;
+    clsParents[0] = -1;
+    clsColdNodes[0].propOriginalCap = rootNodeDescriptor.totalCap;
     clsNodeNames[0] = rootNodeDescriptor.propName;
     clsNodeTags[0] = rootNodeDescriptor.propTag;
 
@@ -286,11 +590,15 @@ class RCTreeBase {
       tackled[r] = true;
       q.push(Ref(dscp.getResistor(r).getOtherNode(root), r));
     }  // end method
-    rootNode.propEndpoint = q.empty();
+    clsColdNodes[0].propEndpoint = q.empty();
 
     topology[0] = root;
     reverseTopology[root] = 0;
 
+    // Nodes are visited in breadth-first order, so levels are contiguous.
+    vector<int> levels(numNodes, 0);
+    clsLevelPointers.assign(1, 0);
+
     int counter = 1;
 
     while (!q.empty()) {
@@ -305,17 +613,20 @@ class RCTreeBase {
       const RCTreeDescriptor::Resistor &resistorDescriptor =
           dscp.getResistor(r);
 
-      Node &node = clsNodes[counter];
-      node.propCap = nodeDescriptor.totalCap;
-      node.propOriginalCap = nodeDescriptor.totalCap;
-      node.propDrivingResistance = resistorDescriptor.propValue;
-      node.propParent = reverseTopology[resistorDescriptor.getOtherNode(n)];
+      clsCaps[counter] = nodeDescriptor.totalCap;
+      clsResistances[counter] = resistorDescriptor.propValue;
+      clsParents[counter] = reverseTopology[resistorDescriptor.getOtherNode(n)];
+      clsColdNodes[counter].propOriginalCap = nodeDescriptor.totalCap;
       clsNodeNames[counter] = nodeDescriptor.propName;
       clsNodeTags[counter] = nodeDescriptor.propTag;
 
       topology[counter] = n;
       reverseTopology[n] = counter;
 
+      levels[counter] = levels[clsParents[counter]] + 1;
+      if (levels[counter] != levels[counter - 1])
+        clsLevelPointers.push_back(counter);
+
       int counterNeighbours = 0;
 
       const int numResistors = nodeDescriptor.propResistors.size();
@@ -328,73 +639,149 @@ class RCTreeBase {
         }  // end if
       }    // end method
 
-      node.propEndpoint = (counterNeighbours == 0);
+      clsColdNodes[counter].propEndpoint = (counterNeighbours == 0);
 
       counter++;
     }  // end while
-  }    // end method
+
+    clsLevelPointers.push_back(counter);
+  }  // end method
 
   // -------------------------------------------------------------------------
 
+  // The slew of a node depends only on nodes of previous levels, so the
+  // exponentials of a whole level are evaluated at once.
   template <class RCTreeDriver>
   void stepForward(const RCTreeDriver &driver) {
-    Node &rootState = clsNodes[0];
+    clsSlews[0] = driver.computeSlew(clsEffectiveCaps[0]);
 
-    rootState.propSlew = driver.computeSlew(rootState.propEffectiveCap);
+    const int numLevels = clsLevelPointers.size() - 1;
+    for (int level = 1; level < numLevels; level++) {  // 1 => skips root node
+      const int n0 = clsLevelPointers[level];
+      const int n1 = clsLevelPointers[level + 1];
 
-    const int numNodes = clsNodes.size();
-    for (int n = 1; n < numNodes; n++) {  // 1 => skips root node
-      Node &node = clsNodes[n];
-      const Node &parent = clsNodes[node.propParent];
+      for (int n = n0; n < n1; n++) {
+        const EdgeArray<double> RCeff = clsResistances[n] * clsEffectiveCaps[n];
+        clsExps[n] = -clsSlews[clsParents[n]] / RCeff;
+      }  // end for
 
-      const EdgeArray<double> S0 = parent.propSlew;
-      const EdgeArray<double> Ceff1 = node.propEffectiveCap;
-      const double R1 = node.propDrivingResistance;
+      expInPlace(&clsExps[n0], n1 - n0);
 
-      const EdgeArray<double> RCeff = R1 * Ceff1;
-      node.propDelay = parent.propDelay + RCeff;
-      node.propSlew = S0 / (1.0 - ((RCeff) / S0) * (1.0 - exp(-S0 / (RCeff))));
-    }  // end for
-  }    // end for
+      for (int n = n0; n < n1; n++) {
+        const int parent = clsParents[n];
+
+        const EdgeArray<double> S0 = clsSlews[parent];
+        const EdgeArray<double> Ceff1 = clsEffectiveCaps[n];
+        const double R1 = clsResistances[n];
+
+        const EdgeArray<double> RCeff = R1 * Ceff1;
+        clsDelays[n] = clsDelays[parent] + RCeff;
+        clsSlews[n] = S0 / (1.0 - ((RCeff) / S0) * (1.0 - clsExps[n]));
+      }  // end for
+    }    // end for
+  }      // end method
 
   // -------------------------------------------------------------------------
 
-  void stepBackward() {
-    const int numNodes = clsNodes.size();
+  // Moves the effective capacitances to clsCeffs and resets them to the node
+  // capacitances, so that the backward sweep can accumulate on them.
+  void resetEffectiveCaps() {
+    clsCeffs.swap(clsEffectiveCaps);
 
-    for (int i = 0; i < numNodes; i++) {
-      Node &node = clsNodes[i];
+    const int numNodes = getNumNodes();
+    for (int i = 0; i < numNodes; i++)
+      clsEffectiveCaps[i].set(clsCaps[i], clsCaps[i]);
+  }  // end method
 
-      clsCeffs[i] = node.propEffectiveCap;
-      node.propEffectiveCap.set(node.propCap, node.propCap);
+  // -------------------------------------------------------------------------
+
+  // Slews are known from the forward sweep, so the exponentials of all nodes
+  // are evaluated at once before accumulating the effective capacitances.
+  void stepBackward() {
+    resetEffectiveCaps();
+
+    const int numNodes = getNumNodes();
+    for (int n = 1; n < numNodes; n++) {  // 1 => skips root node
+      const EdgeArray<double> RCeff = clsResistances[n] * clsCeffs[n];
+      clsExps[n] = -clsSlews[clsParents[n]] / (2.0 * RCeff);
     }  // end for
 
+    if (numNodes > 1) expInPlace(&clsExps[1], numNodes - 1);
+
     for (int n = numNodes - 1; n > 0; n--) {  // n > 0 skips root node
-      const Node &sink = clsNodes[n];
-      Node &driver = clsNodes[sink.propParent];
+      const int driver = clsParents[n];
 
-      const EdgeArray<double> S0 = driver.propSlew;
+      const EdgeArray<double> S0 = clsSlews[driver];
       const EdgeArray<double> Ceff1 = clsCeffs[n];
-      const double R1 = sink.propDrivingResistance;
+      const double R1 = clsResistances[n];
 
       const EdgeArray<double> RCeff = R1 * Ceff1;
       const EdgeArray<double> K1 =
-          1.0 - ((2.0 * RCeff) / S0) * (1.0 - exp(-S0 / (2.0 * RCeff)));
-      driver.propEffectiveCap += K1 * sink.propDownstreamCap;
+          1.0 - ((2.0 * RCeff) / S0) * (1.0 - clsExps[n]);
+      clsEffectiveCaps[driver] += K1 * clsDownstreamCaps[n];
     }  // end for
-  }    // end for
+  }    // end method
+
+  // -------------------------------------------------------------------------
+
+  // Sets the root Ceff in closed form (see
+  // computeEffectiveCapacitanceClosedForm()) and the remaining nodes to their
+  // downstream capacitance, which is ready for a single forward sweep.
+  // Returns false, changing nothing, if the closed form can not be used.
+  template <class RCTreeDriver>
+  bool setupClosedForm(const RCTreeDriver &driver, const double maxShielding,
+                       const EdgeArray<double> *initialCeff) {
+    if (clsDirty) updateDownstreamCap();
+
+    EdgeArray<double> Ceff;
+    if (!computeEffectiveCapacitanceClosedForm(driver, maxShielding, Ceff,
+                                               initialCeff))
+      return false;
+
+    const int numNodes = getNumNodes();
+    for (int i = 1; i < numNodes; i++)
+      clsEffectiveCaps[i].set(clsDownstreamCaps[i], clsDownstreamCaps[i]);
+    clsEffectiveCaps[0] = Ceff;
+
+    clsNumSimulations++;
+    clsNumIterations++;
+    clsNumClosedForms++;
+    return true;
+  }  // end method
 
  public:
+  RCTreeBase()
+      : clsDirty(false),
+        clsNumDeltaUpdates(0),
+        clsNumSimulations(0),
+        clsNumIterations(0),
+        clsNumClosedForms(0),
+        clsPiC1(0),
+        clsPiR(0),
+        clsPiC2(0),
+        clsPiModelDirty(true) {}
+
+  // -------------------------------------------------------------------------
+
   void build(const RCTreeDescriptor &dscp, const string &rootNodeName) {
     const int numNodes = dscp.getNumNodes();
 
     // Clean up
     clsDirty = false;
-
-    clsNodes.resize(numNodes);
+    clsPiModelDirty = true;
+
+    clsParents.resize(numNodes);
+    clsResistances.resize(numNodes);
+    clsCaps.resize(numNodes);
+    clsDownstreamCaps.resize(numNodes);
+    clsEffectiveCaps.resize(numNodes);
+    clsSlews.resize(numNodes);
+    clsDelays.resize(numNodes);
+    clsCeffs.resize(numNodes);
+    clsExps.resize(numNodes);
+    clsColdNodes.resize(numNodes);
     clsNodeNames.resize(numNodes);
     clsNodeTags.resize(numNodes);
-    clsCeffs.resize(numNodes);
 
     // Map topological index (e.g. 0 = root) to respective node index in the
     // descriptor.
@@ -402,23 +789,24 @@ class RCTreeBase {
 
     // Update downstream cap.
     updateDownstreamCap();
+
+    // Effective capacitances are kept between simulations to warm-start the
+    // next one, so they must be valid from the beginning.
+    for (int i = 0; i < numNodes; i++)
+      clsEffectiveCaps[i].set(clsDownstreamCaps[i], clsDownstreamCaps[i]);
   }  // end method
 
   // -------------------------------------------------------------------------
 
   void updateDownstreamCap() {
     const int numNodes = getNumNodes();
-    for (int i = 0; i < numNodes; i++) {
-      Node &node = clsNodes[i];
-      node.propDownstreamCap = node.propCap;
-    }  // end for
+    for (int i = 0; i < numNodes; i++) clsDownstreamCaps[i] = clsCaps[i];
 
-    for (int n = numNodes - 1; n > 0; n--) {  // n > 0 skips root node
-      const Node &node = clsNodes[n];
-      clsNodes[node.propParent].propDownstreamCap += node.propDownstreamCap;
-    }  // end for
+    for (int n = numNodes - 1; n > 0; n--)  // n > 0 skips root node
+      clsDownstreamCaps[clsParents[n]] += clsDownstreamCaps[n];
 
     clsDirty = false;
+    clsNumDeltaUpdates = 0;
   }  // end method
 
   // -------------------------------------------------------------------------
@@ -426,7 +814,7 @@ class RCTreeBase {
   void updateDrivingPoint() {
     const int numNodes = getNumNodes();
     for (int i = 0; i < numNodes; i++) {
-      Node &node = clsNodes[i];
+      ColdNode &node = clsColdNodes[i];
       node.propY1 = 0;
       node.propY2 = 0;
       node.propY3 = 0;
@@ -434,10 +822,10 @@ class RCTreeBase {
 
     // Compute pi-model of the RC Tree.
     for (int n = numNodes - 1; n > 0; n--) {  // n > 0 skips root node
-      const Node &node = clsNodes[n];
+      const ColdNode &node = clsColdNodes[n];
 
-      const double C = node.propCap;
-      const double R = node.propDrivingResistance;
+      const double C = clsCaps[n];
+      const double R = clsResistances[n];
 
       const double yD1 = node.propY1;
       const double yD2 = node.propY2;
@@ -451,56 +839,64 @@ class RCTreeBase {
           pow2(R) * (pow3(yD1) + (4.0 / 3.0) * C * pow2(yD1) +
                      (2.0 / 3.0) * pow2(C) * yD1 + (2.0 / 15.0) * pow3(C));
 
-      Node &parent = clsNodes[node.propParent];
+      ColdNode &parent = clsColdNodes[clsParents[n]];
       parent.propY1 += yU1;
       parent.propY2 += yU2;
       parent.propY3 += yU3;
 
-      // cout << "Resistor: " << clsNodeNames[node.propParent] << " -> " <<
+      // cout << "Resistor: " << clsNodeNames[clsParents[n]] << " -> " <<
       // clsNodeNames[n] << "\n";
     }  // end for
 
-    Node &root = clsNodes[0];
-    root.propY1 += root.propCap;
+    ColdNode &root = clsColdNodes[0];
+    root.propY1 += clsCaps[0];
   }  // end method
 
   // -------------------------------------------------------------------------
 
   // [PAPER] Fast and Accurate Wire Delay Estimation for Physical Synthesis
   // of Large ASICs.
-
+  //
+  // If initialCeff is not null, the iteration is warm-started: the root is
+  // seeded with initialCeff (e.g. the Ceff converged in the last simulation
+  // of the same driver arc) and the remaining nodes keep the effective
+  // capacitances of the last simulation.
   template <class RCTreeDriver>
   void simulate(const RCTreeDriver &driver, const double epsilon = 1e-6,
-                const int maxIterations = 100) {
+                const int maxIterations = 100,
+                const EdgeArray<double> *initialCeff = NULL) {
     if (clsDirty) updateDownstreamCap();
 
-    const int numNodes = clsNodes.size();
+    const int numNodes = getNumNodes();
 
-    // Initially set effective capacitance equals to downstream capacitance.
-    for (int i = 0; i < numNodes; i++) {
-      Node &node = clsNodes[i];
-      node.propEffectiveCap = EdgeArray<double>(clsNodes[i].propDownstreamCap,
-                                                clsNodes[i].propDownstreamCap);
-    }  // end for
+    if (initialCeff) {
+      clsEffectiveCaps[0] = *initialCeff;
+    } else {
+      // Initially set effective capacitance equals to downstream capacitance.
+      for (int i = 0; i < numNodes; i++)
+        clsEffectiveCaps[i].set(clsDownstreamCaps[i], clsDownstreamCaps[i]);
+    }    // end else
+
+    clsNumSimulations++;
 
     bool converged = false;
-    EdgeArray<double> previousRootEffectiveCapacitance =
-        clsNodes[0].propEffectiveCap;
+    EdgeArray<double> previousRootEffectiveCapacitance = clsEffectiveCaps[0];
     for (int i = 0; i < maxIterations; i++) {
+      clsNumIterations++;
       stepForward(driver);
       stepBackward();
 
-      const Node &root = clsNodes[0];
+      const EdgeArray<double> &rootEffectiveCapacitance = clsEffectiveCaps[0];
 
       if (nearlyEqual(previousRootEffectiveCapacitance[RISE],
-                      root.propEffectiveCap[RISE], epsilon) &&
+                      rootEffectiveCapacitance[RISE], epsilon) &&
           nearlyEqual(previousRootEffectiveCapacitance[FALL],
-                      root.propEffectiveCap[FALL], epsilon)) {
+                      rootEffectiveCapacitance[FALL], epsilon)) {
         converged = true;
         break;
       }  // end if
 
-      previousRootEffectiveCapacitance = root.propEffectiveCap;
+      previousRootEffectiveCapacitance = rootEffectiveCapacitance;
     }  // end for
 
     if (!converged)
@@ -513,11 +909,15 @@ class RCTreeBase {
 
   // [PAPER] Modeling the Effective Capacitance for the RC Interconnect of
   // CMOS Gates
+  //
+  // The iteration starts from initialCeff if not null or from the lumped
+  // capacitance otherwise.
 
   template <class RCTreeDriver>
   EdgeArray<double> computeEffectiveCapacitanceBasedOnJessica(
       const RCTreeDriver &driver, const double epsilon = 1e-6,
-      const int maxIterations = 100) {
+      const int maxIterations = 100,
+      const EdgeArray<double> *initialCeff = NULL) {
     bool converged = false;
 
     const EdgeArray<double> tr = driver.getInputSlew();
@@ -526,11 +926,15 @@ class RCTreeBase {
     reduceToPiModel(C1, R, C2);
 
     EdgeArray<double> Ceff(getLumpedCap(), getLumpedCap());
+    if (initialCeff) Ceff = *initialCeff;
     EdgeArray<double> previousCeff = Ceff;
 
     for (int i = 0; i < maxIterations; i++) {
-      const EdgeArray<double> td = driver.computeDelay(Ceff);
-      const EdgeArray<double> tf = driver.computeSlew(Ceff);
+      clsNumIterations++;
+
+      EdgeArray<double> td;
+      EdgeArray<double> tf;
+      driver.computeDelayAndSlew(Ceff, td, tf);
 
       const EdgeArray<double> tD = td + tr / 2.0;
       const EdgeArray<double> tx = tD - 0.5 * tf;
@@ -562,6 +966,59 @@ class RCTreeBase {
 
   // -------------------------------------------------------------------------
 
+  // Closed-form Ceff: a single step of the Jessica iteration (see above) from
+  // initialCeff, or from the lumped capacitance, using the cached pi-model.
+  // It is accurate when the resistive shielding is low. Returns false if the
+  // shielded fraction of the lumped capacitance exceeds maxShielding or the
+  // pi-model is degenerated, in which case an iterative method should be used.
+
+  template <class RCTreeDriver>
+  bool computeEffectiveCapacitanceClosedForm(
+      const RCTreeDriver &driver, const double maxShielding,
+      EdgeArray<double> &Ceff, const EdgeArray<double> *initialCeff = NULL) {
+    const double lumpedCap = getLumpedCap();
+
+    // Nothing to shield.
+    if (getNumNodes() == 1) {
+      Ceff.set(lumpedCap, lumpedCap);
+      return true;
+    }  // end if
+
+    double C2, R, C1;
+    reduceToPiModel(C1, R, C2);
+
+    if (!(C1 > 0) || !(R > 0)) return false;
+
+    const EdgeArray<double> tr = driver.getInputSlew();
+
+    EdgeArray<double> td;
+    EdgeArray<double> tf;
+    driver.computeDelayAndSlew(
+        initialCeff ? *initialCeff : EdgeArray<double>(lumpedCap, lumpedCap),
+        td, tf);
+
+    const EdgeArray<double> tD = td + tr / 2.0;
+    const EdgeArray<double> tx = tD - 0.5 * tf;
+
+    const EdgeArray<double> shielding =
+        (1 - (R * C1) / (tD - tx / 2.0) +
+         (pow(R * C1, 2.0) / (tx * (tD - tx / 2.0))) *
+             (exp(-(tD - tx) / (R * C1))) * (1 - exp((-tx) / (R * C1))));
+
+    const EdgeArray<double> closedFormCeff =
+        C2 + C1 * (1.0 * shielding + 1.0) / 2.0;
+
+    // Also rejects NaNs.
+    if (!(closedFormCeff[RISE] >= (1 - maxShielding) * lumpedCap &&
+          closedFormCeff[FALL] >= (1 - maxShielding) * lumpedCap))
+      return false;
+
+    Ceff = closedFormCeff;
+    return true;
+  }  // end method
+
+  // -------------------------------------------------------------------------
+
   // [PAPER] Performance Computation for Prec aracterized
   // CMOS Gates with RC Loads
 
@@ -656,125 +1113,198 @@ class RCTreeBase {
   void reduceToPiModel(double &C1, double &R, double &C2) {
     if (clsDirty) updateDownstreamCap();
 
-    updateDrivingPoint();
+    if (clsPiModelDirty) {
+      updateDrivingPoint();
+
+      const ColdNode &root = clsColdNodes[0];
+      clsPiC1 = pow2(root.propY2) / root.propY3;
+      clsPiC2 = root.propY1 - clsPiC1;
+      clsPiR = -pow2(root.propY3) / pow3(root.propY2);
+      clsPiModelDirty = false;
+    }  // end if
 
-    const Node &root = clsNodes[0];
-    C1 = pow2(root.propY2) / root.propY3;
-    C2 = root.propY1 - C1;
-    R = -pow2(root.propY3) / pow3(root.propY2);
+    C1 = clsPiC1;
+    R = clsPiR;
+    C2 = clsPiC2;
   }  // end method
 
   // -------------------------------------------------------------------------
 
+  // Only the downstream capacitances on the path from the node to the root
+  // are updated, i.e. O(depth) instead of O(nodes). Nothing changes, neither
+  // the cached pi-model, if the capacitance is the same.
   void setNodeExtraCap(const int index, const double cap) {
-    Node &node = clsNodes[index];
-    node.propCap = node.propOriginalCap + cap;
+    const double newCap = clsColdNodes[index].propOriginalCap + cap;
+    const double delta = newCap - clsCaps[index];
+    if (delta == 0) return;
 
-    clsDirty = true;
+    clsCaps[index] = newCap;
+    clsPiModelDirty = true;
+
+    if (clsDirty) return;
+
+    // A full update is done once in a while so that the rounding errors of
+    // the deltas do not pile up.
+    if (++clsNumDeltaUpdates > getNumNodes()) {
+      clsDirty = true;
+      return;
+    }  // end if
+
+    for (int n = index; n != -1; n = clsParents[n])
+      clsDownstreamCaps[n] += delta;
   }  // end method
 
   // -------------------------------------------------------------------------
 
-  int getNumNodes() const { return clsNodes.size(); }
+  int getNumNodes() const { return clsParents.size(); }
 
-  const Node &getNode(const int index) const { return clsNodes[index]; }
-  const Node &getRoot() const { return clsNodes[0]; }
+  int getParent(const int index) const { return clsParents[index]; }
+  double getDrivingResistance(const int index) const {
+    return clsResistances[index];
+  }
+  double getCap(const int index) const { return clsCaps[index]; }
+  double getDownstreamCap(const int index) const {
+    return clsDownstreamCaps[index];
+  }
+  const EdgeArray<double> &getEffectiveCap(const int index) const {
+    return clsEffectiveCaps[index];
+  }
+  const EdgeArray<double> &getSlew(const int index) const {
+    return clsSlews[index];
+  }
+  const EdgeArray<double> &getDelay(const int index) const {
+    return clsDelays[index];
+  }
+  bool isEndpoint(const int index) const {
+    return clsColdNodes[index].propEndpoint;
+  }
 
   const string &getNodeName(const int index) const {
     return clsNodeNames[index];
   }
   const string &getNodeTag(const int index) const { return clsNodeTags[index]; }
 
-  double getLumpedCap() const { return clsNodes[0].propDownstreamCap; }
+  double getLumpedCap() const { return clsDownstreamCaps[0]; }
+
+  long long getNumSimulations() const { return clsNumSimulations; }
+  long long getNumIterations() const { return clsNumIterations; }
+  long long getNumClosedForms() const { return clsNumClosedForms; }
+
+  void resetCounters() {
+    clsNumSimulations = 0;
+    clsNumIterations = 0;
+    clsNumClosedForms = 0;
+  }  // end method
 
 };  // end class
 
+// =============================================================================
+// Simulation modes shared by the trees below. Tree is the derived tree, which
+// provides its own stepForward() and simulate().
+// =============================================================================
+
+template <class Tree>
+class RCTreeSimulation : public RCTreeBase {
+ public:
+  // Closed-form root Ceff followed by a single forward sweep. Nets whose
+  // shielding exceeds maxShielding fall back to simulate().
+  template <class RCTreeDriver>
+  void simulatePiModel(const RCTreeDriver &driver, const double maxShielding,
+                       const double epsilon = 1e-6,
+                       const int maxIterations = 100,
+                       const EdgeArray<double> *initialCeff = NULL) {
+    Tree &tree = static_cast<Tree &>(*this);
+    if (setupClosedForm(driver, maxShielding, initialCeff))
+      tree.stepForward(driver);
+    else
+      tree.simulate(driver, epsilon, maxIterations, initialCeff);
+  }  // end method
+};   // end class
+
 // =============================================================================
 // Flach's version of RCTree.
 // =============================================================================
 
-class RCTreeFlach : public RCTreeBase {
+class RCTreeFlach : public RCTreeSimulation<RCTreeFlach> {
+  friend class RCTreeSimulation<RCTreeFlach>;
+
  private:
   template <class RCTreeDriver>
   void stepForward(const RCTreeDriver &driver) {
-    Node &rootState = clsNodes[0];
+    clsSlews[0] = driver.computeSlew(clsEffectiveCaps[0]);
 
-    rootState.propSlew = driver.computeSlew(rootState.propEffectiveCap);
-
-    const int numNodes = clsNodes.size();
+    const int numNodes = getNumNodes();
     for (int n = 1; n < numNodes; n++) {  // 1 => skips root node
-      Node &node = clsNodes[n];
-      const Node &parent = clsNodes[node.propParent];
+      const int parent = clsParents[n];
 
-      const EdgeArray<double> Ceff1 = node.propEffectiveCap;
-      const double R1 = node.propDrivingResistance;
+      const EdgeArray<double> Ceff1 = clsEffectiveCaps[n];
+      const double R1 = clsResistances[n];
 
       const EdgeArray<double> RCeff = R1 * Ceff1;
-      node.propDelay = parent.propDelay + RCeff;
-      node.propSlew = parent.propSlew + RCeff * 1.386294361 / 2;
+      clsDelays[n] = clsDelays[parent] + RCeff;
+      clsSlews[n] = clsSlews[parent] + RCeff * 1.386294361 / 2;
     }  // end for
   }    // end for
 
   // -------------------------------------------------------------------------
 
   void stepBackward() {
-    const int numNodes = clsNodes.size();
-
-    for (int i = 0; i < numNodes; i++) {
-      Node &node = clsNodes[i];
+    const int numNodes = getNumNodes();
 
-      clsCeffs[i] = node.propEffectiveCap;
-      node.propEffectiveCap.set(node.propCap, node.propCap);
-    }  // end for
+    resetEffectiveCaps();
 
     for (int n = numNodes - 1; n > 0; n--) {  // n > 0 skips root node
-      const Node &sink = clsNodes[n];
-      Node &driver = clsNodes[sink.propParent];
+      const int driver = clsParents[n];
 
-      const EdgeArray<double> S0 = driver.propSlew;
+      const EdgeArray<double> S0 = clsSlews[driver];
       const EdgeArray<double> Ceff1 = clsCeffs[n];
-      const double R1 = sink.propDrivingResistance;
+      const double R1 = clsResistances[n];
 
       const EdgeArray<double> RCeff = R1 * Ceff1;
       const EdgeArray<double> K1 =
           1.0 - ((2.0 * RCeff) / S0) * (1.0 - exp(-S0 / (2.0 * RCeff)));
-      driver.propEffectiveCap += K1 * sink.propDownstreamCap;
+      clsEffectiveCaps[driver] += K1 * clsDownstreamCaps[n];
     }  // end for
   }    // end for
 
  public:
+  // Warm-started as RCTreeBase::simulate().
   template <class RCTreeDriver>
   void simulate(const RCTreeDriver &driver, const double epsilon = 1e-6,
-                const int maxIterations = 100) {
+                const int maxIterations = 100,
+                const EdgeArray<double> *initialCeff = NULL) {
     if (clsDirty) updateDownstreamCap();
 
-    const int numNodes = clsNodes.size();
+    const int numNodes = getNumNodes();
 
-    // Initially set effective capacitance equals to downstream capacitance.
-    for (int i = 0; i < numNodes; i++) {
-      Node &node = clsNodes[i];
-      node.propEffectiveCap = EdgeArray<double>(clsNodes[i].propDownstreamCap,
-                                                clsNodes[i].propDownstreamCap);
-    }  // end for
+    if (initialCeff) {
+      clsEffectiveCaps[0] = *initialCeff;
+    } else {
+      // Initially set effective capacitance equals to downstream capacitance.
+      for (int i = 0; i < numNodes; i++)
+        clsEffectiveCaps[i].set(clsDownstreamCaps[i], clsDownstreamCaps[i]);
+    }    // end else
+
+    clsNumSimulations++;
 
     bool converged = false;
-    EdgeArray<double> previousRootEffectiveCapacitance =
-        clsNodes[0].propEffectiveCap;
+    EdgeArray<double> previousRootEffectiveCapacitance = clsEffectiveCaps[0];
     for (int i = 0; i < maxIterations; i++) {
+      clsNumIterations++;
       stepForward(driver);
       stepBackward();
 
-      const Node &root = clsNodes[0];
+      const EdgeArray<double> &rootEffectiveCapacitance = clsEffectiveCaps[0];
 
       if (nearlyEqual(previousRootEffectiveCapacitance[RISE],
-                      root.propEffectiveCap[RISE], epsilon) &&
+                      rootEffectiveCapacitance[RISE], epsilon) &&
           nearlyEqual(previousRootEffectiveCapacitance[FALL],
-                      root.propEffectiveCap[FALL], epsilon)) {
+                      rootEffectiveCapacitance[FALL], epsilon)) {
         converged = true;
         break;
       }  // end if
 
-      previousRootEffectiveCapacitance = root.propEffectiveCap;
+      previousRootEffectiveCapacitance = rootEffectiveCapacitance;
     }  // end for
 
     if (!converged)
@@ -789,32 +1319,29 @@ class RCTreeFlach : public RCTreeBase {
 // Default's version of RCTree.
 // =============================================================================
 
-class RCTreeDefault : public RCTreeBase {
+class RCTreeDefault : public RCTreeSimulation<RCTreeDefault> {
+  friend class RCTreeSimulation<RCTreeDefault>;
+
  private:
   template <class RCTreeDriver>
   void stepForward(const RCTreeDriver &driver) {
-    Node &rootState = clsNodes[0];
-
-    const EdgeArray<double> downCap(rootState.propDownstreamCap,
-                                    rootState.propDownstreamCap);
-    rootState.propSlew =
-        1.05 *
-        driver.computeSlew(min(1.05 * rootState.propEffectiveCap, downCap));
+    const EdgeArray<double> downCap(clsDownstreamCaps[0], clsDownstreamCaps[0]);
+    clsSlews[0] =
+        1.05 * driver.computeSlew(min(1.05 * clsEffectiveCaps[0], downCap));
 
-    const int numNodes = clsNodes.size();
+    const int numNodes = getNumNodes();
     for (int n = 1; n < numNodes; n++) {  // 1 => skips root node
-      Node &node = clsNodes[n];
-      const Node &parent = clsNodes[node.propParent];
+      const int parent = clsParents[n];
 
-      const EdgeArray<double> S0 = parent.propSlew;
-      const EdgeArray<double> Ceff1 = node.propEffectiveCap;
-      const double R1 = node.propDrivingResistance;
+      const EdgeArray<double> S0 = clsSlews[parent];
+      const EdgeArray<double> Ceff1 = clsEffectiveCaps[n];
+      const double R1 = clsResistances[n];
 
       const EdgeArray<double> RCeff = R1 * Ceff1;
 
-      node.propDelay = parent.propDelay + RCeff;
+      clsDelays[n] = clsDelays[parent] + RCeff;
       // node.propSlew = S0 + 2.1*RCeff;
-      node.propSlew = S0 + 1.386 * RCeff;
+      clsSlews[n] = S0 + 1.386 * RCeff;
       // node.propSlew = S0 / ( 1.0 - ( (RCeff)/S0 )*(1.0 - exp(-S0/(RCeff) ) )
       // ); node.propSlew =
       // S0*max(EdgeArray<double>(1.0,1.0),node.propDelay/S0);
@@ -824,22 +1351,16 @@ class RCTreeDefault : public RCTreeBase {
   // -------------------------------------------------------------------------
 
   void stepBackward() {
-    const int numNodes = clsNodes.size();
+    const int numNodes = getNumNodes();
 
-    for (int i = 0; i < numNodes; i++) {
-      Node &node = clsNodes[i];
-
-      clsCeffs[i] = node.propEffectiveCap;
-      node.propEffectiveCap.set(node.propCap, node.propCap);
-    }  // end for
+    resetEffectiveCaps();
 
     for (int n = numNodes - 1; n > 0; n--) {  // n > 0 skips root node
-      const Node &sink = clsNodes[n];
-      Node &driver = clsNodes[sink.propParent];
+      const int driver = clsParents[n];
 
-      const EdgeArray<double> S0 = driver.propSlew;
+      const EdgeArray<double> S0 = clsSlews[driver];
       const EdgeArray<double> Ceff1 = clsCeffs[n];
-      const double R1 = sink.propDrivingResistance;
+      const double R1 = clsResistances[n];
 
       const EdgeArray<double> RCeff = 2.0 * R1 * Ceff1;
       const EdgeArray<double> K1 =
@@ -847,44 +1368,49 @@ class RCTreeDefault : public RCTreeBase {
       // driver.propEffectiveCap += K1 * sink.propDownstreamCap;
       // const EdgeArray<double> K1 = 1.0 -
       // min(EdgeArray<double>(1.0,1.0),(RCeff)/S0);
-      driver.propEffectiveCap += K1 * sink.propDownstreamCap;
+      clsEffectiveCaps[driver] += K1 * clsDownstreamCaps[n];
 
     }  // end for
   }    // end for
 
  public:
+  // Warm-started as RCTreeBase::simulate().
   template <class RCTreeDriver>
   void simulate(const RCTreeDriver &driver, const double epsilon = 1e-6,
-                const int maxIterations = 100) {
+                const int maxIterations = 100,
+                const EdgeArray<double> *initialCeff = NULL) {
     if (clsDirty) updateDownstreamCap();
 
-    const int numNodes = clsNodes.size();
+    const int numNodes = getNumNodes();
 
-    // Initially set effective capacitance equals to downstream capacitance.
-    for (int i = 0; i < numNodes; i++) {
-      Node &node = clsNodes[i];
-      node.propEffectiveCap = EdgeArray<double>(clsNodes[i].propDownstreamCap,
-                                                clsNodes[i].propDownstreamCap);
-    }  // end for
+    if (initialCeff) {
+      clsEffectiveCaps[0] = *initialCeff;
+    } else {
+      // Initially set effective capacitance equals to downstream capacitance.
+      for (int i = 0; i < numNodes; i++)
+        clsEffectiveCaps[i].set(clsDownstreamCaps[i], clsDownstreamCaps[i]);
+    }    // end else
+
+    clsNumSimulations++;
 
     bool converged = false;
-    EdgeArray<double> previousRootEffectiveCapacitance =
-        clsNodes[0].propEffectiveCap;
+    EdgeArray<double> previousRootEffectiveCapacitance = clsEffectiveCaps[0];
     for (int i = 0; i < maxIterations; i++) {
+      clsNumIterations++;
       stepForward(driver);
       stepBackward();
 
-      const Node &root = clsNodes[0];
+      const EdgeArray<double> &rootEffectiveCapacitance = clsEffectiveCaps[0];
 
       if (nearlyEqual(previousRootEffectiveCapacitance[RISE],
-                      root.propEffectiveCap[RISE], epsilon) &&
+                      rootEffectiveCapacitance[RISE], epsilon) &&
           nearlyEqual(previousRootEffectiveCapacitance[FALL],
-                      root.propEffectiveCap[FALL], epsilon)) {
+                      rootEffectiveCapacitance[FALL], epsilon)) {
         converged = true;
         break;
       }  // end if
 
-      previousRootEffectiveCapacitance = root.propEffectiveCap;
+      previousRootEffectiveCapacitance = rootEffectiveCapacitance;
     }  // end for
 
     if (!converged)
@@ -899,38 +1425,36 @@ class RCTreeDefault : public RCTreeBase {
 // Reimann's version of RCTree.
 // =============================================================================
 
-class RCTreeReimann : public RCTreeBase {
+class RCTreeReimann : public RCTreeSimulation<RCTreeReimann> {
+  friend class RCTreeSimulation<RCTreeReimann>;
+
  private:
   template <class RCTreeDriver>
   void stepForward(const RCTreeDriver &driver) {
-    Node &rootState = clsNodes[0];
-
-    const EdgeArray<double> downCap(rootState.propDownstreamCap,
-                                    rootState.propDownstreamCap);
+    const EdgeArray<double> downCap(clsDownstreamCaps[0], clsDownstreamCaps[0]);
     /*if (rootState.propEffectiveCap[RISE] < rootState.propDownstreamCap*0.9)
 rootState.propEffectiveCap[RISE] *= 0.75;
 if (rootState.propEffectiveCap[FALL] < rootState.propDownstreamCap*0.9)
 rootState.propEffectiveCap[FALL] *= 0.75;*/
-    rootState.propSlew = 0.99 * driver.computeSlew(rootState.propEffectiveCap);
+    clsSlews[0] = 0.99 * driver.computeSlew(clsEffectiveCaps[0]);
 
-    const EdgeArray<double> rootSlew = rootState.propSlew;
-    const int numNodes = clsNodes.size();
+    const EdgeArray<double> rootSlew = clsSlews[0];
+    const int numNodes = getNumNodes();
     for (int n = 1; n < numNodes; n++) {  // 1 => skips root node
-      Node &node = clsNodes[n];
-      const Node &parent = clsNodes[node.propParent];
+      const int parent = clsParents[n];
 
-      const EdgeArray<double> S0 = parent.propSlew;
-      const EdgeArray<double> Ceff1 = node.propEffectiveCap;
-      const double R1 = node.propDrivingResistance;
+      const EdgeArray<double> S0 = clsSlews[parent];
+      const EdgeArray<double> Ceff1 = clsEffectiveCaps[n];
+      const double R1 = clsResistances[n];
 
       const EdgeArray<double> RCeff = R1 * Ceff1;
       const EdgeArray<double> ratio = (RCeff) / S0;
 
       // cout << S0 << Ceff1 << R1 << endl;
 
-      node.propDelay = parent.propDelay + RCeff;
+      clsDelays[n] = clsDelays[parent] + RCeff;
       // node.propSlew = S0 + 0.5*RCeff;
-      node.propSlew = sqrt(S0 * S0 + 1.93 * RCeff * RCeff);
+      clsSlews[n] = sqrt(S0 * S0 + 1.93 * RCeff * RCeff);
       // node.propSlew = ( ( (node.propDelay[RISE] > S0[RISE]*0.2) &&
       // (node.propDelay[FALL] > S0[FALL]*0.2) )?(sqrt(S0*S0 + RCeff*RCeff)):S0
       // ); node.propSlew[RISE] =  ( (node.propDelay[RISE] > S0[RISE]*2.0)
@@ -950,23 +1474,17 @@ rootState.propEffectiveCap[FALL] *= 0.75;*/
   // -------------------------------------------------------------------------
 
   void stepBackward() {
-    const int numNodes = clsNodes.size();
-
-    for (int i = 0; i < numNodes; i++) {
-      Node &node = clsNodes[i];
+    const int numNodes = getNumNodes();
 
-      clsCeffs[i] = node.propEffectiveCap;
-      node.propEffectiveCap.set(node.propCap, node.propCap);
-    }  // end for
+    resetEffectiveCaps();
 
     for (int n = numNodes - 1; n > 0; n--) {  // n > 0 skips root node
-      const Node &sink = clsNodes[n];
-      Node &driver = clsNodes[sink.propParent];
+      const int driver = clsParents[n];
 
       const EdgeArray<double> one(0.999, 0.999);
-      const EdgeArray<double> S0 = driver.propSlew;
+      const EdgeArray<double> S0 = clsSlews[driver];
       const EdgeArray<double> Ceff1 = clsCeffs[n];
-      const double R1 = sink.propDrivingResistance;
+      const double R1 = clsResistances[n];
 
       const EdgeArray<double> RCeff = 2.0 * R1 * Ceff1;
       const EdgeArray<double> ratio = (RCeff) / S0;
@@ -976,51 +1494,53 @@ rootState.propEffectiveCap[FALL] *= 0.75;*/
       // driver.propEffectiveCap += K1 * sink.propDownstreamCap;
       // const EdgeArray<double> K1 = 1.0 -
       // min(EdgeArray<double>(1.0,1.0),(RCeff)/S0);
-      driver.propEffectiveCap += sink.propDownstreamCap;
+      clsEffectiveCaps[driver] += clsDownstreamCaps[n];
 
     }  // end for
   }    // end for
 
  public:
+  // Only the root Ceff is iterated (see
+  // computeEffectiveCapacitanceBasedOnJessica()), so warm-starting just seeds
+  // that iteration with initialCeff.
   template <class RCTreeDriver>
   void simulate(const RCTreeDriver &driver, const double epsilon = 1e-6,
-                const int maxIterations = 100) {
+                const int maxIterations = 100,
+                const EdgeArray<double> *initialCeff = NULL) {
     if (clsDirty) updateDownstreamCap();
 
-    const int numNodes = clsNodes.size();
+    clsNumSimulations++;
+
+    const int numNodes = getNumNodes();
 
     // Initially set effective capacitance equals to downstream capacitance.
-    for (int i = 0; i < numNodes; i++) {
-      Node &node = clsNodes[i];
-      node.propEffectiveCap = EdgeArray<double>(clsNodes[i].propDownstreamCap,
-                                                clsNodes[i].propDownstreamCap);
-    }  // end for
+    for (int i = 0; i < numNodes; i++)
+      clsEffectiveCaps[i].set(clsDownstreamCaps[i], clsDownstreamCaps[i]);
 
     bool converged = false;
-    clsNodes[0].propEffectiveCap = computeEffectiveCapacitanceBasedOnJessica(
-        driver, epsilon, maxIterations);
-    EdgeArray<double> previousRootEffectiveCapacitance =
-        clsNodes[0].propEffectiveCap;
+    clsEffectiveCaps[0] = computeEffectiveCapacitanceBasedOnJessica(
+        driver, epsilon, maxIterations, initialCeff);
+    EdgeArray<double> previousRootEffectiveCapacitance = clsEffectiveCaps[0];
     for (int i = 0; i < maxIterations; i++) {
       stepForward(driver);
       // stepBackward();
       break;
-      const Node &root = clsNodes[0];
+      const EdgeArray<double> &rootEffectiveCapacitance = clsEffectiveCaps[0];
 
       if (nearlyEqual(previousRootEffectiveCapacitance[RISE],
-                      root.propEffectiveCap[RISE], epsilon) &&
+                      rootEffectiveCapacitance[RISE], epsilon) &&
           nearlyEqual(previousRootEffectiveCapacitance[FALL],
-                      root.propEffectiveCap[FALL], epsilon)) {
+                      rootEffectiveCapacitance[FALL], epsilon)) {
         converged = true;
         break;
       }  // end if
 
-      previousRootEffectiveCapacitance = root.propEffectiveCap;
+      previousRootEffectiveCapacitance = rootEffectiveCapacitance;
     }  // end for
-       /*if (clsNodes[0].propEffectiveCap[RISE] <
-   clsNodes[0].propDownstreamCap*0.9)    clsNodes[0].propEffectiveCap[RISE] *=
-   0.75;    if (clsNodes[0].propEffectiveCap[FALL] <
-   clsNodes[0].propDownstreamCap*0.9)    clsNodes[0].propEffectiveCap[FALL] *=
+       /*if (clsEffectiveCaps[0][RISE] <
+   clsDownstreamCaps[0]*0.9)    clsEffectiveCaps[0][RISE] *=
+   0.75;    if (clsEffectiveCaps[0][FALL] <
+   clsDownstreamCaps[0]*0.9)    clsEffectiveCaps[0][FALL] *=
    0.75;*/
     // if ( !converged )
     //	cout << "[WARNING] Simulation for RC tree driven by node '" <<
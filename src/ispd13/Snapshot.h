@@ -0,0 +1,221 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+// Binary snapshots made of flat arrays. The file starts with a magic string,
+// a format version, the payload size and a checksum of the payload. Arrays
+// in the payload are 8-byte aligned, so that they can be used in place once
+// the file is memory mapped.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class Snapshot {
+ public:
+  struct Header {
+    char magic[8];
+    int version;
+    int reserved;
+    unsigned long long payloadSize;
+    unsigned long long checksum;
+  };  // end struct
+
+  // FNV-1a over 8-byte words.
+  static unsigned long long checksum(const char *data, const size_t size) {
+    unsigned long long hash = 14695981039346656037ull;
+    const size_t numWords = size / 8;
+    for (size_t i = 0; i < numWords; i++) {
+      unsigned long long word;
+      std::memcpy(&word, data + 8 * i, 8);
+      hash ^= word;
+      hash *= 1099511628211ull;
+    }  // end for
+    for (size_t i = 8 * numWords; i < size; i++) {
+      hash ^= (unsigned char)data[i];
+      hash *= 1099511628211ull;
+    }  // end for
+    return hash;
+  }  // end method
+
+  // Size and checksum of the contents of a source file.
+  static bool getFileChecksum(const std::string &filename, long long &size,
+                              unsigned long long &hash) {
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    if (ok) {
+      size = st.st_size;
+      if (size == 0) {
+        hash = checksum(0, 0);
+      } else {
+        void *data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ok = data != MAP_FAILED;
+        if (ok) {
+          hash = checksum((const char *)data, size);
+          munmap(data, size);
+        }  // end if
+      }    // end else
+    }      // end if
+    ::close(fd);
+    return ok;
+  }  // end method
+};  // end class
+
+// -----------------------------------------------------------------------------
+
+class SnapshotWriter {
+ private:
+  std::vector<char> clsPayload;
+
+ public:
+  template <class T>
+  void writeArray(const T *data, const size_t n) {
+    const size_t size = n * sizeof(T);
+    const size_t offset = clsPayload.size();
+    clsPayload.resize(offset + ((size + 7) & ~size_t(7)), 0);
+    if (size > 0) std::memcpy(&clsPayload[offset], data, size);
+  }  // end method
+
+  template <class T>
+  void write(const T &value) {
+    writeArray(&value, 1);
+  }  // end method
+
+  // The size followed by the elements.
+  template <class T>
+  void writeVector(const std::vector<T> &v) {
+    write((unsigned long long)v.size());
+    writeArray(v.data(), v.size());
+  }  // end method
+
+  void writeString(const std::string &s) {
+    write((unsigned long long)s.size());
+    writeArray(s.data(), s.size());
+  }  // end method
+
+  bool empty() const { return clsPayload.empty(); }
+  void clear() { std::vector<char>().swap(clsPayload); }
+
+  bool save(const std::string &filename, const char *magic,
+            const int version) const {
+    Snapshot::Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic,
+                std::min(std::strlen(magic), sizeof(header.magic)));
+    header.version = version;
+    header.payloadSize = clsPayload.size();
+    header.checksum = Snapshot::checksum(clsPayload.data(), clsPayload.size());
+
+    std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+    out.write((const char *)&header, sizeof(header));
+    out.write(clsPayload.data(), clsPayload.size());
+    return (bool)out;
+  }  // end method
+};  // end class
+
+// -----------------------------------------------------------------------------
+
+class SnapshotReader {
+ private:
+  const char *clsData;
+  size_t clsSize;
+  const char *clsCursor;
+  const char *clsEnd;
+
+  SnapshotReader(const SnapshotReader &);
+  SnapshotReader &operator=(const SnapshotReader &);
+
+ public:
+  SnapshotReader() : clsData(0), clsSize(0), clsCursor(0), clsEnd(0) {}
+  ~SnapshotReader() { close(); }
+
+  // Maps the file and checks its magic, version and checksum.
+  bool open(const std::string &filename, const char *magic,
+            const int version) {
+    close();
+
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(Snapshot::Header)) {
+      void *data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        clsData = (const char *)data;
+        clsSize = st.st_size;
+      }  // end if
+    }    // end if
+    ::close(fd);
+    if (!clsData) return false;
+
+    Snapshot::Header header;
+    std::memcpy(&header, clsData, sizeof(header));
+    clsCursor = clsData + sizeof(header);
+    clsEnd = clsCursor + header.payloadSize;
+
+    if (std::strncmp(header.magic, magic, sizeof(header.magic)) != 0 ||
+        header.version != version ||
+        header.payloadSize != clsSize - sizeof(header) ||
+        header.checksum != Snapshot::checksum(clsCursor, header.payloadSize)) {
+      close();
+      return false;
+    }  // end if
+    return true;
+  }  // end method
+
+  void close() {
+    if (clsData) munmap((void *)clsData, clsSize);
+    clsData = 0;
+    clsSize = 0;
+    clsCursor = 0;
+    clsEnd = 0;
+  }  // end method
+
+  // Returns the next n elements in place, or null if the payload is too
+  // short.
+  template <class T>
+  const T *readArray(const size_t n) {
+    if (n > size_t(clsEnd - clsCursor) / sizeof(T)) return 0;
+    const size_t size = n * sizeof(T);
+    const T *data = (const T *)clsCursor;
+    clsCursor += std::min(size_t(clsEnd - clsCursor), (size + 7) & ~size_t(7));
+    return data;
+  }  // end method
+
+  template <class T>
+  bool read(T &value) {
+    const T *data = readArray<T>(1);
+    if (data) value = *data;
+    return data != 0;
+  }  // end method
+
+  template <class T>
+  bool readVector(std::vector<T> &v) {
+    unsigned long long n;
+    if (!read(n)) return false;
+    const T *data = readArray<T>(n);
+    if (data) v.assign(data, data + n);
+    return data != 0;
+  }  // end method
+
+  bool readString(std::string &s) {
+    unsigned long long n;
+    if (!read(n)) return false;
+    const char *data = readArray<char>(n);
+    if (data) s.assign(data, n);
+    return data != 0;
+  }  // end method
+
+  bool isOpen() const { return clsData != 0; }
+};  // end class
+
+#endif
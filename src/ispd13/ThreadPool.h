@@ -0,0 +1,225 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// Work-stealing thread pool used by the parallel timing engine.
+//
+// Work is described as ranges [begin, end) of integers (e.g. net indexes).
+// Each thread owns a deque of ranges. The owner pushes and pops at the back
+// while idle threads steal from the front of other deques. The thread calling
+// run() or parallelFor() takes part in the work as thread 0 and the call only
+// returns after all work items have been processed.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+ public:
+  // Args: thread id, begin, end.
+  typedef std::function<void(const int, const int, const int)> Task;
+
+ private:
+  struct Range {
+    int begin;
+    int end;
+  };  // end struct
+
+  // Aligned to avoid false sharing between neighbour deques.
+  struct alignas(64) Queue {
+    std::mutex mutex;
+    std::deque<Range> ranges;
+  };  // end struct
+
+  std::vector<std::thread> clsThreads;
+  std::unique_ptr<Queue[]> clsQueues;
+  int clsNumThreads;
+
+  // Job dispatching.
+  std::mutex clsMutex;
+  std::condition_variable clsWakeUp;
+  std::condition_variable clsDone;
+  const Task *clsTask;
+  unsigned clsGeneration;
+  int clsNumBusyHelpers;
+  bool clsShutdown;
+
+  // Number of work items not processed yet in the current job.
+  std::atomic<int> clsRemaining;
+
+  // ---------------------------------------------------------------------------
+
+  bool pop(const int threadId, Range &range) {
+    Queue &queue = clsQueues[threadId];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.ranges.empty()) return false;
+    range = queue.ranges.back();
+    queue.ranges.pop_back();
+    return true;
+  }  // end method
+
+  // ---------------------------------------------------------------------------
+
+  bool steal(const int threadId, Range &range) {
+    for (int i = 1; i < clsNumThreads; i++) {
+      Queue &queue = clsQueues[(threadId + i) % clsNumThreads];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.ranges.empty()) {
+        range = queue.ranges.front();
+        queue.ranges.pop_front();
+        return true;
+      }  // end if
+    }    // end for
+    return false;
+  }  // end method
+
+  // ---------------------------------------------------------------------------
+
+  void work(const int threadId, const Task &task) {
+    Range range;
+    while (clsRemaining.load(std::memory_order_acquire) > 0) {
+      if (pop(threadId, range) || steal(threadId, range)) {
+        task(threadId, range.begin, range.end);
+        clsRemaining.fetch_sub(1, std::memory_order_acq_rel);
+      } else {
+        std::this_thread::yield();
+      }  // end else
+    }    // end while
+  }      // end method
+
+  // ---------------------------------------------------------------------------
+
+  void helper(const int threadId) {
+    unsigned generation = 0;
+    while (true) {
+      const Task *task;
+      {
+        std::unique_lock<std::mutex> lock(clsMutex);
+        clsWakeUp.wait(lock, [&] {
+          return clsShutdown || clsGeneration != generation;
+        });
+        if (clsShutdown) return;
+        generation = clsGeneration;
+        task = clsTask;
+      }
+
+      work(threadId, *task);
+
+      {
+        std::lock_guard<std::mutex> lock(clsMutex);
+        if (--clsNumBusyHelpers == 0) clsDone.notify_one();
+      }
+    }  // end while
+  }    // end method
+
+  // ---------------------------------------------------------------------------
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(clsMutex);
+      clsShutdown = true;
+    }
+    clsWakeUp.notify_all();
+    for (int i = 0; i < clsThreads.size(); i++) clsThreads[i].join();
+    clsThreads.clear();
+  }  // end method
+
+ public:
+  ThreadPool()
+      : clsNumThreads(0),
+        clsTask(NULL),
+        clsGeneration(0),
+        clsNumBusyHelpers(0),
+        clsShutdown(false),
+        clsRemaining(0) {
+    resize(1);
+  }  // end constructor
+
+  ~ThreadPool() { stop(); }
+
+  // ---------------------------------------------------------------------------
+
+  // Sets the number of threads including the calling thread. Must not be
+  // called while a job is running.
+  void resize(const int numThreads) {
+    stop();
+
+    clsNumThreads = std::max(1, numThreads);
+    clsQueues.reset(new Queue[clsNumThreads]);
+    clsShutdown = false;
+    clsGeneration = 0;
+
+    for (int i = 1; i < clsNumThreads; i++)
+      clsThreads.push_back(std::thread(&ThreadPool::helper, this, i));
+  }  // end method
+
+  // ---------------------------------------------------------------------------
+
+  int getNumThreads() const { return clsNumThreads; }
+
+  // ---------------------------------------------------------------------------
+
+  // Adds a work item to the deque of thread threadId. May be called from
+  // inside a task (to release new work) or before run() to seed the deques.
+  void push(const int threadId, const int begin, const int end) {
+    Queue &queue = clsQueues[threadId];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    Range range = {begin, end};
+    queue.ranges.push_back(range);
+  }  // end method
+
+  // ---------------------------------------------------------------------------
+
+  // Runs until numWorkItems ranges have been processed. Ranges not seeded
+  // beforehand must be pushed by the tasks themselves.
+  void run(const int numWorkItems, const Task &task) {
+    if (numWorkItems <= 0) return;
+
+    clsRemaining.store(numWorkItems, std::memory_order_release);
+
+    {
+      std::lock_guard<std::mutex> lock(clsMutex);
+      clsTask = &task;
+      clsNumBusyHelpers = clsNumThreads - 1;
+      clsGeneration++;
+    }
+    clsWakeUp.notify_all();
+
+    work(0, task);
+
+    std::unique_lock<std::mutex> lock(clsMutex);
+    clsDone.wait(lock, [&] { return clsNumBusyHelpers == 0; });
+    clsTask = NULL;
+  }  // end method
+
+  // ---------------------------------------------------------------------------
+
+  // Runs task over the chunks [chunks[i], chunks[i+1]). Consecutive chunks are
+  // handed to the same thread so that, without stealing, each thread sweeps a
+  // contiguous block of indexes.
+  void parallelFor(const std::vector<int> &chunks, const Task &task) {
+    const int numChunks = (int)chunks.size() - 1;
+    if (numChunks <= 0) return;
+
+    if (numChunks == 1 || clsNumThreads == 1) {
+      for (int i = 0; i < numChunks; i++) task(0, chunks[i], chunks[i + 1]);
+      return;
+    }  // end if
+
+    // Pushed in reverse order as the owner pops from the back.
+    for (int i = numChunks - 1; i >= 0; i--) {
+      const int threadId = (int)(((long long)i * clsNumThreads) / numChunks);
+      push(threadId, chunks[i], chunks[i + 1]);
+    }  // end for
+
+    run(numChunks, task);
+  }  // end method
+
+};  // end class
+
+#endif
@@ -15,9 +15,29 @@
 
 #include "ispd13/Circuit.h"
 
-string Vcell::returnNetConnectedToPin(const string &pinName) const {
-  for (int i = 0; i < pinNetPairs.size(); i++)
-    if (pinNetPairs[i].first == pinName) return pinNetPairs[i].second;
+int Vcell::findPin(const VerilogFlatNetlist &netlist,
+                   const string &pinName) const {
+  const int id = netlist.pinNames.find(pinName);
+  if (id == -1) return -1;
+  for (int k = 0; k < numPins; k++)
+    if (getPinNameId(netlist, k) == id) return k;
+  return -1;
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+int Vcell::findNetConnectedToPin(const VerilogFlatNetlist &netlist,
+                                 const string &pinName) const {
+  const int k = findPin(netlist, pinName);
+  return k == -1 ? -1 : getPinNetId(netlist, k);
+}  // end method
+
+// -----------------------------------------------------------------------------
+
+string Vcell::returnNetConnectedToPin(const VerilogFlatNetlist &netlist,
+                                      const string &pinName) const {
+  const int n = findNetConnectedToPin(netlist, pinName);
+  if (n != -1) return netlist.netNames.getString(n);
 #ifndef NDEBUG
   cerr << "[BUG] @ Vcell::returnNetConnectedToPin() - Pin name '" << pinName
        << "' not found.\n";
@@ -39,7 +59,7 @@ int Vcell::returnPinIndex(const string &pinName) const {
 
 // -----------------------------------------------------------------------------
 
-void Vcell::cellTiming() {
+void Vcell::cellTiming(const VerilogFlatNetlist &netlist) {
   // calc timing for tmpCell
   // rise and fall separately
   // keeps worst delay and worst slew (according to ISPD slides)
@@ -70,12 +90,8 @@ void Vcell::cellTiming() {
   // tmpCell->instName << "\t(" << cellInst->name << ")" << endl;
 
   for (int i = 0; i < cellInst->timingArcs.size(); ++i) {
-    int j = 0;
-
-    for (j = 0; j < this->pinNetPairs.size(); ++j) {
-      if (cellInst->timingArcs[i].fromPin == this->pinNetPairs[j].first) break;
-    }
-    assert(j != this->pinNetPairs.size());
+    const int j = this->findPin(netlist, cellInst->timingArcs[i].fromPin);
+    assert(j != -1);
 
     if (cellInst->timingArcs[i].toPin != "o") continue;
     /*
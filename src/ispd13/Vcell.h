@@ -50,15 +50,24 @@ class EdgeType {
 
 class Vcell {
  public:
-  vector<Vcell *> previousCells, nextCells;
-  string instName;
-  string instType;
+  // ---------------------------------------------------------------------------
+  // Sizing state. These fields are read by every sizing sweep, so they are
+  // kept together at the head of the object.
+  // ---------------------------------------------------------------------------
+
+  LibParserCellInfo *actualInstType;
+  int actualInstTypeIndex, footprintIndex;
 
-  // The cloud id this cell belongs to.
-  // int cloud;
-  // int changes;
-  // int trials;
-  // set<CLOUD_TYPE> clouds;
+  // Timing net index.
+  // [WARNING] Assuming cell has only one output.
+  // [TODO] Support multiple outputs.
+  int sinkNetIndex;
+
+  // This cell index in the Circuit::icells vector.
+  int vectorIndex;
+
+  // This cell index in the Circuit::depthSortedIndex.
+  int depthIndex;
 
   // The logical depth indicates the maximum depth over all cell inputs. The
   // depth of an input is the number of steps required to reach such input
@@ -66,12 +75,57 @@ class Vcell {
   // flops and input drivers have zero logical depth.
   int logicalDepth;
 
+  int treeIndex;
+
+  bool dontTouch, changed;
+
+  // Total cell load capacitance (sinks, wires, primary outputs).
+  double actualLoad;
+
+  // Load capacitance caused by wires.
+  double wireLoad;
+
+  // Load capacitance associated to a primary output of the circuit. Zero for
+  // cells not driving a primary output.
+  double portLoad;
+
+  // Load capacitance caused by sink cells.
+  double outputLoad;
+
   // Similar to logical depth, however the depths are computed walking from
   // path tails to path heads. Flip-flops and input driver have a non-zero
   // reverse logical depth and the maximum reverse logical depth cell is
   // always a flip-flop or input driver.
   int reverseLogicalDepth;
 
+  // Auxiliary. Indicate how many times this cell has been visited in a walk.
+  // For instance, when this count reaches the number of inputs of a cell,
+  // we know that all paths to such cell have been covered.
+  // [TODO] Put this flag outside the Vcell structure to make it thread safe.
+  int visitcount;
+
+  // next cells counter
+  int nextNum;
+
+  // ---------------------------------------------------------------------------
+  // Names, connectivity and state of the legacy (ISPD 2012) heuristics.
+  // ---------------------------------------------------------------------------
+
+  string instName;
+
+  vector<Vcell *> previousCells, nextCells;
+
+  // Pins of this cell: the range [pinPointer, pinPointer + numPins) of the
+  // pin (VerilogFlatNetlist::cellPins) and net (cellPinNets) ids of the
+  // netlist. The pins of the SDC input drivers are appended after the ones
+  // of the netlist cells (see Circuit::readSDC()).
+  int pinPointer;
+  int numPins;
+
+  vector<pair<double, double> > delays;      // first = rise, second = fall
+  vector<pair<double, double> > inputSlews;  // first = rise, second = fall
+  int pinOk;  // pinOk => number of pins with inputSlew ready
+
   // The delay this cell is expected to have in order to match the circuit
   // timing requirements. This delay is computed so that each cell contributes
   // proportionately to the path delay. For instance, a cell at a branch-less
@@ -81,19 +135,6 @@ class Vcell {
   double expectedDelay;
   double expectedArrivalTime;
 
-  // Total cell load capacitance (sinks, wires, primary outputs).
-  double actualLoad;
-
-  // Load capacitance caused by wires.
-  double wireLoad;
-
-  // Load capacitance caused by sink cells.
-  double outputLoad;
-
-  // Load capacitance associated to a primary output of the circuit. Zero for
-  // cells not driving a primary output.
-  double portLoad;
-
   // Branching effort of the cell ((Con + Coff)/Con)
   double branchingEffort;
 
@@ -102,23 +143,13 @@ class Vcell {
   double outputFallSlew;
 
   // Output delay based solely on the cell look-up table.
-  union {
-    struct {
-      double outputRiseDelay;
-      double outputFallDelay;
-    };
-    double outputDelay[2];
-  };
+  double outputRiseDelay;
+  double outputFallDelay;
 
   // Slacks calculated at this cell. (clock period minus output arrival time)
   double actualRiseSlack;
   double actualFallSlack;
 
-  // The worst path slack passing through this cell. These slacks are computed
-  // at the end of paths and propagated back to each cell on the path.
-  // double worstRiseSlack;
-  // double worstFallSlack;
-
   // slew target, delta slew target and maximum slew limit for the output pin p
   // (p is induced by the attached sinks)
   double fallSlewTarget;
@@ -140,8 +171,6 @@ class Vcell {
   double globalCriticalityOutputPinFall;
   double globalCriticalityOutputPinRise;
 
-  double mustafaCriticality;
-
   // The worst path slack passing through this cell. These slacks are computed
   // at the end of paths and propagated back to each cell according to the path.
   union {
@@ -152,102 +181,64 @@ class Vcell {
     double worstPathSlack[2];
   };
 
-  // Auxiliary: ???
-  double worstRiseDelayToEndpoint;
-  double worstFallDelayToEndpoint;
-
-  // This cell index in the Circuit::icells vector.
-  int vectorIndex;
-
-  // This cell index in the Circuit::depthSortedIndex.
-  int depthIndex;
-
-  // Timing net index.
-  // [WARNING] Assuming cell has only one output.
-  // [TODO] Support multiple outputs.
-  int sinkNetIndex;
+  // ---------------------------------------------------------------------------
 
-  // clock period
-  // double clkPeriod;
+  int getPinNameId(const VerilogFlatNetlist &netlist, const int k) const {
+    return netlist.cellPins[pinPointer + k];
+  }  // end method
+  int getPinNetId(const VerilogFlatNetlist &netlist, const int k) const {
+    return netlist.cellPinNets[pinPointer + k];
+  }  // end method
 
-  // next cells counter
-  int nextNum;
+  // Index of the pin named pinName among the pins of this cell, or -1.
+  int findPin(const VerilogFlatNetlist &netlist, const string &pinName) const;
 
-  // previous cells counter
-  // int prevNum;
+  // Id of the net connected to the pin named pinName, or -1.
+  int findNetConnectedToPin(const VerilogFlatNetlist &netlist,
+                            const string &pinName) const;
 
-  // LR lambdas
-  // double lambdaDelay, lambdaMaxCap, lambdaMaxSlew;
-
-  LibParserCellInfo *actualInstType;
-  int actualInstTypeIndex, footprintIndex,
-      pinOk;  // pinOk => number of pins with inputSlew ready
-  bool dontTouch, changed;
-
-  // Auxiliary. Indicate how many times this cell has been visited in a walk.
-  // For instance, when this count reaches the number of inputs of a cell,
-  // we know that all paths to such cell have been covered.
-  // [TODO] Put this flag outside the Vcell structure to make it thread safe.
-  int visitcount;
-
-  vector<pair<string, string> > pinNetPairs;
-  vector<pair<double, double> > delays;  // first = rise, second = fall
-  // vector< pair<double,double> > arrivalTimes;				//first
-  // = rise, second = fall
-  vector<pair<double, double> > inputSlews;  // first = rise, second = fall
-
-  string returnNetConnectedToPin(const string &pinName) const;
+  string returnNetConnectedToPin(const VerilogFlatNetlist &netlist,
+                                 const string &pinName) const;
   int returnPinIndex(const string &pinName) const;
 
   int getPathDepth() const { return logicalDepth + reverseLogicalDepth; }
 
   double getLeakagePower() const { return actualInstType->leakagePower; }
 
+  // Name of the current cell type.
+  const string &getTypeName() const { return actualInstType->name; }
+
   // Vcell* cpyCellInfo();
-  void cellTiming();
+  void cellTiming(const VerilogFlatNetlist &netlist);
   // void cellTiming2();
   // void newCellTiming(LibParserCellInfo * cellInst);
   // void setNewCellSize();
-  bool needTimer;
-  // bool skip;
-  int treeIndex;
 
   Vcell()
-      : treeIndex(-1),
-        // lambdaDelay(0),
-        // lambdaMaxCap(0),
-        // lambdaMaxSlew(0),
-        needTimer(false),
-        pinOk(0),
-        // prevNum (0),
-        nextNum(0),
-        // worstRiseSlack (0.0),
-        // worstFallSlack (0.0),
-        outputRiseSlew(0.0),
-        outputFallSlew(0.0),
-        portLoad(0.0),
-        actualRiseSlack(0.0),
-        actualFallSlack(0.0),
-        actualLoad(0.0),
+      : actualInstType(NULL),
         actualInstTypeIndex(0),
         footprintIndex(0),
-        wireLoad(0.0),
-        outputLoad(0.0),
-        dontTouch(false),
-        changed(false),
-        actualInstType(NULL),
-        logicalDepth(-1),
         sinkNetIndex(-1),
         vectorIndex(-1),
         depthIndex(-1),
+        logicalDepth(-1),
+        treeIndex(-1),
+        dontTouch(false),
+        changed(false),
+        actualLoad(0.0),
+        wireLoad(0.0),
+        portLoad(0.0),
+        outputLoad(0.0),
+        nextNum(0),
+        pinPointer(0),
+        numPins(0),
+        pinOk(0),
         expectedDelay(0.0),
         expectedArrivalTime(0.0),
-        mustafaCriticality(0)
-  // cloud(-1),
-  // changes(0),
-  // skip(false),
-  // trials(0)
-  {}
+        outputRiseSlew(0.0),
+        outputFallSlew(0.0),
+        actualRiseSlack(0.0),
+        actualFallSlack(0.0) {}
 };
 
 #endif  // _VCELL_H_
@@ -20,3 +20,43 @@ LibParserCellInfo* OrgCells::findCellInst(string instType) {
 
   return NULL;
 }
+
+void OrgCells::buildLUTArena() {
+  const int numFootprints = oCells.size();
+
+  size_t size = 0;
+  for (int i = 0; i < numFootprints; ++i) {
+    const int numCells = oCells[i].cells.size();
+    for (int j = 0; j < numCells; ++j) {
+      const vector<LibParserTimingInfo>& arcs = oCells[i].cells[j].timingArcs;
+      const int numArcs = arcs.size();
+      for (int k = 0; k < numArcs; ++k) {
+        size += arcs[k].flat.getDataSize();
+        size += arcs[k].riseDelay.flat.getDataSize();
+        size += arcs[k].fallDelay.flat.getDataSize();
+        size += arcs[k].riseTransition.flat.getDataSize();
+        size += arcs[k].fallTransition.flat.getDataSize();
+      }  // end for
+    }    // end for
+  }      // end for
+
+  // Tables already in the arena are copied to the new one before the old one
+  // is released.
+  vector<double> arena(size);
+  double* dst = arena.data();
+  for (int i = 0; i < numFootprints; ++i) {
+    const int numCells = oCells[i].cells.size();
+    for (int j = 0; j < numCells; ++j) {
+      vector<LibParserTimingInfo>& arcs = oCells[i].cells[j].timingArcs;
+      const int numArcs = arcs.size();
+      for (int k = 0; k < numArcs; ++k) {
+        dst = arcs[k].flat.relocate(dst);
+        dst = arcs[k].riseDelay.flat.relocate(dst);
+        dst = arcs[k].fallDelay.flat.relocate(dst);
+        dst = arcs[k].riseTransition.flat.relocate(dst);
+        dst = arcs[k].fallTransition.flat.relocate(dst);
+      }  // end for
+    }    // end for
+  }      // end for
+  lutArena.swap(arena);
+}
@@ -9,6 +9,7 @@
 
 #ifndef _GLOBAL_H_
 #define _GLOBAL_H_
+#include <cstdlib>
 #include <map>
 #include <queue>
 #include <set>
@@ -22,8 +23,8 @@ using namespace std;
 
 class comp_cellLeakage {  // make heap
  public:
-  bool operator()(const LibParserCellInfo c1,
-                  const LibParserCellInfo c2) const {
+  bool operator()(const LibParserCellInfo& c1,
+                  const LibParserCellInfo& c2) const {
     if ((c2.leakagePower > c1.leakagePower) ||
         ((c2.leakagePower == c1.leakagePower) &&
          (c2.pins[0].maxCapacitance < c1.pins[0].maxCapacitance)))
@@ -51,7 +52,15 @@ class OrgCells {
  public:
   vector<OrdCells> oCells;
 
+  // Contiguous storage of all flattened timing tables of the library in
+  // footprint, cell and arc order.
+  vector<double> lutArena;
+
   LibParserCellInfo* findCellInst(string instType);
+
+  // Relocates the flattened timing tables into lutArena. Must be called once
+  // the cells are in place.
+  void buildLUTArena();
 };
 
 class Wire {
@@ -100,17 +109,6 @@ class SDCInfo {
   vector<OutputLoad> output_loads;
 };
 
-class Net {
- public:
-  string netName;
-  set<Vcell*>* cells;
-  int numPins;
-  bool operator<(const Net& w1) const { return (netName < w1.netName); }
-  bool operator==(const Net& w1) const { return (netName == w1.netName); }
-  bool operator>(const Net& w1) const { return (netName > w1.netName); }
-  bool operator!=(const Net& w1) const { return (netName != w1.netName); }
-};
-
 class AddrCell {
  public:
   string instName;
@@ -170,6 +168,14 @@ class App {
     return "";
   }  // end method
 
+  // Returns the first value defined for an option specified by key as a
+  // number. If no option or value exists, defaultValue is returned.
+  static double getOptionValueAsDouble(const string& key,
+                                       const double defaultValue) {
+    const string value = getOptionValue(key);
+    return value.empty() ? defaultValue : atof(value.c_str());
+  }  // end method
+
   // Parse the command line arguments.
   static void parseCommandLineArguments(const int argc, char** argv,
                                         int offset) {
@@ -213,42 +219,53 @@ class App {
 extern App app;
 
 inline double lookup(const LibParserLUT& lut, const double x, const double y) {
-  double weightX, weightY;
-  double xLower, xUpper, yLower, yUpper;
-  int xLowerIndex, xUpperIndex, yLowerIndex, yUpperIndex, xLimit, yLimit;
-
-  xLowerIndex = xUpperIndex = yLowerIndex = yUpperIndex = 0;
-  xLimit = lut.loadIndices.size() - 2;
-  yLimit = lut.transitionIndices.size() - 2;
-
-  // no loads viol. are accepted -> not anymore
-  while ((xLowerIndex < xLimit) && (lut.loadIndices[xLowerIndex + 1] <= x))
-    ++xLowerIndex;
-  xUpperIndex = xLowerIndex + 1;
-
-  while ((yLowerIndex < yLimit) &&
-         (lut.transitionIndices[yLowerIndex + 1] <= y))
-    ++yLowerIndex;
-  yUpperIndex = yLowerIndex + 1;
-
-  xLower = lut.loadIndices[xLowerIndex];
-  xUpper = lut.loadIndices[xUpperIndex];
-  yLower = lut.transitionIndices[yLowerIndex];
-  yUpper = lut.transitionIndices[yUpperIndex];
-
-  weightX = (x - xLower) / (xUpper - xLower);
-  weightY = (y - yLower) / (yUpper - yLower);
-
-  double result;
-  result = (1.0 - weightX) * (1.0 - weightY) *
-           (lut.tableVals[xLowerIndex][yLowerIndex]);
-  result +=
-      (weightX) * (1.0 - weightY) * (lut.tableVals[xUpperIndex][yLowerIndex]);
-  result +=
-      (1.0 - weightX) * (weightY) * (lut.tableVals[xLowerIndex][yUpperIndex]);
-  result += (weightX) * (weightY) * (lut.tableVals[xUpperIndex][yUpperIndex]);
-
-  return result;
+  return lut.flat.lookup(x, y);
+}  // end method
+
+// Evaluates delay and output slew of a timing arc in one call. Rise values
+// are indexed by the rise load and the fall input slew and vice-versa.
+inline void lookup(const LibParserTimingInfo& timingInfo,
+                   const double riseLoad, const double fallLoad,
+                   const double riseSlew, const double fallSlew,
+                   double& riseDelay, double& fallDelay,
+                   double& riseOutputSlew, double& fallOutputSlew) {
+  if (timingInfo.flat.isEmpty()) {
+    riseDelay = lookup(timingInfo.riseDelay, riseLoad, fallSlew);
+    fallDelay = lookup(timingInfo.fallDelay, fallLoad, riseSlew);
+    riseOutputSlew = lookup(timingInfo.riseTransition, riseLoad, fallSlew);
+    fallOutputSlew = lookup(timingInfo.fallTransition, fallLoad, riseSlew);
+    return;
+  }  // end if
+
+  const double x[4] = {riseLoad, fallLoad, riseLoad, fallLoad};
+  const double y[4] = {fallSlew, riseSlew, fallSlew, riseSlew};
+  double result[4];
+  timingInfo.flat.lookup(x, y, result);
+
+  riseDelay = result[FlatTimingArcLUT::RISE_DELAY];
+  fallDelay = result[FlatTimingArcLUT::FALL_DELAY];
+  riseOutputSlew = result[FlatTimingArcLUT::RISE_SLEW];
+  fallOutputSlew = result[FlatTimingArcLUT::FALL_SLEW];
+}  // end method
+
+// Rise and fall delays of a timing arc, indexed as above. With AVX2 the
+// combined table is used, as one gathered lookup is cheaper than two scalar
+// ones. Otherwise its scalar fallback would evaluate all four tables, so only
+// the two delay tables are looked up.
+inline void lookupDelay(const LibParserTimingInfo& timingInfo,
+                        const double riseLoad, const double fallLoad,
+                        const double riseSlew, const double fallSlew,
+                        double& riseDelay, double& fallDelay) {
+#ifdef __AVX2__
+  if (!timingInfo.flat.isEmpty()) {
+    double riseOutputSlew, fallOutputSlew;
+    lookup(timingInfo, riseLoad, fallLoad, riseSlew, fallSlew, riseDelay,
+           fallDelay, riseOutputSlew, fallOutputSlew);
+    return;
+  }  // end if
+#endif
+  riseDelay = lookup(timingInfo.riseDelay, riseLoad, fallSlew);
+  fallDelay = lookup(timingInfo.fallDelay, fallLoad, riseSlew);
 }  // end method
 
 #endif  //_GLOBAL_H_
@@ -31,6 +31,13 @@
 App::OptionMap App::clsOptions;
 App app;
 
+// RC tree reports requested on the command line (-rc-report, -rc-sharing),
+// printed at the end of the flows.
+void printRCTreeReports(Circuit &circuit) {
+  if (app.hasOption("rc-report")) circuit.printRCTreeReport(cout);
+  if (app.hasOption("rc-sharing")) circuit.reportRCTreeSharingError(cout);
+}  // end method
+
 int main(int argc, char *argv[]) {
   Stopwatch runtime;
   runtime.start();
@@ -188,6 +195,7 @@ void flowTiago(string benchmarkName, string dirRoot) {
   // myCircuit.calcTiming();
   myCircuit.updateTiming();
   myCircuit.printTiming("Final Solution");
+  printRCTreeReports(myCircuit);
 
   return;
 
@@ -406,6 +414,7 @@ void flowGraci(string benchmarkName, string dirRoot) {
   // myCircuit.calcTiming();
   myCircuit.updateTiming();
   myCircuit.printTiming("Final Solution");
+  printRCTreeReports(myCircuit);
 
   return;
 }
@@ -720,6 +729,7 @@ void flowFlach(string benchmarkName, string dirRoot) {
   // myCircuit.calcTiming();
   myCircuit.updateTiming();
   myCircuit.printTiming("Final Solution");
+  printRCTreeReports(myCircuit);
   myCircuit.printSigth("out.sight");
   myCircuit.saveSizes();
 }
@@ -803,6 +813,7 @@ myCircuit.updateTiming();
 
   myCircuit.updateTiming();
   myCircuit.printTiming("Final Solution");
+  printRCTreeReports(myCircuit);
   // myCircuit.callPTNoReport();
   // myCircuit.compareTimingEngines();
 
@@ -882,6 +893,7 @@ myCircuit.updateTiming();
 
   myCircuit.updateTiming();
   myCircuit.printTiming("Final Solution");
+  printRCTreeReports(myCircuit);
   // myCircuit.callPTNoReport();
   // myCircuit.compareTimingEngines();
 
@@ -938,6 +950,7 @@ myCircuit.powerRecovery(900+numGates/1000.0);
 
   myCircuit.updateTiming();
   myCircuit.printTiming("Final Solution");
+  printRCTreeReports(myCircuit);
   // myCircuit.callPTNoReport();
   return;
 
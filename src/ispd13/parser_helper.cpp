@@ -21,9 +21,15 @@
 
 #include "ispd13/parser_helper.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <cassert>
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
 #include <limits>
 
 bool is_special_char(char c) {
@@ -541,6 +547,356 @@ bool SpefParser::read_net_data(SpefNet& spefNet) {
   return false;  // a valid net was not read
 }
 
+SpefFastParser::SpefFastParser(string filename)
+    : begin(0), end(0), cursor(0), mappedSize(0), slots(64, -1) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) return;
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void* data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      madvise(data, st.st_size, MADV_SEQUENTIAL);
+      mappedSize = st.st_size;
+      begin = (const char*)data;
+      end = begin + mappedSize;
+      cursor = begin;
+    }
+  }
+
+  close(fd);
+}
+
+SpefFastParser::SpefFastParser(const char* begin, const char* end)
+    : begin(begin), end(end), cursor(begin), mappedSize(0), slots(64, -1) {}
+
+SpefFastParser::~SpefFastParser() {
+  if (mappedSize > 0) munmap((void*)begin, mappedSize);
+}
+
+void SpefFastParser::find_net_sections(const char* from, const char* to,
+                                       vector<const char*>& sections) const {
+  static const char keyword[] = "*D_NET";
+  static const int keywordLength = sizeof(keyword) - 1;
+
+  // First line starting in [from, to).
+  const char* line = from;
+  if (line > begin && line[-1] != '\n') {
+    line = (const char*)std::memchr(line, '\n', end - line);
+    line = line ? line + 1 : end;
+  }
+
+  while (line < to) {
+    const char* lineEnd = (const char*)std::memchr(line, '\n', end - line);
+    if (!lineEnd) lineEnd = end;
+
+    if (lineEnd - line > keywordLength &&
+        std::memcmp(line, keyword, keywordLength) == 0 &&
+        std::isspace(line[keywordLength])) {
+      // Same check as read_net_data(): "*D_NET name cap".
+      int numTokens = 0;
+      const char* name = 0;
+      for (const char* p = line; p < lineEnd;) {
+        if (std::isspace(*p)) {
+          ++p;
+          continue;
+        }
+        if (numTokens == 1) name = p;
+        while (p < lineEnd && !std::isspace(*p)) ++p;
+        ++numTokens;
+      }
+
+      if (numTokens == 3) {
+        sections.push_back(line);
+      } else if (name) {
+        const char* nameEnd = name;
+        while (nameEnd < lineEnd && !std::isspace(*nameEnd)) ++nameEnd;
+        cout << "[BUG] @ SpefFastParser::find_net_sections: possibly "
+                "wrong-named net starting with '"
+             << string(name, nameEnd - name) << "'\n";
+      }
+    }
+
+    line = lineEnd + 1;
+  }
+}
+
+// Split the next non-empty line in blank separated tokens. Return the number
+// of tokens, or 0 at the end of the file. Tokens after MAX_TOKENS are counted
+// but not stored.
+int SpefFastParser::read_line() {
+  while (cursor < end) {
+    int numTokens = 0;
+    while (cursor < end && *cursor != '\n') {
+      if (std::isspace(*cursor)) {
+        ++cursor;
+        continue;
+      }
+
+      const char* start = cursor;
+      while (cursor < end && !std::isspace(*cursor)) ++cursor;
+
+      if (numTokens < MAX_TOKENS)
+        tokens[numTokens] = SpefToken(start, cursor - start);
+      ++numTokens;
+    }
+
+    if (cursor < end) ++cursor;  // skip '\n'
+    if (numTokens > 0) return numTokens;
+  }
+
+  return 0;
+}
+
+// Return the id of the node, or -1 if it did not appear yet in the current
+// net. In the latter case, slot is set to where the node should be inserted.
+int SpefFastParser::find(const SpefFlatNet& spefNet, const SpefToken& name,
+                         unsigned int& slot) const {
+  // FNV-1a
+  unsigned int hash = 2166136261u;
+  for (int i = 0; i < name.len; ++i) {
+    hash ^= (unsigned char)name.str[i];
+    hash *= 16777619u;
+  }
+
+  const unsigned int mask = slots.size() - 1;
+  for (slot = hash & mask;; slot = (slot + 1) & mask) {
+    const int id = slots[slot];
+    if (id == -1) return -1;
+
+    const SpefToken& other = spefNet.nodeNames[id];
+    if (other.len == name.len &&
+        std::memcmp(other.str, name.str, name.len) == 0)
+      return id;
+  }
+}
+
+// Return the id of the node, creating it if this is its first appearance in
+// the current net.
+int SpefFastParser::intern(SpefFlatNet& spefNet, const SpefToken& name) {
+  unsigned int slot;
+  const int id = find(spefNet, name, slot);
+  if (id != -1) return id;
+
+  const int newId = spefNet.nodeNames.size();
+  spefNet.nodeNames.push_back(name);
+  slots[slot] = newId;
+  usedSlots.push_back(slot);
+
+  // Keep the load factor below 1/2.
+  if (2 * usedSlots.size() > slots.size()) {
+    slots.assign(2 * slots.size(), -1);
+    usedSlots.clear();
+    const int numNodes = spefNet.nodeNames.size();
+    for (int k = 0; k < numNodes; ++k) {
+      find(spefNet, spefNet.nodeNames[k], slot);
+      slots[slot] = k;
+      usedSlots.push_back(slot);
+    }
+  }
+
+  return newId;
+}
+
+void SpefFastParser::clear_table() {
+  const int numUsedSlots = usedSlots.size();
+  for (int i = 0; i < numUsedSlots; ++i) slots[usedSlots[i]] = -1;
+  usedSlots.clear();
+}
+
+double SpefFastParser::to_double(const SpefToken& token) const {
+  // strtod stops at the blank after the token, except at the end of the file.
+  if (token.str + token.len < end) return std::strtod(token.str, 0);
+  return std::atof(string(token).c_str());
+}
+
+// Read the spef data for the next net.
+// Return value indicates if the last read was successful or not.
+bool SpefFastParser::read_net_data(SpefFlatNet& spefNet) {
+  spefNet.clear();
+  clear_table();
+
+  // Read until a D_NET line is found
+  int numTokens;
+  while ((numTokens = read_line()) > 0) {
+    if (tokens[0] == "*D_NET") {
+      if (numTokens == 3) break;
+      cout << "[BUG] @ SpefFastParser::read_net_data: possibly wrong-named "
+              "net starting with '"
+           << string(tokens[1]) << "'\n";
+    }
+  }
+
+  if (numTokens == 0) return false;  // a valid net was not read
+
+  spefNet.netName = tokens[1];
+  spefNet.netLumpedCap = to_double(tokens[2]);
+
+  // Skip the lines that are not "*CONN". Nets without connections (e.g.
+  // clock nets) end here.
+  while ((numTokens = read_line()) > 0 && !(tokens[0] == "*CONN")) {
+    if (tokens[0] == "*END") return true;
+  }
+
+  assert(numTokens > 0);  // end of file not expected here
+
+  // Line format: "*nodeType nodeName direction"
+  // Node ids are resolved after reading the other sections.
+  connectionNames.clear();
+  while ((numTokens = read_line()) > 0 && !(tokens[0] == "*CAP")) {
+    assert(numTokens == 3);
+    assert(tokens[0].len == 2 && tokens[2].len == 1);
+
+    spefNet.connectionTypes.push_back(tokens[0].str[1]);
+    spefNet.connectionDirections.push_back(tokens[2].str[0]);
+    connectionNames.push_back(tokens[1]);
+  }
+
+  // Line format: "index nodeName cap"
+  while ((numTokens = read_line()) > 0 && !(tokens[0] == "*RES")) {
+    assert(numTokens == 3);
+
+    spefNet.capacitanceNodes.push_back(intern(spefNet, tokens[1]));
+    spefNet.capacitances.push_back(to_double(tokens[2]));
+    assert(spefNet.capacitances.back() >= 0);
+  }
+
+  // Line format: "index fromNodeName toNodeName res"
+  while ((numTokens = read_line()) > 0 && !(tokens[0] == "*END")) {
+    assert(numTokens == 4);
+
+    spefNet.resistanceNodes0.push_back(intern(spefNet, tokens[1]));
+    spefNet.resistanceNodes1.push_back(intern(spefNet, tokens[2]));
+    spefNet.resistances.push_back(to_double(tokens[3]));
+    assert(spefNet.resistances.back() >= 0);
+  }
+
+  // Resolve connections without creating new nodes.
+  unsigned int slot;
+  const int numConnections = connectionNames.size();
+  for (int i = 0; i < numConnections; ++i)
+    spefNet.connectionNodes.push_back(
+        find(spefNet, connectionNames[i], slot));
+
+  return true;
+}
+
+VerilogFastParser::VerilogFastParser(string filename)
+    : begin(0), end(0), cursor(0), mappedSize(0) {
+  for (int c = 0; c < 256; ++c)
+    separators[c] = std::isspace(c) || is_special_char(c);
+
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) return;
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void* data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      madvise(data, st.st_size, MADV_SEQUENTIAL);
+      mappedSize = st.st_size;
+      begin = (const char*)data;
+      end = begin + mappedSize;
+      cursor = begin;
+    }
+  }
+
+  close(fd);
+}
+
+VerilogFastParser::~VerilogFastParser() {
+  if (mappedSize > 0) munmap((void*)begin, mappedSize);
+}
+
+// Split the next non-empty line in tokens separated by blanks or special
+// characters, as read_line_as_tokens() does. Return the number of tokens,
+// or 0 at the end of the file.
+int VerilogFastParser::read_line() {
+  tokens.clear();
+  while (cursor < end) {
+    while (cursor < end && *cursor != '\n') {
+      if (separators[(unsigned char)*cursor]) {
+        ++cursor;
+        continue;
+      }
+
+      const char* start = cursor;
+      while (cursor < end && !separators[(unsigned char)*cursor]) ++cursor;
+      tokens.push_back(SpefToken(start, cursor - start));
+    }
+
+    if (cursor < end) ++cursor;  // skip '\n'
+    if (!tokens.empty()) return tokens.size();
+  }
+
+  return 0;
+}
+
+bool VerilogFastParser::read_netlist(VerilogFlatNetlist& netlist) {
+  netlist.clear();
+  cursor = begin;
+
+  // Read the module definition and skip the port names in it until we
+  // encounter the tokens {"Start", "PIs"}.
+  int numTokens;
+  while ((numTokens = read_line()) > 0)
+    if (numTokens == 2 && tokens[0] == "module") break;
+  if (numTokens == 0) return false;
+  netlist.moduleName = tokens[1];
+
+  while ((numTokens = read_line()) > 0)
+    if (numTokens == 2 && tokens[0] == "Start" && tokens[1] == "PIs") break;
+  if (numTokens == 0) return false;
+
+  // Primary inputs, primary outputs and wires, each list ending with the
+  // header of the next one.
+  static const char* const keywords[] = {"input", "output", "wire"};
+  static const char* const nextSections[] = {"POs", "wires", "cells"};
+  vector<int>* lists[] = {&netlist.primaryInputs, &netlist.primaryOutputs,
+                          &netlist.wires};
+
+  for (int k = 0; k < 3; ++k) {
+    while ((numTokens = read_line()) == 2 && tokens[0] == keywords[k])
+      lists[k]->push_back(
+          netlist.netNames.insert(tokens[1].str, tokens[1].len));
+
+    if (!(numTokens == 2 && tokens[0] == "Start" &&
+          tokens[1] == nextSections[k])) {
+      cout << "[BUG] @ VerilogFastParser::read_netlist: unexpected line in "
+              "the "
+           << keywords[k] << " list\n";
+      return false;
+    }
+  }
+
+  // Cell instances: cell type, instance name and at least one pin-net pair.
+  while ((numTokens = read_line()) >= 4) {
+    netlist.cellTypes.push_back(
+        netlist.cellTypeNames.insert(tokens[0].str, tokens[0].len));
+    netlist.cellInsts.push_back(
+        netlist.instNames.insert(tokens[1].str, tokens[1].len));
+
+    for (int i = 2; i < numTokens - 1; i += 2) {
+      const SpefToken& pin = tokens[i];
+      const SpefToken& net = tokens[i + 1];
+      if (pin.str[0] != '.') {
+        cout << "[BUG] @ VerilogFastParser::read_netlist: pin name of cell '"
+             << string(tokens[1]) << "' does not start with '.'\n";
+        return false;
+      }
+
+      // skip the first character of the pin name
+      netlist.cellPins.push_back(
+          netlist.pinNames.insert(pin.str + 1, pin.len - 1));
+      netlist.cellPinNets.push_back(netlist.netNames.insert(net.str, net.len));
+    }
+
+    netlist.cellPinPointers.push_back(netlist.cellPins.size());
+  }
+
+  return numTokens == 1 && tokens[0] == "endmodule";
+}
+
 // Read timing info for the next pin or port
 // Return value indicates if the last read was successful or not.
 // If the line read corresponds to a pin, then name1 and name2 will be set to
@@ -682,6 +1038,8 @@ void LibParser::_begin_read_lut(LibParserLUT& lut) {
       lut.tableVals[i][j] = std::atof(tokens[j].c_str());
     }
   }
+
+  lut.flat.build(lut.loadIndices, lut.transitionIndices, lut.tableVals);
 }
 
 void LibParser::_begin_read_timing_info(string toPin,
@@ -726,6 +1084,9 @@ void LibParser::_begin_read_timing_info(string toPin,
       assert(tokens[1] == "timing");
       finishedReading = true;
 
+      timing.flat.build(timing.riseDelay.flat, timing.fallDelay.flat,
+                        timing.riseTransition.flat, timing.fallTransition.flat);
+
     } else if (tokens[0] == "timing_type") {
       // ignore data
 
@@ -848,6 +1209,18 @@ void LibParser::_begin_read_cell_info(string cellName,
       assert(tokens[2] == cellName);
       finishedReading = true;
 
+      // Resolve arc pin names once so that they can be compared as integers.
+      const int numArcs = cell.timingArcs.size();
+      const int numPins = cell.pins.size();
+      for (int i = 0; i < numArcs; i++) {
+        LibParserTimingInfo& timing = cell.timingArcs[i];
+        for (int k = 0; k < numPins; k++) {
+          if (cell.pins[k].name == timing.fromPin) timing.fromPinIndex = k;
+          if (cell.pins[k].name == timing.toPin) timing.toPinIndex = k;
+        }  // end for
+        assert(timing.fromPinIndex != -1 && timing.toPinIndex != -1);
+      }  // end for
+
     } else if (tokens[0] == "cell_footprint") {
       // ignore data
 
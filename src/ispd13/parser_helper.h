@@ -28,6 +28,9 @@
 #include <string>
 #include <vector>
 
+#include "ispd13/LUT.h"
+#include "ispd13/NameTable.h"
+
 using std::cout;
 using std::endl;
 using std::istream;
@@ -203,6 +206,186 @@ class SpefParser {
   bool read_net_data(SpefNet& spefNet);
 };
 
+// A string inside the memory-mapped spef file. It is not null terminated.
+struct SpefToken {
+  const char* str;
+  int len;
+
+  SpefToken() : str(0), len(0) {}
+  SpefToken(const char* str, int len) : str(str), len(len) {}
+
+  bool operator==(const char* s) const {
+    for (int i = 0; i < len; ++i)
+      if (s[i] != str[i]) return false;  // also stops at the end of s
+    return s[len] == '\0';
+  }
+
+  operator string() const { return string(str, len); }
+};
+
+// Net data read by SpefFastParser. Nodes are identified by integer ids,
+// assigned in order of first appearance in the *CAP and then in the *RES
+// sections, which is the same order RCTreeDescriptor assigns its node
+// indices in. Connections whose node does not appear in these sections have
+// node id -1.
+struct SpefFlatNet {
+  string netName;
+  double netLumpedCap;
+
+  vector<SpefToken> nodeNames;  // indexed by node id
+
+  vector<int> connectionNodes;
+  vector<char> connectionTypes;       // either 'P' (port) or 'I' (internal)
+  vector<char> connectionDirections;  // either 'I' (receiver) or 'O' (driver)
+
+  vector<int> capacitanceNodes;
+  vector<double> capacitances;
+
+  vector<int> resistanceNodes0;
+  vector<int> resistanceNodes1;
+  vector<double> resistances;
+
+  void clear() {
+    netName = "";
+    netLumpedCap = 0.0;
+    nodeNames.clear();
+    connectionNodes.clear();
+    connectionTypes.clear();
+    connectionDirections.clear();
+    capacitanceNodes.clear();
+    capacitances.clear();
+    resistanceNodes0.clear();
+    resistanceNodes1.clear();
+    resistances.clear();
+  }
+};
+
+// Same as SpefParser, but the file is memory mapped and tokens are not
+// copied. Node names are interned in a per-net hash table and must be in
+// the "n1:n2" form without blanks around the colon, as in the ISPD-13
+// benchmarks.
+class SpefFastParser {
+  const char* begin;
+  const char* end;
+  const char* cursor;
+  size_t mappedSize;
+
+  // Open addressing table of node ids keyed by node name. Only the slots
+  // used by the current net are cleared before reading the next one.
+  vector<int> slots;
+  vector<int> usedSlots;
+
+  vector<SpefToken> connectionNames;
+
+  static const int MAX_TOKENS = 8;
+  SpefToken tokens[MAX_TOKENS];
+
+  int read_line();
+  int find(const SpefFlatNet& spefNet, const SpefToken& name,
+           unsigned int& slot) const;
+  int intern(SpefFlatNet& spefNet, const SpefToken& name);
+  void clear_table();
+  double to_double(const SpefToken& token) const;
+
+ public:
+  SpefFastParser(string filename);
+
+  // Parser over [begin, end) of a file mapped by another parser, e.g. a net
+  // section found by find_net_sections(). The file must stay mapped.
+  SpefFastParser(const char* begin, const char* end);
+
+  ~SpefFastParser();
+
+  bool is_open() const { return begin != 0; }
+
+  // Continue reading at the given position, e.g. a net section.
+  void seek(const char* position) { cursor = position; }
+
+  const char* data_begin() const { return begin; }
+  const char* data_end() const { return end; }
+
+  // Append the start of each well-formed "*D_NET" line starting in
+  // [from, to) to sections. Sections of consecutive ranges can be simply
+  // concatenated, so a file can be scanned in parallel.
+  void find_net_sections(const char* from, const char* to,
+                         vector<const char*>& sections) const;
+
+  // Read the spef data for the next net.
+  // Return value indicates if the last read was successful or not.
+  bool read_net_data(SpefFlatNet& spefNet);
+};
+
+// Netlist read by VerilogFastParser. Nets, pins, cell types and instances
+// are interned and referred to by their ids in the name tables. The pins of
+// cell i are stored in [cellPinPointers[i], cellPinPointers[i + 1]) of
+// cellPins (pin name ids) and cellPinNets (net ids).
+struct VerilogFlatNetlist {
+  string moduleName;
+
+  NameTable netNames;
+  NameTable pinNames;
+  NameTable cellTypeNames;
+  NameTable instNames;
+
+  vector<int> primaryInputs;   // net ids
+  vector<int> primaryOutputs;  // net ids
+  vector<int> wires;           // net ids
+
+  vector<int> cellTypes;      // cell type id of each cell
+  vector<int> cellInsts;      // instance name id of each cell
+  vector<int> cellPinPointers;
+  vector<int> cellPins;
+  vector<int> cellPinNets;
+
+  VerilogFlatNetlist() : cellPinPointers(1, 0) {}
+
+  int getNumCells() const { return cellTypes.size(); }
+
+  void clear() {
+    moduleName = "";
+    netNames.clear();
+    pinNames.clear();
+    cellTypeNames.clear();
+    instNames.clear();
+    primaryInputs.clear();
+    primaryOutputs.clear();
+    wires.clear();
+    cellTypes.clear();
+    cellInsts.clear();
+    cellPinPointers.assign(1, 0);
+    cellPins.clear();
+    cellPinNets.clear();
+  }
+};
+
+// Same format as VerilogParser, but the file is memory mapped and the whole
+// netlist is read in a single pass into a VerilogFlatNetlist. Names are
+// copied only the first time they are seen.
+class VerilogFastParser {
+  const char* begin;
+  const char* end;
+  const char* cursor;
+  size_t mappedSize;
+
+  // Tokens of the last line read (same token type as the spef reader).
+  vector<SpefToken> tokens;
+
+  // Whether a character separates tokens (blanks and special characters).
+  bool separators[256];
+
+  int read_line();
+
+ public:
+  VerilogFastParser(string filename);
+  ~VerilogFastParser();
+
+  bool is_open() const { return begin != 0; }
+
+  // Read the whole netlist.
+  // Return value indicates if the read was successful or not.
+  bool read_netlist(VerilogFlatNetlist& netlist);
+};
+
 /////////////////////////////////////////////////////////////////////
 //
 // This class can be used to parse the specific .timing
@@ -278,6 +461,9 @@ struct LibParserLUT {
   vector<double> loadIndices;
   vector<double> transitionIndices;
   vector<vector<double> > tableVals;
+
+  // Same table flattened for fast evaluation (see lookup() in global.h).
+  FlatLUT flat;
 };
 
 ostream& operator<<(ostream& os, LibParserLUT& lut);
@@ -294,6 +480,15 @@ struct LibParserTimingInfo {
   LibParserLUT riseDelay;
   LibParserLUT fallTransition;
   LibParserLUT riseTransition;
+
+  // All four tables interleaved to be evaluated in a single call.
+  FlatTimingArcLUT flat;
+
+  // Indexes of fromPin and toPin in the pins of the cell.
+  int fromPinIndex;
+  int toPinIndex;
+
+  LibParserTimingInfo() : fromPinIndex(-1), toPinIndex(-1) {}
 };
 
 ostream& operator<<(ostream& os, LibParserTimingInfo& timing);